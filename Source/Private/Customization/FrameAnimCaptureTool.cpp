@@ -85,6 +85,9 @@ void UFrameAnimCaptureTool::Activate()
 
 void UFrameAnimCaptureTool::Deactivate()
 {
+	// Ends a pending CaptureFrame continuation.
+	BeginFrameCounter = -1;
+	CurrentFrameIndex = -1;
 	if (CaptureActor) {
 		CaptureActor->K2_DestroyActor();
 	}
@@ -129,45 +132,54 @@ void UFrameAnimCaptureTool::Tick(const float InDeltaTime)
 				CurrentScreenBounds.Max.Y = FMath::Max(CurrentScreenBounds.Max.Y, ScreenPos.Y);
 			}
 		}
-		if (BeginFrameCounter != -1) {
-			int TargetFrame = (GFrameCounterRenderThread - BeginFrameCounter) / FrameStep;
-			if(CurrentFrameIndex != TargetFrame)
-				return;
-			if (CurrentFrameIndex < FrameCount && CaptureActor) {
-				USceneCaptureComponent2D* SceneCaptureComp = CaptureActor->GetCaptureComponent2D();
-				SceneCaptureComp->CaptureScene();
-				FIntPoint BlockOffset;
-				BlockOffset.X = CurrentBlockTextureSize.X * (CurrentFrameIndex % CurrentBlockCellSize.X);
-				BlockOffset.Y = CurrentBlockTextureSize.Y * (CurrentFrameIndex / CurrentBlockCellSize.X);
-				if (bPaddingToPowerOfTwo) {
-					BlockOffset.X += (CurrentBlockTextureSize.X - CurrentScreenBoundsSize.X) / 2;
-					BlockOffset.Y += (CurrentBlockTextureSize.Y - CurrentScreenBoundsSize.Y) / 2;
-				}
-				TArray<FColor> FullColors;
-				ETextureRenderTargetFormat RenderTargetFormat = CaptureRT->RenderTargetFormat;
-				FTextureRenderTargetResource* RenderTargetResource = CaptureRT->GameThread_GetRenderTargetResource();
-				FReadSurfaceDataFlags ReadPixelFlags(RCM_MinMax);
-				FIntRect IntRegion(CurrentScreenBounds.Min.IntPoint().ComponentMax(FIntPoint(0, 0)), CurrentScreenBounds.Max.IntPoint().ComponentMin(FIntPoint(CaptureRT->SizeX, CaptureRT->SizeY)));
-				RenderTargetResource->ReadPixels(FullColors, ReadPixelFlags, IntRegion);
-				for (int i = 0; i < IntRegion.Width(); i++) {
-					for (int j = 0; j < IntRegion.Height(); j++) {
-						FColor SampleColor = FullColors[j * IntRegion.Width() + i];
-						SampleColor.A = 255 - SampleColor.A;
-						FrameTextureData[(BlockOffset.Y + j) * CurrentFrameTextureSize.X + (BlockOffset.X + i)] = SampleColor;
-					}
-				}
-				CurrentFrameIndex++;
-			}
-			else {
-				FCreateTexture2DParameters Params;
-				Params.CompressionSettings = TC_Default;
-				Params.bUseAlpha = true;
-				FrameTexture = FImageUtils::CreateTexture2D(CurrentFrameTextureSize.X, CurrentFrameTextureSize.Y, FrameTextureData, GetTransientPackage(), "FrameAnimTexture", EObjectFlags::RF_NoFlags, Params);
-				BeginFrameCounter = -1;
-				CurrentFrameIndex = -1;
+	}
+}
+
+bool UFrameAnimCaptureTool::CaptureFrame()
+{
+	if (BeginFrameCounter == -1)
+		return true;
+	if (SourceActors.IsEmpty())
+		return false;
+	// Frames skipped to keep the tick budget are caught up with the next one that runs.
+	int TargetFrame = (GFrameCounterRenderThread - BeginFrameCounter) / FrameStep;
+	if (CurrentFrameIndex > TargetFrame)
+		return false;
+	if (CurrentFrameIndex < FrameCount && CaptureActor) {
+		USceneCaptureComponent2D* SceneCaptureComp = CaptureActor->GetCaptureComponent2D();
+		SceneCaptureComp->CaptureScene();
+		FIntPoint BlockOffset;
+		BlockOffset.X = CurrentBlockTextureSize.X * (CurrentFrameIndex % CurrentBlockCellSize.X);
+		BlockOffset.Y = CurrentBlockTextureSize.Y * (CurrentFrameIndex / CurrentBlockCellSize.X);
+		if (bPaddingToPowerOfTwo) {
+			BlockOffset.X += (CurrentBlockTextureSize.X - CurrentScreenBoundsSize.X) / 2;
+			BlockOffset.Y += (CurrentBlockTextureSize.Y - CurrentScreenBoundsSize.Y) / 2;
+		}
+		TArray<FColor> FullColors;
+		ETextureRenderTargetFormat RenderTargetFormat = CaptureRT->RenderTargetFormat;
+		FTextureRenderTargetResource* RenderTargetResource = CaptureRT->GameThread_GetRenderTargetResource();
+		FReadSurfaceDataFlags ReadPixelFlags(RCM_MinMax);
+		FIntRect IntRegion(CurrentScreenBounds.Min.IntPoint().ComponentMax(FIntPoint(0, 0)), CurrentScreenBounds.Max.IntPoint().ComponentMin(FIntPoint(CaptureRT->SizeX, CaptureRT->SizeY)));
+		RenderTargetResource->ReadPixels(FullColors, ReadPixelFlags, IntRegion);
+		for (int i = 0; i < IntRegion.Width(); i++) {
+			for (int j = 0; j < IntRegion.Height(); j++) {
+				FColor SampleColor = FullColors[j * IntRegion.Width() + i];
+				SampleColor.A = 255 - SampleColor.A;
+				FrameTextureData[(BlockOffset.Y + j) * CurrentFrameTextureSize.X + (BlockOffset.X + i)] = SampleColor;
 			}
 		}
+		CurrentFrameIndex++;
 	}
+	else {
+		FCreateTexture2DParameters Params;
+		Params.CompressionSettings = TC_Default;
+		Params.bUseAlpha = true;
+		FrameTexture = FImageUtils::CreateTexture2D(CurrentFrameTextureSize.X, CurrentFrameTextureSize.Y, FrameTextureData, GetTransientPackage(), "FrameAnimTexture", EObjectFlags::RF_NoFlags, Params);
+		BeginFrameCounter = -1;
+		CurrentFrameIndex = -1;
+		return true;
+	}
+	return false;
 }
 
 void UFrameAnimCaptureTool::Capture()
@@ -188,8 +200,15 @@ void UFrameAnimCaptureTool::Capture()
 	}
 	FrameTextureData.Reset();
 	FrameTextureData.SetNumZeroed(CurrentFrameTextureSize.X * CurrentFrameTextureSize.Y);
+	const bool bCapturing = BeginFrameCounter != -1;
 	BeginFrameCounter = GFrameCounterRenderThread;
 	CurrentFrameIndex = 0;
+	// The readback flushes rendering every frame, it runs on the tick budget as a continuation.
+	if (!bCapturing) {
+		AddContinuation([WeakThis = TWeakObjectPtr<UFrameAnimCaptureTool>(this)]() {
+			return !WeakThis.IsValid() || WeakThis->CaptureFrame();
+		});
+	}
 }
 
 void UFrameAnimCaptureTool::CreateAsset()
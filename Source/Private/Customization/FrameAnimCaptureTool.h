@@ -19,6 +19,9 @@ private:
 	UFUNCTION(CallInEditor)
 	void Capture();
 
+	/** Continuation reading back the frames of a capture, true once the texture is created. */
+	bool CaptureFrame();
+
 	UFUNCTION(CallInEditor)
 	void CreateAsset();
 
@@ -0,0 +1,675 @@
+#include "HLODBuildCache.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SplineMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture2D.h"
+#include "HAL/FileManager.h"
+#include "ImageCore.h"
+#include "IO/IoHash.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "MeshDescription.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/CustomVersion.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/MetaData.h"
+#include "WorldPartition/HLOD/HLODBuilder.h"
+
+namespace
+{
+	constexpr uint32 BuildCacheMagic = 0x484C4243;
+	// Bump whenever the cached entries or the key change meaning.
+	constexpr int32 BuildCacheVersion = 6;
+	// Sources moved by less than this hash the same, nudging an actor keeps its cell cached.
+	constexpr double LocationTolerance = 0.1;
+	constexpr double RotationTolerance = 0.01;
+	constexpr double ScaleTolerance = 0.001;
+
+	/** References to generated assets are their names in the entry, anything else is an object path. */
+	struct FCachedTexture
+	{
+		FString Name;
+		int32 SizeX = 0;
+		int32 SizeY = 0;
+		int32 NumSlices = 0;
+		uint8 Format = 0;
+		uint8 GammaSpace = 0;
+		TArray64<uint8> RawData;
+		uint8 CompressionSettings = 0;
+		bool bSRGB = false;
+		uint8 LODGroup = 0;
+		uint8 Filter = 0;
+		uint8 MipGenSettings = 0;
+		uint8 AddressX = 0;
+		uint8 AddressY = 0;
+		bool bNeverStream = false;
+		int32 LODBias = 0;
+		int32 MaxTextureSize = 0;
+		bool bFlipGreenChannel = false;
+		bool bCompressionNoAlpha = false;
+		bool bVirtualTextureStreaming = false;
+
+		friend FArchive& operator<<(FArchive& Ar, FCachedTexture& Texture)
+		{
+			return Ar << Texture.Name << Texture.SizeX << Texture.SizeY << Texture.NumSlices << Texture.Format << Texture.GammaSpace << Texture.RawData
+				<< Texture.CompressionSettings << Texture.bSRGB << Texture.LODGroup << Texture.Filter << Texture.MipGenSettings
+				<< Texture.AddressX << Texture.AddressY << Texture.bNeverStream << Texture.LODBias << Texture.MaxTextureSize
+				<< Texture.bFlipGreenChannel << Texture.bCompressionNoAlpha << Texture.bVirtualTextureStreaming;
+		}
+	};
+
+	struct FCachedMaterial
+	{
+		FString Name;
+		FString Parent;
+		TArray<TPair<FName, float>> Scalars;
+		TArray<TPair<FName, FLinearColor>> Vectors;
+		TArray<TPair<FName, FString>> Textures;
+		TArray<TPair<FName, bool>> StaticSwitches;
+		FMaterialInstanceBasePropertyOverrides BasePropertyOverrides;
+
+		friend FArchive& operator<<(FArchive& Ar, FCachedMaterial& Material)
+		{
+			Ar << Material.Name << Material.Parent << Material.Scalars << Material.Vectors << Material.Textures << Material.StaticSwitches;
+			FMaterialInstanceBasePropertyOverrides::StaticStruct()->SerializeBin(Ar, &Material.BasePropertyOverrides);
+			return Ar;
+		}
+	};
+
+	struct FCachedMesh
+	{
+		FString Name;
+		FMeshDescription MeshDescription;
+		FMeshBuildSettings BuildSettings;
+		FMeshNaniteSettings NaniteSettings;
+		int32 LightMapResolution = 0;
+		int32 LightMapCoordinateIndex = 0;
+		TArray<TPair<FName, FString>> Materials;
+
+		friend FArchive& operator<<(FArchive& Ar, FCachedMesh& Mesh)
+		{
+			Ar << Mesh.Name << Mesh.MeshDescription;
+			FMeshBuildSettings::StaticStruct()->SerializeBin(Ar, &Mesh.BuildSettings);
+			FMeshNaniteSettings::StaticStruct()->SerializeBin(Ar, &Mesh.NaniteSettings);
+			return Ar << Mesh.LightMapResolution << Mesh.LightMapCoordinateIndex << Mesh.Materials;
+		}
+	};
+
+	struct FCachedComponent
+	{
+		FString Class;
+		FString Name;
+		FTransform Transform;
+		uint8 Mobility = 0;
+		FString StaticMesh;
+		TArray<FString> OverrideMaterials;
+		int32 ForcedLodModel = 0;
+		bool bForceDisableNanite = false;
+		/** Local space, only set on instanced components. */
+		TArray<FTransform> Instances;
+
+		friend FArchive& operator<<(FArchive& Ar, FCachedComponent& Component)
+		{
+			return Ar << Component.Class << Component.Name << Component.Transform << Component.Mobility << Component.StaticMesh << Component.OverrideMaterials
+				<< Component.ForcedLodModel << Component.bForceDisableNanite << Component.Instances;
+		}
+	};
+
+	/** Ordered so that every generated asset comes before the ones referencing it. */
+	struct FCacheEntry
+	{
+		TArray<FCachedTexture> Textures;
+		TArray<FCachedMaterial> Materials;
+		TArray<FCachedMesh> Meshes;
+		TArray<FCachedComponent> Components;
+		/** What the builder logged when it built the entry. */
+		FString Report;
+
+		friend FArchive& operator<<(FArchive& Ar, FCacheEntry& Entry)
+		{
+			return Ar << Entry.Textures << Entry.Materials << Entry.Meshes << Entry.Components << Entry.Report;
+		}
+	};
+
+	/** Collects the generated assets reachable from the built components. */
+	class FCacheEntryWriter
+	{
+	public:
+		FCacheEntryWriter(FCacheEntry& InEntry, UObject* InAssetsOuter)
+			: Entry(InEntry)
+			, AssetsPackage(InAssetsOuter->GetPackage())
+		{
+		}
+
+		FString AddTexture(UTexture* InTexture)
+		{
+			if (InTexture == nullptr || !IsGenerated(InTexture))
+				return GetPathNameSafe(InTexture);
+			if (const FString* Name = Names.Find(InTexture))
+				return *Name;
+			UTexture2D* Texture = Cast<UTexture2D>(InTexture);
+			FImage Image;
+			if (Texture == nullptr || HasSourceAdjustments(Texture) || !Texture->Source.GetMipImage(Image, 0, 0, 0)) {
+				bSupported = false;
+				return FString();
+			}
+			FCachedTexture& Cached = Entry.Textures.AddDefaulted_GetRef();
+			Cached.Name = Texture->GetName();
+			Cached.SizeX = Image.SizeX;
+			Cached.SizeY = Image.SizeY;
+			Cached.NumSlices = Image.NumSlices;
+			Cached.Format = (uint8)Image.Format;
+			Cached.GammaSpace = (uint8)Image.GammaSpace;
+			Cached.RawData = MoveTemp(Image.RawData);
+			Cached.CompressionSettings = Texture->CompressionSettings;
+			Cached.bSRGB = Texture->SRGB;
+			Cached.LODGroup = Texture->LODGroup;
+			Cached.Filter = Texture->Filter;
+			Cached.MipGenSettings = Texture->MipGenSettings;
+			Cached.AddressX = Texture->AddressX;
+			Cached.AddressY = Texture->AddressY;
+			Cached.bNeverStream = Texture->NeverStream;
+			Cached.LODBias = Texture->LODBias;
+			Cached.MaxTextureSize = Texture->MaxTextureSize;
+			Cached.bFlipGreenChannel = Texture->bFlipGreenChannel;
+			Cached.bCompressionNoAlpha = Texture->CompressionNoAlpha;
+			Cached.bVirtualTextureStreaming = Texture->VirtualTextureStreaming;
+			return Names.Add(Texture, Cached.Name);
+		}
+
+		FString AddMaterial(UMaterialInterface* InMaterial)
+		{
+			if (InMaterial == nullptr || !IsGenerated(InMaterial))
+				return GetPathNameSafe(InMaterial);
+			if (const FString* Name = Names.Find(InMaterial))
+				return *Name;
+			UMaterialInstanceConstant* MaterialInstance = Cast<UMaterialInstanceConstant>(InMaterial);
+			// Only the parameters stored below round-trip.
+			if (MaterialInstance == nullptr || !MaterialInstance->FontParameterValues.IsEmpty() || !MaterialInstance->RuntimeVirtualTextureParameterValues.IsEmpty()) {
+				bSupported = false;
+				return FString();
+			}
+			FCachedMaterial Cached;
+			Cached.Name = MaterialInstance->GetName();
+			Cached.Parent = AddMaterial(MaterialInstance->Parent);
+			for (const FScalarParameterValue& Value : MaterialInstance->ScalarParameterValues) {
+				Cached.Scalars.Add({ Value.ParameterInfo.Name, Value.ParameterValue });
+			}
+			for (const FVectorParameterValue& Value : MaterialInstance->VectorParameterValues) {
+				Cached.Vectors.Add({ Value.ParameterInfo.Name, Value.ParameterValue });
+			}
+			for (const FTextureParameterValue& Value : MaterialInstance->TextureParameterValues) {
+				Cached.Textures.Add({ Value.ParameterInfo.Name, AddTexture(Value.ParameterValue) });
+			}
+			FStaticParameterSet StaticParameters;
+			MaterialInstance->GetStaticParameterValues(StaticParameters);
+			for (const FStaticSwitchParameter& Switch : StaticParameters.StaticSwitchParameters) {
+				if (Switch.bOverride) {
+					Cached.StaticSwitches.Add({ Switch.ParameterInfo.Name, Switch.Value });
+				}
+			}
+			Cached.BasePropertyOverrides = MaterialInstance->BasePropertyOverrides;
+			Names.Add(MaterialInstance, Cached.Name);
+			Entry.Materials.Add(MoveTemp(Cached));
+			return Names.FindChecked(MaterialInstance);
+		}
+
+		FString AddMesh(UStaticMesh* InMesh)
+		{
+			if (InMesh == nullptr || !IsGenerated(InMesh))
+				return GetPathNameSafe(InMesh);
+			if (const FString* Name = Names.Find(InMesh))
+				return *Name;
+			const FMeshDescription* MeshDescription = InMesh->GetNumSourceModels() == 1 ? InMesh->GetMeshDescription(0) : nullptr;
+			if (MeshDescription == nullptr) {
+				bSupported = false;
+				return FString();
+			}
+			FCachedMesh Cached;
+			Cached.Name = InMesh->GetName();
+			Cached.MeshDescription = *MeshDescription;
+			Cached.BuildSettings = InMesh->GetSourceModel(0).BuildSettings;
+			Cached.NaniteSettings = InMesh->NaniteSettings;
+			Cached.LightMapResolution = InMesh->GetLightMapResolution();
+			Cached.LightMapCoordinateIndex = InMesh->GetLightMapCoordinateIndex();
+			for (const FStaticMaterial& Material : InMesh->GetStaticMaterials()) {
+				Cached.Materials.Add({ Material.MaterialSlotName, AddMaterial(Material.MaterialInterface) });
+			}
+			Names.Add(InMesh, Cached.Name);
+			Entry.Meshes.Add(MoveTemp(Cached));
+			return Names.FindChecked(InMesh);
+		}
+
+		bool AddComponent(UActorComponent* InComponent)
+		{
+			UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(InComponent);
+			if (MeshComponent == nullptr)
+				return false;
+			FCachedComponent Cached;
+			Cached.Class = MeshComponent->GetClass()->GetPathName();
+			Cached.Name = MeshComponent->GetName();
+			Cached.Transform = MeshComponent->GetRelativeTransform();
+			Cached.Mobility = MeshComponent->Mobility;
+			Cached.StaticMesh = AddMesh(MeshComponent->GetStaticMesh());
+			for (UMaterialInterface* Material : MeshComponent->OverrideMaterials) {
+				Cached.OverrideMaterials.Add(AddMaterial(Material));
+			}
+			Cached.ForcedLodModel = MeshComponent->ForcedLodModel;
+			Cached.bForceDisableNanite = MeshComponent->bForceDisableNanite;
+			if (const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(MeshComponent)) {
+				Cached.Instances.SetNum(InstancedComponent->GetInstanceCount());
+				for (int32 Index = 0; Index < Cached.Instances.Num(); Index++) {
+					InstancedComponent->GetInstanceTransform(Index, Cached.Instances[Index], false);
+				}
+			}
+			Entry.Components.Add(MoveTemp(Cached));
+			return bSupported;
+		}
+	private:
+		/** Source adjustments are not stored, a texture using any of them is not cached. */
+		static bool HasSourceAdjustments(const UTexture* InTexture)
+		{
+			const UTexture* Default = GetDefault<UTexture2D>();
+			return InTexture->AdjustBrightness != Default->AdjustBrightness || InTexture->AdjustBrightnessCurve != Default->AdjustBrightnessCurve
+				|| InTexture->AdjustVibrance != Default->AdjustVibrance || InTexture->AdjustSaturation != Default->AdjustSaturation
+				|| InTexture->AdjustRGBCurve != Default->AdjustRGBCurve || InTexture->AdjustHue != Default->AdjustHue
+				|| InTexture->AdjustMinAlpha != Default->AdjustMinAlpha || InTexture->AdjustMaxAlpha != Default->AdjustMaxAlpha
+				|| InTexture->bChromaKeyTexture || InTexture->CompositeTexture != nullptr;
+		}
+
+		bool IsGenerated(const UObject* InObject) const
+		{
+			return InObject->GetPackage() == AssetsPackage || InObject->GetPackage() == GetTransientPackage();
+		}
+
+		FCacheEntry& Entry;
+		const UPackage* AssetsPackage;
+		TMap<const UObject*, FString> Names;
+		bool bSupported = true;
+	};
+
+	FString GetBuildCacheFilename(const FSHAHash& InKey)
+	{
+		return FPaths::ProjectSavedDir() / TEXT("ProceduralContentProcessor/HLODBuildCache") / InKey.ToString() + TEXT(".bin");
+	}
+
+	void UpdateTransform(FSHA1& InOutSha, const FTransform& InTransform)
+	{
+		const FVector Location = InTransform.GetLocation();
+		const FRotator Rotation = InTransform.Rotator().GetNormalized();
+		const FVector Scale = InTransform.GetScale3D();
+		const int64 Values[] = {
+			FMath::RoundToInt64(Location.X / LocationTolerance), FMath::RoundToInt64(Location.Y / LocationTolerance), FMath::RoundToInt64(Location.Z / LocationTolerance),
+			FMath::RoundToInt64(Rotation.Pitch / RotationTolerance), FMath::RoundToInt64(Rotation.Yaw / RotationTolerance), FMath::RoundToInt64(Rotation.Roll / RotationTolerance),
+			FMath::RoundToInt64(Scale.X / ScaleTolerance), FMath::RoundToInt64(Scale.Y / ScaleTolerance), FMath::RoundToInt64(Scale.Z / ScaleTolerance),
+		};
+		InOutSha.Update((const uint8*)Values, sizeof(Values));
+	}
+
+	void UpdateString(FSHA1& InOutSha, const FString& InString)
+	{
+		InOutSha.UpdateWithString(*InString, InString.Len());
+	}
+
+	void UpdateStruct(FSHA1& InOutSha, UScriptStruct* InStruct, const void* InValue)
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		InStruct->SerializeBin(Writer, const_cast<void*>(InValue));
+		InOutSha.Update(Bytes.GetData(), Bytes.Num());
+	}
+
+	bool HasOverrideVertexColors(const UStaticMeshComponent* InComponent)
+	{
+		return InComponent->LODData.ContainsByPredicate([](const FStaticMeshComponentLODInfo& InLODInfo) {
+			return InLODInfo.OverrideVertexColors && InLODInfo.OverrideVertexColors->GetNumVertices() > 0;
+		});
+	}
+}
+
+TOptional<FSHAHash> FHLODBuildCache::ComputeKey(const UObject* InBuilder, const UHLODBuilderSettings* InSettings, const FHLODBuildContext& InContext, TConstArrayView<UActorComponent*> InSourceComponents)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	TSet<FName> Packages;
+	TArray<FName> PendingPackages;
+	auto AddPackage = [&Packages, &PendingPackages](FName InPackage) {
+		bool bIsAlreadyInSet = false;
+		Packages.Add(InPackage, &bIsAlreadyInSet);
+		if (!bIsAlreadyInSet) {
+			PendingPackages.Add(InPackage);
+		}
+	};
+
+	// Every component hashes on its own, the key does not depend on the order the sources come in.
+	TArray<FSHAHash> ComponentKeys;
+	for (UActorComponent* Component : InSourceComponents) {
+		const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component);
+		if (MeshComponent == nullptr || MeshComponent->GetStaticMesh() == nullptr)
+			continue;
+		// Painted vertex colors have no package to hash, such sources always build.
+		if (HasOverrideVertexColors(MeshComponent))
+			return {};
+		FSHA1 Sha;
+		UpdateString(Sha, MeshComponent->GetClass()->GetPathName());
+		UpdateString(Sha, MeshComponent->GetStaticMesh()->GetPathName());
+		AddPackage(MeshComponent->GetStaticMesh()->GetPackage()->GetFName());
+		for (int32 Index = 0; Index < MeshComponent->GetNumMaterials(); Index++) {
+			const UMaterialInterface* Material = MeshComponent->GetMaterial(Index);
+			UpdateString(Sha, GetPathNameSafe(Material));
+			if (Material) {
+				AddPackage(Material->GetPackage()->GetFName());
+			}
+		}
+		// Tags decide which components stay instanced, on the component, its actor or the mesh asset.
+		if (const TMap<FName, FString>* MeshMetaData = UMetaData::GetMapForObject(MeshComponent->GetStaticMesh())) {
+			TArray<FName> Keys;
+			MeshMetaData->GetKeys(Keys);
+			Keys.Sort(FNameLexicalLess());
+			for (FName Key : Keys) {
+				UpdateString(Sha, Key.ToString());
+				UpdateString(Sha, MeshMetaData->FindChecked(Key));
+			}
+		}
+		for (FName Tag : MeshComponent->ComponentTags) {
+			UpdateString(Sha, Tag.ToString());
+		}
+		if (const AActor* Owner = MeshComponent->GetOwner()) {
+			for (FName Tag : Owner->Tags) {
+				UpdateString(Sha, Tag.ToString());
+			}
+		}
+		if (const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(MeshComponent)) {
+			FTransform Transform;
+			for (int32 Index = 0; Index < InstancedComponent->GetInstanceCount(); Index++) {
+				InstancedComponent->GetInstanceTransform(Index, Transform, true);
+				UpdateTransform(Sha, Transform);
+			}
+			Sha.Update((const uint8*)&InstancedComponent->NumCustomDataFloats, sizeof(InstancedComponent->NumCustomDataFloats));
+			Sha.Update((const uint8*)InstancedComponent->PerInstanceSMCustomData.GetData(), InstancedComponent->PerInstanceSMCustomData.Num() * sizeof(float));
+		}
+		else {
+			UpdateTransform(Sha, MeshComponent->GetComponentTransform());
+		}
+		if (const USplineMeshComponent* SplineMeshComponent = Cast<USplineMeshComponent>(MeshComponent)) {
+			UpdateStruct(Sha, FSplineMeshParams::StaticStruct(), &SplineMeshComponent->SplineParams);
+			const uint8 ForwardAxis = SplineMeshComponent->ForwardAxis;
+			Sha.Update(&ForwardAxis, sizeof(ForwardAxis));
+			const FVector SplineUpDir = SplineMeshComponent->SplineUpDir;
+			Sha.Update((const uint8*)&SplineUpDir, sizeof(SplineUpDir));
+			Sha.Update((const uint8*)&SplineMeshComponent->SplineBoundaryMin, sizeof(SplineMeshComponent->SplineBoundaryMin));
+			Sha.Update((const uint8*)&SplineMeshComponent->SplineBoundaryMax, sizeof(SplineMeshComponent->SplineBoundaryMax));
+		}
+		Sha.Final();
+		Sha.GetHash(ComponentKeys.AddDefaulted_GetRef().Hash);
+	}
+	ComponentKeys.Sort([](const FSHAHash& Lhs, const FSHAHash& Rhs) {
+		return FMemory::Memcmp(Lhs.Hash, Rhs.Hash, sizeof(Lhs.Hash)) < 0;
+	});
+
+	// Meshes and materials also change through what they reference, e.g. a parent material or a texture.
+	while (!PendingPackages.IsEmpty()) {
+		TArray<FName> Dependencies;
+		AssetRegistry.GetDependencies(PendingPackages.Pop(), Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+		for (FName Dependency : Dependencies) {
+			if (!FPackageName::IsScriptPackage(Dependency.ToString())) {
+				AddPackage(Dependency);
+			}
+		}
+	}
+	TArray<FName> SortedPackages = Packages.Array();
+	SortedPackages.Sort(FNameLexicalLess());
+
+	FSHA1 Sha;
+	Sha.Update((const uint8*)&BuildCacheVersion, sizeof(BuildCacheVersion));
+	UpdateString(Sha, FEngineVersion::Current().ToString());
+	UpdateString(Sha, InBuilder->GetClass()->GetPathName());
+	const uint32 SettingsCRC = InSettings ? InSettings->GetCRC() : 0;
+	Sha.Update((const uint8*)&SettingsCRC, sizeof(SettingsCRC));
+	// The builder places its output around the world position and may pick LODs from the visible distance.
+	UpdateTransform(Sha, FTransform(InContext.WorldPosition));
+	const int64 MinVisibleDistance = FMath::RoundToInt64(InContext.MinVisibleDistance / LocationTolerance);
+	Sha.Update((const uint8*)&MinVisibleDistance, sizeof(MinVisibleDistance));
+	for (FName Package : SortedPackages) {
+		// Saved hashes say nothing about unsaved edits.
+		const UPackage* LoadedPackage = FindPackage(nullptr, *Package.ToString());
+		if (LoadedPackage && LoadedPackage->IsDirty())
+			return {};
+		TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(Package);
+		if (!PackageData)
+			return {};
+		UpdateString(Sha, Package.ToString());
+		const FIoHash SavedHash = PackageData->GetPackageSavedHash();
+		Sha.Update(SavedHash.GetBytes(), sizeof(FIoHash::ByteArray));
+	}
+	for (const FSHAHash& ComponentKey : ComponentKeys) {
+		Sha.Update(ComponentKey.Hash, sizeof(ComponentKey.Hash));
+	}
+	Sha.Final();
+	FSHAHash Key;
+	Sha.GetHash(Key.Hash);
+	return Key;
+}
+
+bool FHLODBuildCache::Load(const FSHAHash& InKey, UObject* InAssetsOuter, TArray<UActorComponent*>& OutComponents, FString& OutReport)
+{
+	const FString Filename = GetBuildCacheFilename(InKey);
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename, FILEREAD_Silent));
+	if (!Reader)
+		return false;
+	// Pruning goes by the time stamp, a hit keeps the entry alive.
+	IFileManager::Get().SetTimeStamp(*Filename, FDateTime::UtcNow());
+	uint32 Magic = 0;
+	int32 Version = 0;
+	*Reader << Magic << Version;
+	if (Magic != BuildCacheMagic || Version != BuildCacheVersion)
+		return false;
+	// Mesh descriptions serialize against custom versions, they are stored next to the payload.
+	FCustomVersionContainer CustomVersions;
+	CustomVersions.Serialize(*Reader);
+	TArray<uint8> Payload;
+	*Reader << Payload;
+	if (Reader->IsError())
+		return false;
+	FMemoryReader PayloadReader(Payload, true);
+	PayloadReader.SetCustomVersions(CustomVersions);
+	FCacheEntry Entry;
+	PayloadReader << Entry;
+	if (PayloadReader.IsError())
+		return false;
+
+	TMap<FString, UObject*> Generated;
+	TArray<UObject*> Created;
+	bool bResolved = true;
+	auto Resolve = [&Generated, &bResolved](const FString& InReference) -> UObject* {
+		if (InReference.IsEmpty())
+			return nullptr;
+		UObject* const* GeneratedObject = Generated.Find(InReference);
+		UObject* Object = GeneratedObject ? *GeneratedObject : LoadObject<UObject>(nullptr, *InReference);
+		bResolved &= Object != nullptr;
+		return Object;
+	};
+	auto Create = [InAssetsOuter, &Generated, &Created](UClass* InClass, const FString& InName) {
+		UObject* Object = NewObject<UObject>(InAssetsOuter, InClass, MakeUniqueObjectName(InAssetsOuter, InClass, FName(*InName)));
+		Generated.Add(InName, Object);
+		Created.Add(Object);
+		return Object;
+	};
+
+	for (FCachedTexture& Cached : Entry.Textures) {
+		UTexture2D* Texture = CastChecked<UTexture2D>(Create(UTexture2D::StaticClass(), Cached.Name));
+		FImage Image(Cached.SizeX, Cached.SizeY, Cached.NumSlices, (ERawImageFormat::Type)Cached.Format, (EGammaSpace)Cached.GammaSpace);
+		Image.RawData = MoveTemp(Cached.RawData);
+		Texture->Source.Init(Image);
+		Texture->CompressionSettings = (TextureCompressionSettings)Cached.CompressionSettings;
+		Texture->SRGB = Cached.bSRGB;
+		Texture->LODGroup = (TextureGroup)Cached.LODGroup;
+		Texture->Filter = (TextureFilter)Cached.Filter;
+		Texture->MipGenSettings = (TextureMipGenSettings)Cached.MipGenSettings;
+		Texture->AddressX = (TextureAddress)Cached.AddressX;
+		Texture->AddressY = (TextureAddress)Cached.AddressY;
+		Texture->NeverStream = Cached.bNeverStream;
+		Texture->LODBias = Cached.LODBias;
+		Texture->MaxTextureSize = Cached.MaxTextureSize;
+		Texture->bFlipGreenChannel = Cached.bFlipGreenChannel;
+		Texture->CompressionNoAlpha = Cached.bCompressionNoAlpha;
+		Texture->VirtualTextureStreaming = Cached.bVirtualTextureStreaming;
+		Texture->PostEditChange();
+	}
+	for (const FCachedMaterial& Cached : Entry.Materials) {
+		UMaterialInstanceConstant* MaterialInstance = CastChecked<UMaterialInstanceConstant>(Create(UMaterialInstanceConstant::StaticClass(), Cached.Name));
+		MaterialInstance->SetParentEditorOnly(Cast<UMaterialInterface>(Resolve(Cached.Parent)));
+		for (const auto& Pair : Cached.Scalars) {
+			MaterialInstance->SetScalarParameterValueEditorOnly(FMaterialParameterInfo(Pair.Key), Pair.Value);
+		}
+		for (const auto& Pair : Cached.Vectors) {
+			MaterialInstance->SetVectorParameterValueEditorOnly(FMaterialParameterInfo(Pair.Key), Pair.Value);
+		}
+		for (const auto& Pair : Cached.Textures) {
+			MaterialInstance->SetTextureParameterValueEditorOnly(FMaterialParameterInfo(Pair.Key), Cast<UTexture>(Resolve(Pair.Value)));
+		}
+		// Base property overrides, e.g. two sided or the blend mode, are part of the static permutation.
+		FStaticParameterSet StaticParameters;
+		for (const auto& Pair : Cached.StaticSwitches) {
+			StaticParameters.StaticSwitchParameters.Add(FStaticSwitchParameter(FMaterialParameterInfo(Pair.Key), Pair.Value, true, FGuid()));
+		}
+		FMaterialInstanceBasePropertyOverrides BasePropertyOverrides = Cached.BasePropertyOverrides;
+		MaterialInstance->UpdateStaticPermutation(StaticParameters, BasePropertyOverrides);
+		MaterialInstance->PostEditChange();
+	}
+	for (FCachedMesh& Cached : Entry.Meshes) {
+		UStaticMesh* Mesh = CastChecked<UStaticMesh>(Create(UStaticMesh::StaticClass(), Cached.Name));
+		Mesh->SetNumSourceModels(1);
+		Mesh->GetSourceModel(0).BuildSettings = Cached.BuildSettings;
+		Mesh->NaniteSettings = Cached.NaniteSettings;
+		Mesh->SetLightMapResolution(Cached.LightMapResolution);
+		Mesh->SetLightMapCoordinateIndex(Cached.LightMapCoordinateIndex);
+		for (const auto& Pair : Cached.Materials) {
+			Mesh->GetStaticMaterials().Add(FStaticMaterial(Cast<UMaterialInterface>(Resolve(Pair.Value)), Pair.Key, Pair.Key));
+		}
+		*Mesh->CreateMeshDescription(0) = MoveTemp(Cached.MeshDescription);
+		Mesh->CommitMeshDescription(0);
+		Mesh->Build(true);
+	}
+	for (const FCachedComponent& Cached : Entry.Components) {
+		UClass* ComponentClass = LoadObject<UClass>(nullptr, *Cached.Class);
+		if (ComponentClass == nullptr || !ComponentClass->IsChildOf<UStaticMeshComponent>()) {
+			bResolved = false;
+			break;
+		}
+		UStaticMeshComponent* Component = NewObject<UStaticMeshComponent>(InAssetsOuter, ComponentClass, MakeUniqueObjectName(InAssetsOuter, ComponentClass, FName(*Cached.Name)));
+		Created.Add(Component);
+		Component->Mobility = (EComponentMobility::Type)Cached.Mobility;
+		Component->SetStaticMesh(Cast<UStaticMesh>(Resolve(Cached.StaticMesh)));
+		for (int32 Index = 0; Index < Cached.OverrideMaterials.Num(); Index++) {
+			if (!Cached.OverrideMaterials[Index].IsEmpty()) {
+				Component->SetMaterial(Index, Cast<UMaterialInterface>(Resolve(Cached.OverrideMaterials[Index])));
+			}
+		}
+		Component->SetForcedLodModel(Cached.ForcedLodModel);
+		Component->SetForceDisableNanite(Cached.bForceDisableNanite);
+		Component->SetRelativeTransform(Cached.Transform);
+		if (UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component)) {
+			InstancedComponent->AddInstances(Cached.Instances, false);
+		}
+		OutComponents.Add(Component);
+	}
+
+	// An asset referenced by path is gone, the entry is stale and the cell builds from scratch.
+	if (!bResolved) {
+		for (UObject* Object : Created) {
+			Object->MarkAsGarbage();
+		}
+		OutComponents.Reset();
+		return false;
+	}
+	OutReport = MoveTemp(Entry.Report);
+	return true;
+}
+
+bool FHLODBuildCache::Save(const FSHAHash& InKey, UObject* InAssetsOuter, TConstArrayView<UActorComponent*> InComponents, const FString& InReport)
+{
+	static bool bPruned = false;
+	if (!bPruned) {
+		bPruned = true;
+		Prune();
+	}
+	FCacheEntry Entry;
+	FCacheEntryWriter EntryWriter(Entry, InAssetsOuter);
+	for (UActorComponent* Component : InComponents) {
+		if (!EntryWriter.AddComponent(Component)) {
+			UE_LOG(LogTemp, Log, TEXT("HLOD build cache: %s can not be cached"), *GetPathNameSafe(Component));
+			return false;
+		}
+	}
+	Entry.Report = InReport;
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload, true);
+	PayloadWriter << Entry;
+
+	// Other build processes may read the entry while it is written, it only appears under its name once complete.
+	const FString Filename = GetBuildCacheFilename(InKey);
+	const FString TempFilename = FPaths::SetExtension(Filename, FGuid::NewGuid().ToString() + TEXT(".tmp"));
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFilename));
+		if (!Writer)
+			return false;
+		uint32 Magic = BuildCacheMagic;
+		int32 Version = BuildCacheVersion;
+		*Writer << Magic << Version;
+		FCustomVersionContainer CustomVersions = PayloadWriter.GetCustomVersions();
+		CustomVersions.Serialize(*Writer);
+		*Writer << Payload;
+		if (!Writer->Close()) {
+			Writer.Reset();
+			IFileManager::Get().Delete(*TempFilename, false, false, true);
+			return false;
+		}
+	}
+	if (!IFileManager::Get().Move(*Filename, *TempFilename, true, false, false, true)) {
+		IFileManager::Get().Delete(*TempFilename, false, false, true);
+		return false;
+	}
+	return true;
+}
+
+void FHLODBuildCache::Prune(int32 InMaxAgeDays, int64 InMaxSizeMB)
+{
+	struct FEntryFile
+	{
+		FString Filename;
+		FDateTime LastUsed;
+		int64 Size;
+	};
+	TArray<FEntryFile> Files;
+	int64 TotalSize = 0;
+	const FString Directory = FPaths::GetPath(GetBuildCacheFilename(FSHAHash()));
+	IFileManager::Get().IterateDirectoryStat(*Directory, [&Files, &TotalSize](const TCHAR* InFilename, const FFileStatData& InStatData) {
+		// Temporary files left behind by a crashed build age out like entries.
+		const FString Extension = FPaths::GetExtension(InFilename);
+		if (!InStatData.bIsDirectory && (Extension == TEXT("bin") || Extension == TEXT("tmp"))) {
+			Files.Add({ InFilename, InStatData.ModificationTime, InStatData.FileSize });
+			TotalSize += InStatData.FileSize;
+		}
+		return true;
+	});
+	Files.Sort([](const FEntryFile& Lhs, const FEntryFile& Rhs) {
+		return Lhs.LastUsed < Rhs.LastUsed;
+	});
+	const FDateTime MinLastUsed = FDateTime::UtcNow() - FTimespan::FromDays(InMaxAgeDays);
+	const int64 MaxSize = InMaxSizeMB * 1024 * 1024;
+	int32 NumDeleted = 0;
+	for (const FEntryFile& File : Files) {
+		if (File.LastUsed >= MinLastUsed && TotalSize <= MaxSize)
+			break;
+		if (IFileManager::Get().Delete(*File.Filename, false, false, true)) {
+			TotalSize -= File.Size;
+			NumDeleted++;
+		}
+	}
+	if (NumDeleted > 0) {
+		UE_LOG(LogTemp, Log, TEXT("HLOD build cache: removed %d stale entries, %lld MB left"), NumDeleted, TotalSize / (1024 * 1024));
+	}
+}
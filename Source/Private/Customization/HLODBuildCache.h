@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+
+class UActorComponent;
+class UHLODBuilderSettings;
+struct FHLODBuildContext;
+
+/**
+ * File cache of HLOD builder results under Saved/ProceduralContentProcessor/HLODBuildCache, keyed by a hash of the build inputs.
+ * An entry holds the output components with the meshes, material instances and textures generated for them,
+ * assets outside the HLOD package are referenced by path.
+ * Entries are written to a temporary file and moved into place, concurrent builds never read a partial one.
+ * Entries unused for MaxAgeDays are removed, then the least recently used ones until the directory fits in MaxSizeMB.
+ */
+class FHLODBuildCache
+{
+public:
+	/**
+	 * Hashes the builder class and settings, the build context, the source meshes and materials with the saved hashes of every package they depend on,
+	 * the component and instance transforms quantized to a tolerance, spline mesh parameters and per instance custom data.
+	 * Unset when a source package has unsaved changes or a source component overrides its vertex colors.
+	 */
+	static TOptional<FSHAHash> ComputeKey(const UObject* InBuilder, const UHLODBuilderSettings* InSettings, const FHLODBuildContext& InContext, TConstArrayView<UActorComponent*> InSourceComponents);
+
+	/** Recreates the cached components, their generated assets are created in InAssetsOuter. OutReport is the one passed to Save. */
+	static bool Load(const FSHAHash& InKey, UObject* InAssetsOuter, TArray<UActorComponent*>& OutComponents, FString& OutReport);
+
+	/**
+	 * Only static mesh components can be stored, and only material instances and 2D textures among the generated assets.
+	 * Font or runtime virtual texture parameters and texture source adjustments do not round-trip, such results are not stored.
+	 */
+	static bool Save(const FSHAHash& InKey, UObject* InAssetsOuter, TConstArrayView<UActorComponent*> InComponents, const FString& InReport);
+
+	/** Removes stale entries, Save runs it once per session. */
+	static void Prune(int32 InMaxAgeDays = 30, int64 InMaxSizeMB = 4096);
+};
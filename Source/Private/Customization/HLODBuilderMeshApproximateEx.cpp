@@ -6,8 +6,77 @@
 #include "StaticMeshCompiler.h"
 #include "AssetCompilingManager.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "HLODBuildCache.h"
+#include "Async/ParallelFor.h"
+#include "Serialization/ArchiveCrc32.h"
+#include "UObject/MetaData.h"
+
+uint32 UHLODBuilderMeshApproximateExSettings::GetCRC() const
+{
+	UHLODBuilderMeshApproximateExSettings& This = *const_cast<UHLODBuilderMeshApproximateExSettings*>(this);
+	FArchiveCrc32 Ar;
+	Ar << This.InstancedNameFilters << This.InstancedTags << This.InstancedAssetTag << This.MaxInstancedBoundsRadius << This.MaxInstancedTriangles << This.MinInstanceCount << This.bUseImpostorLOD << This.ImpostorLOD;
+	for (const TSoftObjectPtr<UStaticMesh>& Mesh : InstancedMeshes) {
+		FString MeshPath = Mesh.ToString();
+		Ar << MeshPath;
+	}
+	return HashCombine(Super::GetCRC(), Ar.GetCrc());
+}
+
+bool UHLODBuilderMeshApproximateExSettings::ShouldStayInstanced(const UStaticMeshComponent* InComponent, int32 InInstanceCount) const
+{
+	const UStaticMesh* Mesh = InComponent->GetStaticMesh();
+	const FString MeshName = Mesh->GetName();
+	for (const FString& Filter : InstancedNameFilters) {
+		if (!Filter.IsEmpty() && MeshName.Contains(Filter))
+			return true;
+	}
+	const FSoftObjectPath MeshPath(Mesh);
+	if (InstancedMeshes.ContainsByPredicate([&MeshPath](const TSoftObjectPtr<UStaticMesh>& InMesh) { return InMesh.ToSoftObjectPath() == MeshPath; }))
+		return true;
+	if (!InstancedAssetTag.IsNone()) {
+		const TMap<FName, FString>* MeshMetaData = UMetaData::GetMapForObject(Mesh);
+		if (MeshMetaData && MeshMetaData->Contains(InstancedAssetTag))
+			return true;
+	}
+	const AActor* Owner = InComponent->GetOwner();
+	for (FName Tag : InstancedTags) {
+		if (InComponent->ComponentHasTag(Tag) || (Owner && Owner->ActorHasTag(Tag)))
+			return true;
+	}
+	if (MaxInstancedBoundsRadius <= 0.0f && MaxInstancedTriangles <= 0 && MinInstanceCount <= 0)
+		return false;
+	return (MaxInstancedBoundsRadius <= 0.0f || Mesh->GetBounds().SphereRadius <= MaxInstancedBoundsRadius)
+		&& (MaxInstancedTriangles <= 0 || Mesh->GetNumTriangles(0) <= MaxInstancedTriangles)
+		&& (MinInstanceCount <= 0 || InInstanceCount >= MinInstanceCount);
+}
+
+TSubclassOf<UHLODBuilderSettings> UHLODBuilderMeshApproximateEx::GetSettingsClass() const
+{
+	return UHLODBuilderMeshApproximateExSettings::StaticClass();
+}
 
 TArray<UActorComponent*> UHLODBuilderMeshApproximateEx::Build(const FHLODBuildContext& InHLODBuildContext, const TArray<UActorComponent*>& InSourceComponents) const
+{
+	TOptional<FSHAHash> CacheKey;
+	if (!FParse::Param(FCommandLine::Get(), TEXT("NoHLODBuildCache"))) {
+		CacheKey = FHLODBuildCache::ComputeKey(this, HLODBuilderSettings, InHLODBuildContext, InSourceComponents);
+	}
+	TArray<UActorComponent*> Results;
+	FString Report;
+	if (CacheKey && FHLODBuildCache::Load(CacheKey.GetValue(), InHLODBuildContext.AssetsOuter, Results, Report)) {
+		UE_LOG(LogTemp, Log, TEXT("HLOD %s (build cache hit): %s"), *InHLODBuildContext.AssetsBaseName, *Report);
+		return Results;
+	}
+	Results = BuildUncached(InHLODBuildContext, InSourceComponents, Report);
+	UE_LOG(LogTemp, Log, TEXT("HLOD %s: %s"), *InHLODBuildContext.AssetsBaseName, *Report);
+	if (CacheKey && !Results.IsEmpty()) {
+		FHLODBuildCache::Save(CacheKey.GetValue(), InHLODBuildContext.AssetsOuter, Results, Report);
+	}
+	return Results;
+}
+
+TArray<UActorComponent*> UHLODBuilderMeshApproximateEx::BuildUncached(const FHLODBuildContext& InHLODBuildContext, const TArray<UActorComponent*>& InSourceComponents, FString& OutReport) const
 {
 	const IMeshMergeUtilities& MeshMergeUtilities = FModuleManager::Get().LoadModuleChecked<IMeshMergeModule>("MeshMergeUtilities").GetUtilities();
 
@@ -28,81 +97,145 @@ TArray<UActorComponent*> UHLODBuilderMeshApproximateEx::Build(const FHLODBuildCo
 	MergeSettings.bMergeEquivalentMaterials = true;
 	MergeSettings.bIncludeImposters = false;
 	MergeSettings.bUseTextureBinning = true;
+
+	// Layers saved before the settings class existed still hold the base settings.
+	const UHLODBuilderMeshApproximateExSettings* InstancingSettings = Cast<UHLODBuilderMeshApproximateExSettings>(HLODBuilderSettings);
+	if (InstancingSettings == nullptr) {
+		InstancingSettings = GetDefault<UHLODBuilderMeshApproximateExSettings>();
+	}
 	UWorld* World = InHLODBuildContext.World;
 	UStaticMesh* MergedStaticMesh = nullptr;
-	UStaticMesh* ProxyedStaticMesh = nullptr;
 
-	FVector MergedLocation;
-	TArray<UPrimitiveComponent*> SourceCompList;
-	TArray<UStaticMeshComponent*> TreeCompList;
+	TArray<UStaticMeshComponent*> MeshComponents;
+	TMap<UStaticMesh*, int32> InstanceCounts;
 	for (auto SourceComponent : InSourceComponents) {
-		if (auto StaticMeshComponent = Cast<UStaticMeshComponent>(SourceComponent)) {
-			if (StaticMeshComponent->GetStaticMesh().GetName().Contains("Tree")) {
-				TreeCompList.AddUnique(StaticMeshComponent);
-			}
-			else {
-				SourceCompList.AddUnique(StaticMeshComponent);
-			}
+		auto StaticMeshComponent = Cast<UStaticMeshComponent>(SourceComponent);
+		if (StaticMeshComponent && StaticMeshComponent->GetStaticMesh() && !MeshComponents.Contains(StaticMeshComponent)) {
+			const UInstancedStaticMeshComponent* ISMC = Cast<UInstancedStaticMeshComponent>(StaticMeshComponent);
+			InstanceCounts.FindOrAdd(StaticMeshComponent->GetStaticMesh()) += ISMC ? ISMC->GetInstanceCount() : 1;
+			MeshComponents.Add(StaticMeshComponent);
 		}
 	}
-	TArray<UActorComponent*> Results;
+	TArray<UStaticMesh*> SourceMeshes;
+	InstanceCounts.GetKeys(SourceMeshes);
+	FStaticMeshCompilingManager::Get().FinishCompilation(SourceMeshes);
+
+	struct FInstanceBucket
+	{
+		UStaticMesh* Mesh = nullptr;
+		TArray<const UStaticMeshComponent*> Components;
+		int32 NumInstances = 0;
+		FVector Origin = FVector::ZeroVector;
+		TArray<FTransform> Transforms;
+	};
+	TArray<FInstanceBucket> Buckets;
+	TMap<UStaticMesh*, int32> BucketIndices;
+	TArray<UPrimitiveComponent*> SourceCompList;
+	int64 SourceTriangles = 0;
+	for (UStaticMeshComponent* MeshComp : MeshComponents) {
+		UStaticMesh* Mesh = MeshComp->GetStaticMesh();
+		const UInstancedStaticMeshComponent* ISMC = Cast<UInstancedStaticMeshComponent>(MeshComp);
+		const int32 NumInstances = ISMC ? ISMC->GetInstanceCount() : 1;
+		if (!InstancingSettings->ShouldStayInstanced(MeshComp, InstanceCounts.FindChecked(Mesh))) {
+			SourceCompList.Add(MeshComp);
+			SourceTriangles += (int64)Mesh->GetNumTriangles(0) * NumInstances;
+			continue;
+		}
+		int32* BucketIndex = BucketIndices.Find(Mesh);
+		if (BucketIndex == nullptr) {
+			BucketIndex = &BucketIndices.Add(Mesh, Buckets.Num());
+			Buckets.AddDefaulted_GetRef().Mesh = Mesh;
+		}
+		Buckets[*BucketIndex].Components.Add(MeshComp);
+		Buckets[*BucketIndex].NumInstances += NumInstances;
+	}
 
-	if (!TreeCompList.IsEmpty()) {
-		FBoxSphereBounds Bounds;
-		TMap<UStaticMesh*, TArray<FTransform>> InstancedMap;
-		for (auto MeshComp : TreeCompList) {
-			UStaticMesh* Mesh = MeshComp->GetStaticMesh();
-			auto& InstancedInfo = InstancedMap.FindOrAdd(Mesh);
-			Bounds = MeshComp->Bounds + Bounds;
-			if (auto ISMC = Cast<UInstancedStaticMeshComponent>(MeshComp)) {
+	// Reading the transforms only touches the bucket's own components, the components are created afterwards.
+	ParallelFor(Buckets.Num(), [&Buckets](int32 BucketIndex) {
+		FInstanceBucket& Bucket = Buckets[BucketIndex];
+		Bucket.Transforms.Reserve(Bucket.NumInstances);
+		FBox Bounds(ForceInit);
+		for (const UStaticMeshComponent* MeshComp : Bucket.Components) {
+			if (const UInstancedStaticMeshComponent* ISMC = Cast<UInstancedStaticMeshComponent>(MeshComp)) {
 				FTransform Transform;
-				for (int i = 0; i < ISMC->GetInstanceCount(); i++) {
-					ISMC->GetInstanceTransform(i, Transform, true);
-					InstancedInfo.Add(Transform);
+				for (int32 Index = 0; Index < ISMC->GetInstanceCount(); Index++) {
+					ISMC->GetInstanceTransform(Index, Transform, true);
+					Bucket.Transforms.Add(Transform);
 				}
 			}
 			else {
-				InstancedInfo.Add(MeshComp->K2_GetComponentToWorld());
+				Bucket.Transforms.Add(MeshComp->GetComponentTransform());
 			}
 		}
-		for (const auto& InstancedInfo : InstancedMap) {
-			UInstancedStaticMeshComponent* ISMComponent = NewObject<UInstancedStaticMeshComponent>(InHLODBuildContext.AssetsOuter, UInstancedStaticMeshComponent::StaticClass(), *InstancedInfo.Key->GetName(), RF_Transactional);
-			ISMComponent->Mobility = EComponentMobility::Static;
-			ISMComponent->SetStaticMesh(InstancedInfo.Key);
+		for (const FTransform& Transform : Bucket.Transforms) {
+			Bounds += Transform.GetLocation();
+		}
+		Bucket.Origin = Bounds.IsValid ? Bounds.GetCenter() : FVector::ZeroVector;
+		for (FTransform& Transform : Bucket.Transforms) {
+			Transform.AddToTranslation(-Bucket.Origin);
+		}
+	});
+
+	TArray<UActorComponent*> Results;
+	int64 InstancedTriangles = 0;
+	int32 InstancedDrawCalls = 0;
+	for (FInstanceBucket& Bucket : Buckets) {
+		UInstancedStaticMeshComponent* ISMComponent = NewObject<UInstancedStaticMeshComponent>(InHLODBuildContext.AssetsOuter, UInstancedStaticMeshComponent::StaticClass(),
+			MakeUniqueObjectName(InHLODBuildContext.AssetsOuter, UInstancedStaticMeshComponent::StaticClass(), Bucket.Mesh->GetFName()), RF_Transactional);
+		ISMComponent->Mobility = EComponentMobility::Static;
+		ISMComponent->SetStaticMesh(Bucket.Mesh);
+		int32 LODIndex = 0;
+		if (InstancingSettings->bUseImpostorLOD) {
+			const int32 LastLOD = FMath::Max(Bucket.Mesh->GetNumLODs() - 1, 0);
+			LODIndex = InstancingSettings->ImpostorLOD < 0 ? LastLOD : FMath::Min(InstancingSettings->ImpostorLOD, LastLOD);
 			ISMComponent->SetForceDisableNanite(true);
-			ISMComponent->SetForcedLodModel(8);
-			ISMComponent->SetWorldLocation(Bounds.Origin);
-			for (auto InstanceTransform : InstancedInfo.Value) {
-				ISMComponent->AddInstance(InstanceTransform, true);
-			}
-			Results.Add(ISMComponent);
+			ISMComponent->SetForcedLodModel(LODIndex + 1);
 		}
+		ISMComponent->SetWorldLocation(Bucket.Origin);
+		ISMComponent->AddInstances(Bucket.Transforms, false);
+		InstancedTriangles += (int64)Bucket.Mesh->GetNumTriangles(LODIndex) * Bucket.Transforms.Num();
+		InstancedDrawCalls += Bucket.Mesh->GetNumSections(LODIndex);
+		Results.Add(ISMComponent);
 	}
 
-	TArray<UObject*> AssetsToSync;
-	MeshMergeUtilities.MergeComponentsToStaticMesh(SourceCompList, nullptr, MergeSettings, nullptr, GetTransientPackage(), "MergedStaticMesh", AssetsToSync, MergedLocation, TNumericLimits<float>::Max(), true);
-	for (auto Asset : AssetsToSync) {
-		if (auto StaticMesh = Cast<UStaticMesh>(Asset)) {
-			MergedStaticMesh = StaticMesh;
-		}
-		else if (auto Texture = Cast<UTexture2D>(Asset)) {
-			Texture->Filter = TF_Nearest;
-			Texture->MipGenSettings =  TMGS_NoMipmaps;
-			Texture->UpdateResource();
-			Texture->PostEditChange();
-			Texture->MarkPackageDirty();
+	int64 MergedTriangles = 0;
+	int32 MergedDrawCalls = 0;
+	if (!SourceCompList.IsEmpty()) {
+		FVector MergedLocation;
+		TArray<UObject*> AssetsToSync;
+		MeshMergeUtilities.MergeComponentsToStaticMesh(SourceCompList, nullptr, MergeSettings, nullptr, GetTransientPackage(), "MergedStaticMesh", AssetsToSync, MergedLocation, TNumericLimits<float>::Max(), true);
+		for (auto Asset : AssetsToSync) {
+			if (auto StaticMesh = Cast<UStaticMesh>(Asset)) {
+				MergedStaticMesh = StaticMesh;
+			}
+			else if (auto Texture = Cast<UTexture2D>(Asset)) {
+				Texture->Filter = TF_Nearest;
+				Texture->MipGenSettings =  TMGS_NoMipmaps;
+				Texture->UpdateResource();
+				Texture->PostEditChange();
+				Texture->MarkPackageDirty();
 
+			}
+		}
+		if (MergedStaticMesh) {
+			AStaticMeshActor* StatcMeshActor = World->SpawnActor<AStaticMeshActor>(MergedLocation, FRotator());
+			StatcMeshActor->SetFlags(RF_Transient);
+			UStaticMeshComponent* StaticMeshComp = StatcMeshActor->GetStaticMeshComponent();
+			StaticMeshComp->SetFlags(RF_Transient);
+			StaticMeshComp->SetStaticMesh(MergedStaticMesh);
+			for (UActorComponent* Component : Super::Build(InHLODBuildContext, { StaticMeshComp })) {
+				const UStaticMeshComponent* ApproximatedComp = Cast<UStaticMeshComponent>(Component);
+				if (ApproximatedComp && ApproximatedComp->GetStaticMesh()) {
+					UStaticMesh* ApproximatedMesh = ApproximatedComp->GetStaticMesh();
+					FStaticMeshCompilingManager::Get().FinishCompilation({ ApproximatedMesh });
+					MergedTriangles += ApproximatedMesh->GetNumTriangles(0);
+					MergedDrawCalls += ApproximatedMesh->GetNumSections(0);
+				}
+				Results.Add(Component);
+			}
 		}
 	}
-	if (MergedStaticMesh) {
-		AStaticMeshActor* StatcMeshActor = World->SpawnActor<AStaticMeshActor>(MergedLocation, FRotator());
-		StatcMeshActor->SetFlags(RF_Transient);
-		UStaticMeshComponent* StaticMeshComp = StatcMeshActor->GetStaticMeshComponent();
-		StaticMeshComp->SetFlags(RF_Transient);
-		StaticMeshComp->SetStaticMesh(MergedStaticMesh);
-		Results.Append(Super::Build(InHLODBuildContext, { StaticMeshComp }));
-		return Results;
-	}
-	return {};
+	OutReport = FString::Printf(TEXT("merged %d components, %lld source triangles to %lld triangles and %d draw calls, instanced %d meshes, %lld triangles and %d draw calls"),
+		SourceCompList.Num(), SourceTriangles, MergedTriangles, MergedDrawCalls, Buckets.Num(), InstancedTriangles, InstancedDrawCalls);
+	return Results;
 }
-
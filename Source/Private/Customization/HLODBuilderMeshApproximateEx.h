@@ -3,11 +3,62 @@
 #include "WorldPartition/HLOD/Builders/HLODBuilderMeshApproximate.h"
 #include "HLODBuilderMeshApproximateEx.generated.h"
 
+/** Components that stay instanced instead of being merged: any listed, named or tagged one or whose mesh asset is tagged, otherwise those passing every enabled limit. */
+UCLASS()
+class UHLODBuilderMeshApproximateExSettings : public UHLODBuilderMeshApproximateSettings
+{
+	GENERATED_BODY()
+public:
+	virtual uint32 GetCRC() const override;
+
+	bool ShouldStayInstanced(const UStaticMeshComponent* InComponent, int32 InInstanceCount) const;
+
+	/** Meshes whose name contains any of these. */
+	UPROPERTY(EditAnywhere, Category = "Instancing")
+	TArray<FString> InstancedNameFilters = { TEXT("Tree") };
+
+	UPROPERTY(EditAnywhere, Category = "Instancing")
+	TArray<TSoftObjectPtr<UStaticMesh>> InstancedMeshes;
+
+	/** Tags on the source component or its actor. */
+	UPROPERTY(EditAnywhere, Category = "Instancing")
+	TArray<FName> InstancedTags;
+
+	/** Meshes carrying this package metadata key, set once on the asset instead of on every placed component. */
+	UPROPERTY(EditAnywhere, Category = "Instancing")
+	FName InstancedAssetTag = TEXT("HLODInstanced");
+
+	/** Upper limit of the mesh bounds radius, 0 disables the limit. */
+	UPROPERTY(EditAnywhere, Category = "Instancing", meta = (ClampMin = 0, Units = "cm"))
+	float MaxInstancedBoundsRadius = 0.0f;
+
+	/** Upper limit of the LOD0 triangles, 0 disables the limit. */
+	UPROPERTY(EditAnywhere, Category = "Instancing", meta = (ClampMin = 0))
+	int32 MaxInstancedTriangles = 0;
+
+	/** Lower limit of the instances of the mesh among the sources, 0 disables the limit. */
+	UPROPERTY(EditAnywhere, Category = "Instancing", meta = (ClampMin = 0))
+	int32 MinInstanceCount = 0;
+
+	/** Forces a LOD on the instanced meshes, usually their impostor, Nanite is disabled for them. */
+	UPROPERTY(EditAnywhere, Category = "Instancing")
+	bool bUseImpostorLOD = true;
+
+	/** -1 is the last LOD of every mesh. */
+	UPROPERTY(EditAnywhere, Category = "Instancing", meta = (EditCondition = "bUseImpostorLOD", ClampMin = -1))
+	int32 ImpostorLOD = -1;
+};
+
 UCLASS()
 class UHLODBuilderMeshApproximateEx : public UHLODBuilderMeshApproximate
 {
 	GENERATED_BODY()
 public:
+	/** Unchanged sources are restored from FHLODBuildCache, -NoHLODBuildCache always builds. */
 	virtual TArray<UActorComponent*> Build(const FHLODBuildContext& InHLODBuildContext, const TArray<UActorComponent*>& InSourceComponents) const override;
+	virtual TSubclassOf<UHLODBuilderSettings> GetSettingsClass() const override;
+protected:
+	/** OutReport sums up what was merged and what stayed instanced. */
+	TArray<UActorComponent*> BuildUncached(const FHLODBuildContext& InHLODBuildContext, const TArray<UActorComponent*>& InSourceComponents, FString& OutReport) const;
 
 };
@@ -1,5 +1,14 @@
 ﻿#include "HLODPreviewTool.h"
-#include "Widgets/SCanvas.h"
+#include "SHLODCellCanvas.h"
+#include "SHLODBudgetGraph.h"
+#include "HLODStreamingSimulator.h"
+#include "HLODStatsExport.h"
+#include "Components/SplineComponent.h"
+#include "Misc/FileHelper.h"
+#include "Engine/Texture2D.h"
+#include "Engine/TextureLODSettings.h"
+#include "DeviceProfiles/DeviceProfile.h"
+#include "DeviceProfiles/DeviceProfileManager.h"
 #include "Widgets/Input/SSlider.h"
 #include "Widgets/Input/STextComboBox.h"
 #include "WorldPartition/ActorDescContainer.h"
@@ -11,13 +20,52 @@
 #include "WorldPartition/WorldPartitionStreamingDescriptor.h"
 #include "WorldPartition/WorldPartitionRuntimeHash.h"
 #include "../../../../../../../Source/Runtime/Engine/Classes/Components/InstancedStaticMeshComponent.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "ActorPartition/PartitionActor.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/SCS_Node.h"
+#include "Engine/SimpleConstructionScript.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "K2Node_FunctionEntry.h"
+#include "EdGraphNode_Comment.h"
+#include "Engine/Blueprint.h"
+#include "Engine/Texture.h"
+#include "Materials/MaterialFunctionInterface.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Misc/SecureHash.h"
+#include "HAL/FileManager.h"
+#include "IO/IoHash.h"
+#include "Async/ParallelFor.h"
+#include "Algo/BinarySearch.h"
+#include "Widgets/Layout/SSplitter.h"
+#include "PropertyEditorModule.h"
+#include "IDetailsView.h"
 
 #define LOCTEXT_NAMESPACE "ProceduralContentProcessor"
 
+enum class EHLODCellHeatmap : uint8
+{
+	None,
+	Triangles,
+	DrawCalls,
+	TextureMemory,
+	IncrementalTextureMemory,
+	ActorCount,
+	HLODTriangleRatio,
+	ScreenSizeAtLoadingRange,
+};
+
 class SHLODOutliner : public SCompoundWidget
 {
 public:
-	SLATE_BEGIN_ARGS(SHLODOutliner) {}
+	DECLARE_DELEGATE_OneParam(FOnStatsCellClicked, const FWorldPartitionCellStats&);
+
+	SLATE_BEGIN_ARGS(SHLODOutliner)
+		: _HotCellCount(20)
+		{}
+		SLATE_ARGUMENT(TSharedPtr<FWorldPartitionStats>, Stats)
+		SLATE_ARGUMENT(int32, HotCellCount)
+		SLATE_EVENT(FOnStatsCellClicked, OnStatsCellClicked)
 	SLATE_END_ARGS()
 public:
 	void Construct(const FArguments& InArgs);
@@ -33,16 +81,30 @@ public:
 		TArray<FActorDescInfo> HLods;
 		FBox LevelBound;
 	};
+	struct FHotCell {
+		const FWorldPartitionCellStats* Cell;
+		double Value;
+	};
 private:
 	void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
-	int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
 	TSharedRef<SWidget> OnGetBlockMenu(TSharedPtr<FWorldPartitionActorDesc> InActorDesc);
-	FVector2D OnGetBlockPosition(TSharedPtr<FWorldPartitionActorDesc> InActorDesc, FBox InLevelBound);
 	bool GetObserverView(FVector& Location, FRotator& Rotation) const;
 	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FWorldPartitionActorDesc> InInfo, const TSharedRef<STableViewBase>& OwnerTable);
-	FVector2D OnGetBlockSize(TSharedPtr<FWorldPartitionActorDesc> InActorDesc, FBox InLevelBound);
+	FHLODLevelInfo* GetCurrentLevelInfo();
+	void UpdateCanvas();
+	void OnCellClicked(int32 InIndex);
+	TSharedPtr<SWidget> OnGetCellMenu(int32 InIndex);
 	void OnGridNameChanged(TSharedPtr<FString> Selection, ESelectInfo::Type SelectInfo);
 	void OnHLodNameChanged(TSharedPtr<FString> Selection, ESelectInfo::Type SelectInfo);
+	void OnHeatmapChanged(TSharedPtr<FString> Selection, ESelectInfo::Type SelectInfo);
+
+	const FWorldPartitionGridStats* GetCurrentGridStats() const;
+	void UpdateHeatmap();
+	void UpdateHeatmapLevelRange();
+	double GetHeatmapValue(const FWorldPartitionCellStats& InCell) const;
+	FString FormatHeatmapValue(double InValue) const;
+	TSharedRef<ITableRow> OnGenerateHotCellRow(TSharedPtr<FHotCell> InHotCell, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnHotCellSelected(TSharedPtr<FHotCell> InHotCell, ESelectInfo::Type SelectInfo);
 
 	FReply OnBlockClicked(FActorDescInfo& Info);
 
@@ -58,12 +120,30 @@ protected:
 	TArray<TSharedPtr<FString>> mHLODNames;
 	TSharedPtr<STextComboBox> mHLODNameComboBox;
 	TSharedPtr<SSlider> mLevelSilder;
-	TSharedPtr<SCanvas> mCanvas;
+	TSharedPtr<SHLODCellCanvas> mCellCanvas;
 	bool bNeedUpdateCanvas = false;
+
+	TSharedPtr<FWorldPartitionStats> mStats;
+	int32 mHotCellCount = 20;
+	FOnStatsCellClicked mOnStatsCellClicked;
+	EHLODCellHeatmap mHeatmap = EHLODCellHeatmap::None;
+	TArray<TSharedPtr<FString>> mHeatmapNames;
+	TSharedPtr<STextComboBox> mHeatmapComboBox;
+	FText mHeatmapLegend;
+	/** Canvas cell index to the cell statistics it was built from. */
+	TArray<const FWorldPartitionCellStats*> mHeatmapCells;
+	TArray<TSharedPtr<FHotCell>> mHotCells;
+	TSharedPtr<SListView<TSharedPtr<FHotCell>>> mHotCellListView;
 };
 
 void SHLODOutliner::Construct(const FArguments& InArgs)
 {
+	mStats = InArgs._Stats;
+	mHotCellCount = InArgs._HotCellCount;
+	mOnStatsCellClicked = InArgs._OnStatsCellClicked;
+	for (const TCHAR* HeatmapName : { TEXT("None"), TEXT("Triangles"), TEXT("Draw Calls"), TEXT("Texture Memory"), TEXT("Incremental Texture Memory"), TEXT("Actor Count"), TEXT("HLOD / Source Triangles"), TEXT("Screen Size at Loading Range") }) {
+		mHeatmapNames.Add(MakeShared<FString>(HeatmapName));
+	}
 	ChildSlot
 		[
 			SNew(SVerticalBox)
@@ -119,13 +199,69 @@ void SHLODOutliner::Construct(const FArguments& InArgs)
 				]
 				+ SVerticalBox::Slot()
 				.HAlign(HAlign_Fill)
+				.VAlign(VAlign_Top)
+				.Padding(5, 0, 5, 5)
+				.AutoHeight()
+				[
+					SNew(SHorizontalBox)
+						+ SHorizontalBox::Slot()
+						.AutoWidth()
+						.VAlign(VAlign_Center)
+						[
+							SNew(STextBlock)
+								.Text(FText::FromString(TEXT("Heatmap:")))
+						]
+						+ SHorizontalBox::Slot()[
+							SAssignNew(mHeatmapComboBox, STextComboBox)
+								.OptionsSource(&mHeatmapNames)
+								.InitiallySelectedItem(mHeatmapNames[0])
+								.OnSelectionChanged(this, &SHLODOutliner::OnHeatmapChanged)
+						]
+						+ SHorizontalBox::Slot()
+						.FillWidth(2.0f)
+						.Padding(10, 0, 0, 0)
+						.VAlign(VAlign_Center)
+						[
+							SNew(STextBlock)
+								.Text_Lambda([this]() { return mHeatmapLegend; })
+						]
+				]
+				+ SVerticalBox::Slot()
+				.HAlign(HAlign_Fill)
 				.VAlign(VAlign_Fill)
 				[
-					SNew(SBorder)
-						.HAlign(HAlign_Fill)
-						.VAlign(VAlign_Fill)
+					SNew(SSplitter)
+						+ SSplitter::Slot()
+						.Value(0.75f)
+						[
+							SNew(SBorder)
+								.HAlign(HAlign_Fill)
+								.VAlign(VAlign_Fill)
+								[
+									SAssignNew(mCellCanvas, SHLODCellCanvas)
+										.OnCellClicked(this, &SHLODOutliner::OnCellClicked)
+										.OnGetCellMenu(this, &SHLODOutliner::OnGetCellMenu)
+										.OnGetObserverView(this, &SHLODOutliner::GetObserverView)
+								]
+						]
+						+ SSplitter::Slot()
+						.Value(0.25f)
 						[
-							SAssignNew(mCanvas, SCanvas)
+							SAssignNew(mHotCellListView, SListView<TSharedPtr<FHotCell>>)
+								.Visibility_Lambda([this]() { return mHeatmap == EHLODCellHeatmap::None ? EVisibility::Collapsed : EVisibility::Visible; })
+								.ListItemsSource(&mHotCells)
+								.SelectionMode(ESelectionMode::Single)
+								.OnGenerateRow(this, &SHLODOutliner::OnGenerateHotCellRow)
+								.OnSelectionChanged(this, &SHLODOutliner::OnHotCellSelected)
+								.HeaderRow(
+									SNew(SHeaderRow)
+									+ SHeaderRow::Column("Cell")
+									.DefaultLabel(LOCTEXT("HotCells", "Hot Cells"))
+									.FillWidth(0.7f)
+									+ SHeaderRow::Column("Value")
+									.DefaultLabel(LOCTEXT("HotCellValue", "Value"))
+									.FillWidth(0.3f)
+								)
 						]
 				]
 		];
@@ -134,6 +270,7 @@ void SHLODOutliner::Construct(const FArguments& InArgs)
 void SHLODOutliner::SetWorld(UWorld* InWorld)
 {
 	mLevelActorDescInfoMap.Empty();
+	mGridNames.Empty();
 	if (InWorld == nullptr || InWorld->GetWorldPartition() == nullptr)
 		return;
 
@@ -145,6 +282,10 @@ void SHLODOutliner::SetWorld(UWorld* InWorld)
 		for (UE::Private::WorldPartition::FStreamingDescriptor::FStreamingCell& Cell : Grid.StreamingCells){
 		}
 	}
+	mGridNameComboBox->RefreshOptions();
+	if (!mGridNames.IsEmpty()) {
+		mGridNameComboBox->SetSelectedItem(mGridNames[0]);
+	}
 
 	//UWorldPartition* WorldPartition = InWorld->GetWorldPartition();
 	//WorldPartition->ForEachActorDescContainerInstance([&](UActorDescContainerInstance* ActorDescContainerInstance) {
@@ -221,92 +362,243 @@ bool SHLODOutliner::GetObserverView(FVector& Location, FRotator& Rotation) const
 void SHLODOutliner::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
 {
 	if (bNeedUpdateCanvas) {
-		mCanvas->ClearChildren();
-		TSharedPtr<FString> CurrentGridName = mGridNameComboBox->GetSelectedItem();
-		TSharedPtr<FString> CurrentHLodName = mHLODNameComboBox->GetSelectedItem();
-		int CurrentLevelIndex = mLevelSilder->GetValue();
-		if (CurrentGridName && CurrentHLodName) {
-			auto& LevelInfo = mLevelActorDescInfoMap[*CurrentGridName][*CurrentHLodName][CurrentLevelIndex];
-			for (FActorDescInfo& ActorDescInfo : LevelInfo.HLods) {
-				FText CellName = FText::FromString(FString::Printf(TEXT("%3d,%3d"), ActorDescInfo.CellX, ActorDescInfo.CellY));
-				mCanvas->AddSlot()
-					.Position(TAttribute<FVector2D>::Create(TAttribute<FVector2D>::FGetter::CreateSP(this, &SHLODOutliner::OnGetBlockPosition, ActorDescInfo.ActorDesc, LevelInfo.LevelBound)))
-					.Size(TAttribute<FVector2D>::Create(TAttribute<FVector2D>::FGetter::CreateSP(this, &SHLODOutliner::OnGetBlockSize, ActorDescInfo.ActorDesc, LevelInfo.LevelBound)))
-					[
-						SNew(SButton)
-							.VAlign(VAlign_Center)
-							.HAlign(HAlign_Center)
-							.Text(CellName)
-							.ToolTipText(CellName)
-							.ButtonColorAndOpacity_Lambda([&ActorDescInfo]() { return ActorDescInfo.bIsPreview ? FLinearColor(0, 1, 0, 1) : FLinearColor(0, 0, 0, 1); })
-							.ButtonStyle(FAppStyle::Get(), "Button")
-							//.ButtonStyle(FAppStyle::Get(), "FlatButton.Success")
-							.OnClicked_Lambda([this, &ActorDescInfo]() {
-							return OnBlockClicked(ActorDescInfo);
-								})
-					];
-			}
-		}
+		UpdateCanvas();
 		bNeedUpdateCanvas = false;
 	}
 }
 
-int32 SHLODOutliner::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+SHLODOutliner::FHLODLevelInfo* SHLODOutliner::GetCurrentLevelInfo()
 {
-	int NewLayerId = SCompoundWidget::OnPaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
 	TSharedPtr<FString> CurrentGridName = mGridNameComboBox->GetSelectedItem();
 	TSharedPtr<FString> CurrentHLodName = mHLODNameComboBox->GetSelectedItem();
-	int CurrentLevelIndex = mLevelSilder->GetValue();
-	if (CurrentGridName && CurrentHLodName) {
-		auto& LevelInfo = mLevelActorDescInfoMap[*CurrentGridName][*CurrentHLodName][CurrentLevelIndex];
-		const FVector2D ShadowSize(2, 2);
-		const FSlateBrush* CameraImage = FAppStyle::GetBrush(TEXT("WorldPartition.SimulationViewPosition"));
-		FVector ObserverPosition;
-		FRotator ObserverRotation;
-		if (GetObserverView(ObserverPosition, ObserverRotation))
-		{
-			FBox LevelBound = LevelInfo.LevelBound;
-			FVector2D Position(
-				(ObserverPosition.X - LevelBound.Min.X) / (LevelBound.Max.X - LevelBound.Min.X),
-				(ObserverPosition.Y - LevelBound.Min.Y) / (LevelBound.Max.Y - LevelBound.Min.Y)
-			);
-			const FVector2D LocalLocation = Position * mCanvas->GetPersistentState().AllottedGeometry.Size;
-			const FPaintGeometry PaintGeometryShadow = AllottedGeometry.ToPaintGeometry(
-				CameraImage->ImageSize + ShadowSize,
-				FSlateLayoutTransform(LocalLocation - (CameraImage->ImageSize + ShadowSize) * 0.5f)
-			);
-
-			FSlateDrawElement::MakeRotatedBox(
-				OutDrawElements,
-				++NewLayerId,
-				PaintGeometryShadow,
-				CameraImage,
-				ESlateDrawEffect::None,
-				FMath::DegreesToRadians(ObserverRotation.Yaw),
-				(CameraImage->ImageSize + ShadowSize) * 0.5f,
-				FSlateDrawElement::RelativeToElement,
-				FLinearColor::Black
-			);
-
-			const FPaintGeometry PaintGeometry = AllottedGeometry.ToPaintGeometry(
-				CameraImage->ImageSize,
-				FSlateLayoutTransform(LocalLocation - CameraImage->ImageSize * 0.5f)
-			);
-
-			FSlateDrawElement::MakeRotatedBox(
-				OutDrawElements,
-				++NewLayerId,
-				PaintGeometry,
-				CameraImage,
-				ESlateDrawEffect::None,
-				FMath::DegreesToRadians(ObserverRotation.Yaw),
-				CameraImage->ImageSize * 0.5f,
-				FSlateDrawElement::RelativeToElement,
-				FLinearColor::White
-			);
-		}
-	}
-	return NewLayerId;
+	if (!CurrentGridName || !CurrentHLodName)
+		return nullptr;
+	TMap<FString, TMap<int, FHLODLevelInfo>>* GridInfo = mLevelActorDescInfoMap.Find(*CurrentGridName);
+	TMap<int, FHLODLevelInfo>* HLODInfo = GridInfo ? GridInfo->Find(*CurrentHLodName) : nullptr;
+	return HLODInfo ? HLODInfo->Find(mLevelSilder->GetValue()) : nullptr;
+}
+
+void SHLODOutliner::UpdateCanvas()
+{
+	if (mHeatmap != EHLODCellHeatmap::None) {
+		UpdateHeatmap();
+		return;
+	}
+	TArray<SHLODCellCanvas::FCell> Cells;
+	FBox2D CanvasBounds(ForceInit);
+	if (FHLODLevelInfo* LevelInfo = GetCurrentLevelInfo()) {
+		Cells.Reserve(LevelInfo->HLods.Num());
+		for (const FActorDescInfo& ActorDescInfo : LevelInfo->HLods) {
+			const FBox Bound = ActorDescInfo.ActorDesc->GetEditorBounds();
+			SHLODCellCanvas::FCell& Cell = Cells.AddDefaulted_GetRef();
+			Cell.Bounds = FBox2D(FVector2D(Bound.Min), FVector2D(Bound.Max));
+			Cell.Label = FText::FromString(FString::Printf(TEXT("%3d,%3d"), ActorDescInfo.CellX, ActorDescInfo.CellY));
+			Cell.Color = ActorDescInfo.bIsPreview ? FLinearColor(0, 1, 0, 1) : FLinearColor(0.05f, 0.05f, 0.05f, 1);
+		}
+		CanvasBounds = FBox2D(FVector2D(LevelInfo->LevelBound.Min), FVector2D(LevelInfo->LevelBound.Max));
+	}
+	mCellCanvas->SetCells(MoveTemp(Cells), CanvasBounds);
+}
+
+void SHLODOutliner::OnCellClicked(int32 InIndex)
+{
+	if (mHeatmap != EHLODCellHeatmap::None) {
+		if (mHeatmapCells.IsValidIndex(InIndex)) {
+			mOnStatsCellClicked.ExecuteIfBound(*mHeatmapCells[InIndex]);
+		}
+		return;
+	}
+	FHLODLevelInfo* LevelInfo = GetCurrentLevelInfo();
+	if (LevelInfo == nullptr || !LevelInfo->HLods.IsValidIndex(InIndex))
+		return;
+	FActorDescInfo& ActorDescInfo = LevelInfo->HLods[InIndex];
+	OnBlockClicked(ActorDescInfo);
+	mCellCanvas->SetCellColor(InIndex, ActorDescInfo.bIsPreview ? FLinearColor(0, 1, 0, 1) : FLinearColor(0.05f, 0.05f, 0.05f, 1));
+}
+
+TSharedPtr<SWidget> SHLODOutliner::OnGetCellMenu(int32 InIndex)
+{
+	if (mHeatmap != EHLODCellHeatmap::None)
+		return nullptr;
+	FHLODLevelInfo* LevelInfo = GetCurrentLevelInfo();
+	if (LevelInfo == nullptr || !LevelInfo->HLods.IsValidIndex(InIndex))
+		return nullptr;
+	return OnGetBlockMenu(LevelInfo->HLods[InIndex].ActorDesc);
+}
+
+const FWorldPartitionGridStats* SHLODOutliner::GetCurrentGridStats() const
+{
+	TSharedPtr<FString> CurrentGridName = mGridNameComboBox->GetSelectedItem();
+	if (!mStats || !CurrentGridName)
+		return nullptr;
+	const FName GridName(**CurrentGridName);
+	return mStats->Grids.FindByPredicate([GridName](const FWorldPartitionGridStats& GridStats) {
+		return GridStats.GridName == GridName;
+	});
+}
+
+double SHLODOutliner::GetHeatmapValue(const FWorldPartitionCellStats& InCell) const
+{
+	switch (mHeatmap) {
+	case EHLODCellHeatmap::Triangles:
+		return InCell.TriangleCount;
+	case EHLODCellHeatmap::DrawCalls:
+		return InCell.DrawCallCount;
+	case EHLODCellHeatmap::TextureMemory:
+		return InCell.TextureMemory.Total;
+	case EHLODCellHeatmap::IncrementalTextureMemory:
+		return InCell.IncrementalTextureMemory.Total;
+	case EHLODCellHeatmap::ActorCount:
+		return InCell.Actors.Num();
+	case EHLODCellHeatmap::HLODTriangleRatio:
+		return InCell.HLOD.SourceTriangles > 0 ? (double)InCell.HLOD.Triangles / InCell.HLOD.SourceTriangles : -1.0;
+	case EHLODCellHeatmap::ScreenSizeAtLoadingRange:
+		return InCell.ScreenSizeAtLoadingRange;
+	default:
+		return 0.0;
+	}
+}
+
+FString SHLODOutliner::FormatHeatmapValue(double InValue) const
+{
+	switch (mHeatmap) {
+	case EHLODCellHeatmap::TextureMemory:
+	case EHLODCellHeatmap::IncrementalTextureMemory:
+		return FText::AsMemory((uint64)InValue).ToString();
+	case EHLODCellHeatmap::HLODTriangleRatio:
+		return FString::Printf(TEXT("%.1f%%"), InValue * 100.0);
+	case EHLODCellHeatmap::ScreenSizeAtLoadingRange:
+		return FString::Printf(TEXT("%.3f"), InValue);
+	default:
+		return FText::AsNumber((int64)InValue).ToString();
+	}
+}
+
+void SHLODOutliner::UpdateHeatmap()
+{
+	TArray<SHLODCellCanvas::FCell> Cells;
+	mHeatmapCells.Reset();
+	mHotCells.Reset();
+	mHeatmapLegend = FText::GetEmpty();
+	const FWorldPartitionGridStats* GridStats = GetCurrentGridStats();
+	if (GridStats == nullptr) {
+		mCellCanvas->SetCells(MoveTemp(Cells), FBox2D(ForceInit));
+		mHotCellListView->RequestListRefresh();
+		return;
+	}
+	const int32 Level = mLevelSilder->GetValue();
+	TArray<double> Values;
+	for (const FWorldPartitionCellStats& CellStats : GridStats->Cells) {
+		if (CellStats.HierarchicalLevel != Level)
+			continue;
+		mHeatmapCells.Add(&CellStats);
+		Values.Add(GetHeatmapValue(CellStats));
+	}
+
+	// Colours follow the percentile rank, a single outlier would otherwise flatten every other cell to the same colour.
+	TArray<double> SortedValues;
+	for (double Value : Values) {
+		if (Value >= 0.0) {
+			SortedValues.Add(Value);
+		}
+	}
+	SortedValues.Sort();
+	auto GetPercentileValue = [&SortedValues](double InPercentile) {
+		return SortedValues[FMath::Clamp(FMath::CeilToInt(InPercentile * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1)];
+	};
+	const FLinearColor Cold(0.05f, 0.35f, 0.05f);
+	const FLinearColor Warm(0.8f, 0.7f, 0.05f);
+	const FLinearColor Hot(0.9f, 0.05f, 0.02f);
+	Cells.Reserve(mHeatmapCells.Num());
+	for (int32 Index = 0; Index < mHeatmapCells.Num(); Index++) {
+		const FWorldPartitionCellStats& CellStats = *mHeatmapCells[Index];
+		SHLODCellCanvas::FCell& Cell = Cells.AddDefaulted_GetRef();
+		Cell.Bounds = FBox2D(FVector2D(CellStats.Bounds.Min), FVector2D(CellStats.Bounds.Max));
+		if (Values[Index] < 0.0) {
+			Cell.Color = FLinearColor(0.1f, 0.1f, 0.1f);
+			continue;
+		}
+		Cell.Label = FText::FromString(FormatHeatmapValue(Values[Index]));
+		const float Percentile = SortedValues.Num() > 1 ? (float)Algo::LowerBound(SortedValues, Values[Index]) / (SortedValues.Num() - 1) : 0.0f;
+		Cell.Color = Percentile < 0.5f ? FMath::Lerp(Cold, Warm, Percentile * 2.0f) : FMath::Lerp(Warm, Hot, Percentile * 2.0f - 1.0f);
+		mHotCells.Add(MakeShared<FHotCell>(FHotCell{ &CellStats, Values[Index] }));
+	}
+	mCellCanvas->SetCells(MoveTemp(Cells), FBox2D(FVector2D(GridStats->Bounds.Min), FVector2D(GridStats->Bounds.Max)));
+
+	mHotCells.Sort([](const TSharedPtr<FHotCell>& Lhs, const TSharedPtr<FHotCell>& Rhs) {
+		return Lhs->Value > Rhs->Value;
+	});
+	if (mHotCells.Num() > mHotCellCount) {
+		mHotCells.SetNum(mHotCellCount);
+	}
+	mHotCellListView->RequestListRefresh();
+	if (!SortedValues.IsEmpty()) {
+		mHeatmapLegend = FText::FromString(FString::Printf(TEXT("p50 %s   p90 %s   p99 %s   max %s"),
+			*FormatHeatmapValue(GetPercentileValue(0.5)), *FormatHeatmapValue(GetPercentileValue(0.9)),
+			*FormatHeatmapValue(GetPercentileValue(0.99)), *FormatHeatmapValue(SortedValues.Last())));
+	}
+	if (mHeatmap == EHLODCellHeatmap::TextureMemory || mHeatmap == EHLODCellHeatmap::IncrementalTextureMemory) {
+		FString GridMemory = FString::Printf(TEXT("grid %s in %d textures"), *FText::AsMemory((uint64)GridStats->TextureMemory.Total).ToString(), GridStats->NumTextures);
+		for (const auto& Pair : GridStats->TextureMemory.Platforms) {
+			GridMemory += FString::Printf(TEXT("   %s %s"), *Pair.Key.ToString(), *FText::AsMemory((uint64)Pair.Value).ToString());
+		}
+		mHeatmapLegend = FText::FromString(mHeatmapLegend.ToString() + TEXT("\n") + GridMemory);
+	}
+}
+
+void SHLODOutliner::UpdateHeatmapLevelRange()
+{
+	const FWorldPartitionGridStats* GridStats = GetCurrentGridStats();
+	if (GridStats == nullptr || GridStats->Cells.IsEmpty())
+		return;
+	int32 Min = MAX_int32, Max = 0;
+	for (const FWorldPartitionCellStats& CellStats : GridStats->Cells) {
+		Min = FMath::Min(Min, CellStats.HierarchicalLevel);
+		Max = FMath::Max(Max, CellStats.HierarchicalLevel);
+	}
+	mLevelSilder->SetMinAndMaxValues(Min, Max);
+	mCurrentLevel = FMath::Clamp((int32)mLevelSilder->GetValue(), Min, Max);
+	mLevelSilder->SetValue(mCurrentLevel);
+}
+
+void SHLODOutliner::OnHeatmapChanged(TSharedPtr<FString> Selection, ESelectInfo::Type SelectInfo)
+{
+	mHeatmap = (EHLODCellHeatmap)FMath::Max(mHeatmapNames.IndexOfByKey(Selection), 0);
+	if (mHeatmap != EHLODCellHeatmap::None) {
+		UpdateHeatmapLevelRange();
+	}
+	else if (TSharedPtr<FString> CurrentHLodName = mHLODNameComboBox->GetSelectedItem()) {
+		OnHLodNameChanged(CurrentHLodName, ESelectInfo::Direct);
+	}
+	bNeedUpdateCanvas = true;
+}
+
+TSharedRef<ITableRow> SHLODOutliner::OnGenerateHotCellRow(TSharedPtr<FHotCell> InHotCell, const TSharedRef<STableViewBase>& InOwnerTable)
+{
+	return SNew(STableRow<TSharedPtr<FHotCell>>, InOwnerTable)
+		[
+			SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.FillWidth(0.7f)
+				[
+					SNew(STextBlock)
+						.Text(FText::FromName(InHotCell->Cell->CellName.IsNone() ? InHotCell->Cell->CellPackage : InHotCell->Cell->CellName))
+						.ToolTipText(FText::FromName(InHotCell->Cell->CellPackage))
+				]
+				+ SHorizontalBox::Slot()
+				.FillWidth(0.3f)
+				[
+					SNew(STextBlock)
+						.Text(FText::FromString(FormatHeatmapValue(InHotCell->Value)))
+				]
+		];
+}
+
+void SHLODOutliner::OnHotCellSelected(TSharedPtr<FHotCell> InHotCell, ESelectInfo::Type SelectInfo)
+{
+	if (InHotCell) {
+		mOnStatsCellClicked.ExecuteIfBound(*InHotCell->Cell);
+	}
 }
 
 TSharedRef<SWidget> SHLODOutliner::OnGetBlockMenu(TSharedPtr<FWorldPartitionActorDesc> InActorDesc) {
@@ -364,26 +656,6 @@ TSharedRef<SWidget> SHLODOutliner::OnGetBlockMenu(TSharedPtr<FWorldPartitionActo
 	return MenuBuilder.MakeWidget();
 }
 
-FVector2D SHLODOutliner::OnGetBlockPosition(TSharedPtr<FWorldPartitionActorDesc> InActorDesc, FBox InLevelBound)
-{
-	FBox Bound = InActorDesc->GetEditorBounds();
-	FVector2D Position(
-		(Bound.Min.X - InLevelBound.Min.X) / (InLevelBound.Max.X - InLevelBound.Min.X),
-		(Bound.Min.Y - InLevelBound.Min.Y) / (InLevelBound.Max.Y - InLevelBound.Min.Y)
-	);
-	return Position * mCanvas->GetPersistentState().AllottedGeometry.Size;
-}
-
-FVector2D SHLODOutliner::OnGetBlockSize(TSharedPtr<FWorldPartitionActorDesc> InActorDesc, FBox InLevelBound)
-{
-	FBox Bound = InActorDesc->GetEditorBounds();
-	FVector2D Size(
-		(Bound.Max.X - Bound.Min.X) / (InLevelBound.Max.X - InLevelBound.Min.X),
-		(Bound.Max.Y - Bound.Min.Y) / (InLevelBound.Max.Y - InLevelBound.Min.Y)
-	);
-	return Size * mCanvas->GetPersistentState().AllottedGeometry.Size;
-}
-
 void SHLODOutliner::OnGridNameChanged(TSharedPtr<FString> Selection, ESelectInfo::Type SelectInfo)
 {
 	if (TMap<FString, TMap<int, FHLODLevelInfo>>* GridInfo = mLevelActorDescInfoMap.Find(*Selection)) {
@@ -397,6 +669,9 @@ void SHLODOutliner::OnGridNameChanged(TSharedPtr<FString> Selection, ESelectInfo
 	if (!mHLODNames.IsEmpty()) {
 		mHLODNameComboBox->SetSelectedItem(mHLODNames[0]);
 	}
+	if (mHeatmap != EHLODCellHeatmap::None) {
+		UpdateHeatmapLevelRange();
+	}
 	bNeedUpdateCanvas = true;
 }
 
@@ -536,12 +811,863 @@ void SHLODOutliner::OnSelectHLODSourceActor(TSharedPtr<FWorldPartitionActorDesc>
 	}
 }
 
+namespace
+{
+	/** Mesh and texture statistics read from asset registry tags and package dependencies, nothing gets loaded. */
+	class FWorldPartitionAssetStatsCache
+	{
+	public:
+		struct FPackageStats
+		{
+			int32 Meshes = 0;
+			int32 Triangles = 0;
+			int32 Sections = 0;
+			TSet<FSoftObjectPath> Textures;
+			/** Every package the stats were read from, their saved hashes key the stats cache. */
+			TSet<FName> Packages;
+		};
+
+		FWorldPartitionAssetStatsCache(FWorldPartitionStats& InStats)
+			: AssetRegistry(FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get())
+			, Stats(InStats)
+		{
+		}
+
+		/** Follows blueprints and materials, meshes and textures are leaves. */
+		TSharedRef<const FPackageStats> GetPackageStats(FName InPackage)
+		{
+			if (const TSharedRef<FPackageStats>* Cached = PackageStats.Find(InPackage))
+				return *Cached;
+			// Registered before recursing so that cyclic references terminate.
+			TSharedRef<FPackageStats> Result = PackageStats.Add(InPackage, MakeShared<FPackageStats>());
+			TArray<FName> Dependencies;
+			AssetRegistry.GetDependencies(InPackage, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+			for (FName Dependency : Dependencies) {
+				if (FPackageName::IsScriptPackage(Dependency.ToString()))
+					continue;
+				TArray<FAssetData> Assets;
+				AssetRegistry.GetAssetsByPackageName(Dependency, Assets, true);
+				for (const FAssetData& Asset : Assets) {
+					UClass* Class = FindObject<UClass>(Asset.AssetClassPath);
+					if (Class == nullptr)
+						continue;
+					if (Class->IsChildOf(UStaticMesh::StaticClass())) {
+						TSharedRef<const FPackageStats> Nested = GetPackageStats(Dependency);
+						Result->Meshes++;
+						Result->Triangles += GetTagAsInt(Asset, TEXT("Triangles"));
+						Result->Sections += FMath::Max(1, GetTagAsInt(Asset, TEXT("Materials")));
+						Result->Textures.Append(Nested->Textures);
+						Result->Packages.Append(Nested->Packages);
+					}
+					else if (Class->IsChildOf(UTexture::StaticClass())) {
+						AddTexture(Asset);
+						Result->Textures.Add(Asset.GetSoftObjectPath());
+					}
+					else if (Class->IsChildOf(UMaterialInterface::StaticClass()) || Class->IsChildOf(UMaterialFunctionInterface::StaticClass())) {
+						TSharedRef<const FPackageStats> Nested = GetPackageStats(Dependency);
+						Result->Textures.Append(Nested->Textures);
+						Result->Packages.Append(Nested->Packages);
+					}
+					else if (Class->IsChildOf(UBlueprint::StaticClass())) {
+						TSharedRef<const FPackageStats> Nested = GetPackageStats(Dependency);
+						Result->Meshes += Nested->Meshes;
+						Result->Triangles += Nested->Triangles;
+						Result->Sections += Nested->Sections;
+						Result->Textures.Append(Nested->Textures);
+						Result->Packages.Append(Nested->Packages);
+					}
+					else {
+						continue;
+					}
+					Result->Packages.Add(Dependency);
+				}
+			}
+			return Result;
+		}
+
+		void AddTexture(const FAssetData& InAsset)
+		{
+			const FSoftObjectPath Path = InAsset.GetSoftObjectPath();
+			if (Stats.Textures.Contains(Path))
+				return;
+			FWorldPartitionTextureStats& TextureStats = Stats.Textures.Add(Path);
+			TextureStats.Path = Path.ToString();
+			TextureStats.TextureSize = FIntPoint::ZeroValue;
+			FString LODGroup;
+			InAsset.GetTagValue(GET_MEMBER_NAME_CHECKED(UTexture, LODGroup), LODGroup);
+			TextureStats.LODGroup = *LODGroup;
+			// Textures already in memory know their actual size and format, the tags only describe the source.
+			const UTexture2D* Texture = FindObject<UTexture2D>(nullptr, *TextureStats.Path);
+			if (const FTexturePlatformData* PlatformData = Texture ? Texture->GetPlatformData() : nullptr) {
+				TextureStats.TextureSize = FIntPoint(PlatformData->SizeX, PlatformData->SizeY);
+				TextureStats.Format = GetPixelFormatString(PlatformData->PixelFormat);
+			}
+			else {
+				FString Dimensions;
+				if (InAsset.GetTagValue(TEXT("Dimensions"), Dimensions)) {
+					FString Width, Height;
+					if (Dimensions.Split(TEXT("x"), &Width, &Height)) {
+						TextureStats.TextureSize = FIntPoint(FCString::Atoi(*Width), FCString::Atoi(*Height));
+					}
+				}
+				InAsset.GetTagValue(TEXT("Format"), TextureStats.Format);
+			}
+			TextureStats.MemorySize = EstimateTextureMemory(TextureStats.TextureSize, TextureStats.Format);
+		}
+
+		/**
+		 * Instance counts only live in the actor, so the registry is only used for classes that provably hold no instanced components.
+		 * Plain AActors are where MergeISM and the partition tools put their instance components, partition actors (foliage, PCG)
+		 * are built the same way, both have to be loaded. Blueprints are only read from the registry when neither their components
+		 * nor their construction script graph can add ISMs, graph nodes are not inspected so any construction script counts.
+		 * So do HLOD actors, their meshes are embedded in the actor package and have no registry tags.
+		 */
+		bool CanUseRegistry(const FWorldPartitionActorStats& InActorStats)
+		{
+			const FTopLevelAssetPath& ClassPath = InActorStats.BaseClass.IsValid() ? InActorStats.BaseClass : InActorStats.NativeClass;
+			if (const bool* bCached = RegistryClasses.Find(ClassPath))
+				return *bCached;
+			return RegistryClasses.Add(ClassPath, IsInstanceFree(ClassPath, InActorStats.NativeClass));
+		}
+
+		static bool IsInstanceFree(const FTopLevelAssetPath& InClassPath, const FTopLevelAssetPath& InNativeClassPath)
+		{
+			if (InClassPath == AActor::StaticClass()->GetClassPathName())
+				return false;
+			UClass* NativeClass = FindObject<UClass>(InNativeClassPath);
+			if (NativeClass == nullptr)
+				return false;
+			if (NativeClass->IsChildOf(APartitionActor::StaticClass()) || NativeClass->IsChildOf(AWorldPartitionHLOD::StaticClass()))
+				return false;
+			TArray<UInstancedStaticMeshComponent*> InstanceComponents;
+			NativeClass->GetDefaultObject<AActor>()->GetComponents(InstanceComponents);
+			if (!InstanceComponents.IsEmpty())
+				return false;
+			if (InClassPath == InNativeClassPath)
+				return true;
+			// Loading the Blueprint class is cheap next to loading its actors, the construction script templates tell what they spawn.
+			UClass* Class = LoadObject<UClass>(nullptr, *InClassPath.ToString());
+			if (Class == nullptr)
+				return false;
+			for (UBlueprintGeneratedClass* BlueprintClass = Cast<UBlueprintGeneratedClass>(Class); BlueprintClass; BlueprintClass = Cast<UBlueprintGeneratedClass>(BlueprintClass->GetSuperClass())) {
+				if (HasConstructionScript(BlueprintClass))
+					return false;
+				if (BlueprintClass->SimpleConstructionScript == nullptr)
+					continue;
+				for (const USCS_Node* Node : BlueprintClass->SimpleConstructionScript->GetAllNodes()) {
+					if (Node->ComponentClass && Node->ComponentClass->IsChildOf(UInstancedStaticMeshComponent::StaticClass()))
+						return false;
+				}
+			}
+			return true;
+		}
+
+		/** Anything but the entry node and comments in the user construction script, a class without its Blueprint counts as having one. */
+		static bool HasConstructionScript(UBlueprintGeneratedClass* InClass)
+		{
+			UBlueprint* Blueprint = UBlueprint::GetBlueprintFromClass(InClass);
+			if (Blueprint == nullptr)
+				return true;
+			const UEdGraph* Graph = FBlueprintEditorUtils::FindUserConstructionScript(Blueprint);
+			return Graph && Graph->Nodes.ContainsByPredicate([](const UEdGraphNode* InNode) {
+				return InNode && !InNode->IsA<UK2Node_FunctionEntry>() && !InNode->IsA<UEdGraphNode_Comment>();
+			});
+		}
+
+		static int64 EstimateTextureMemory(FIntPoint InSize, const FString& InFormat)
+		{
+			int32 BitsPerPixel = 32;
+			if (InFormat.Contains(TEXT("DXT1")) || InFormat.Contains(TEXT("BC4"))) {
+				BitsPerPixel = 4;
+			}
+			else if (InFormat.Contains(TEXT("DXT5")) || InFormat.Contains(TEXT("BC5")) || InFormat.Contains(TEXT("BC6")) || InFormat.Contains(TEXT("BC7")) || InFormat.Contains(TEXT("ASTC")) || InFormat == TEXT("G8")) {
+				BitsPerPixel = 8;
+			}
+			else if (InFormat.Contains(TEXT("FloatRGBA"))) {
+				BitsPerPixel = 64;
+			}
+			// The full mip chain adds a third.
+			return (int64)InSize.X * InSize.Y * BitsPerPixel / 8 * 4 / 3;
+		}
+	private:
+		static int32 GetTagAsInt(const FAssetData& InAsset, FName InTag)
+		{
+			FString Value;
+			return InAsset.GetTagValue(InTag, Value) ? FCString::Atoi(*Value) : 0;
+		}
+
+		IAssetRegistry& AssetRegistry;
+		FWorldPartitionStats& Stats;
+		TMap<FName, TSharedRef<FPackageStats>> PackageStats;
+		TMap<FTopLevelAssetPath, bool> RegistryClasses;
+	};
+
+	void GatherLoadedActorStats(AActor* InActor, FWorldPartitionActorStats& OutActorStats, FWorldPartitionCellStats& OutCellStats, TSet<FSoftObjectPath>& OutTextures)
+	{
+		TArray<UActorComponent*> ActorCompoents;
+		InActor->GetComponents(ActorCompoents, true);
+		for (auto ActorComp : ActorCompoents) {
+			OutCellStats.ComponentCount.FindOrAdd(ActorComp->GetClass()->GetName())++;
+			if (auto SMC = Cast<UStaticMeshComponent>(ActorComp)) {
+				UStaticMesh* Mesh = SMC->GetStaticMesh();
+				if (Mesh == nullptr)
+					continue;
+				OutActorStats.DrawCallCount += Mesh->GetNumSections(0);
+				if (auto ISMC = Cast<UInstancedStaticMeshComponent>(SMC)) {
+					OutActorStats.TriangleCount += Mesh->GetNumTriangles(0) * ISMC->GetInstanceCount();
+				}
+				else {
+					OutActorStats.TriangleCount += Mesh->GetNumTriangles(0);
+				}
+				for (UMaterialInterface* Material : SMC->GetMaterials()) {
+					if (Material) {
+						TArray<UTexture*> MaterialTextures;
+						Material->GetUsedTextures(MaterialTextures, EMaterialQualityLevel::Num, true, ERHIFeatureLevel::Num, true);
+						for (UTexture* Texture : MaterialTextures) {
+							OutTextures.Add(FSoftObjectPath(Texture));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+static FArchive& operator<<(FArchive& Ar, FWorldPartitionTextureStats& Stats)
+{
+	return Ar << Stats.Path << Stats.MemorySize << Stats.TextureSize << Stats.Format << Stats.LODGroup;
+}
+
+namespace
+{
+	constexpr uint32 StatsCacheMagic = 0x484C5354;
+	// Bump whenever the gathered statistics change meaning.
+	constexpr int32 StatsCacheVersion = 5;
+
+	struct FCachedActorStats
+	{
+		FGuid ActorGuid;
+		int32 DrawCallCount = 0;
+		int32 TriangleCount = 0;
+		int32 TextureCount = 0;
+		TArray<FGuid> SourceActors;
+
+		friend FArchive& operator<<(FArchive& Ar, FCachedActorStats& Stats)
+		{
+			return Ar << Stats.ActorGuid << Stats.DrawCallCount << Stats.TriangleCount << Stats.TextureCount << Stats.SourceActors;
+		}
+	};
+
+	/** Guids of the actors a loaded HLOD actor was built from. */
+	void GatherHLODSourceActors(const AActor* InActor, TArray<FGuid>& OutSourceActors)
+	{
+		const AWorldPartitionHLOD* HLODActor = Cast<AWorldPartitionHLOD>(InActor);
+		const UWorldPartitionHLODSourceActorsFromCell* SourceActors = HLODActor ? Cast<UWorldPartitionHLODSourceActorsFromCell>(HLODActor->GetSourceActors()) : nullptr;
+		if (SourceActors == nullptr)
+			return;
+		for (const auto& SourceActor : SourceActors->GetActors()) {
+#if ENGINE_MAJOR_VERSION >=5 && ENGINE_MINOR_VERSION >= 4
+			OutSourceActors.Add(SourceActor.ActorInstanceGuid);
+#else
+			OutSourceActors.Add(SourceActor.ActorGuid);
+#endif
+		}
+	}
+
+	struct FCachedCellStats
+	{
+		FSHAHash Key;
+		int32 DrawCallCount = 0;
+		int32 TriangleCount = 0;
+		TMap<FString, int32> ComponentCount;
+		TArray<FString> UsedTextures;
+		TArray<FCachedActorStats> Actors;
+
+		friend FArchive& operator<<(FArchive& Ar, FCachedCellStats& Stats)
+		{
+			return Ar << Stats.Key << Stats.DrawCallCount << Stats.TriangleCount << Stats.ComponentCount << Stats.UsedTextures << Stats.Actors;
+		}
+	};
+
+	struct FStatsCache
+	{
+		TMap<FString, FCachedCellStats> Cells;
+		TMap<FString, FWorldPartitionTextureStats> Textures;
+
+		friend FArchive& operator<<(FArchive& Ar, FStatsCache& Cache)
+		{
+			return Ar << Cache.Cells << Cache.Textures;
+		}
+	};
+}
+
+namespace
+{
+	FString GetStatsCacheFilename(UWorldPartition* InWorldPartition)
+	{
+		FString WorldName = InWorldPartition->GetWorld()->GetPackage()->GetName();
+		WorldName.ReplaceCharInline(TEXT('/'), TEXT('_'));
+		return FPaths::ProjectSavedDir() / TEXT("ProceduralContentProcessor/HLODStats") / WorldName + TEXT(".bin");
+	}
+
+	bool LoadStatsCache(const FString& InFilename, FStatsCache& OutCache)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InFilename, FILEREAD_Silent));
+		if (!Reader)
+			return false;
+		uint32 Magic = 0;
+		int32 Version = 0;
+		*Reader << Magic << Version;
+		if (Magic != StatsCacheMagic || Version != StatsCacheVersion)
+			return false;
+		*Reader << OutCache;
+		if (Reader->IsError()) {
+			OutCache = FStatsCache();
+			return false;
+		}
+		return true;
+	}
+
+	bool SaveStatsCache(const FString& InFilename, FStatsCache& InCache)
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*InFilename));
+		if (!Writer)
+			return false;
+		uint32 Magic = StatsCacheMagic;
+		int32 Version = StatsCacheVersion;
+		*Writer << Magic << Version << InCache;
+		return Writer->Close();
+	}
+
+	/** Hashes the saved hashes of every package the cell's statistics were read from. */
+	FSHAHash ComputeCellKey(const FWorldPartitionCellStats& InCell, const TMap<FName, const FWorldPartitionAssetStatsCache::FPackageStats*>& InPackageStats, const TMap<FName, FIoHash>& InPackageHashes, bool bInLoadUnresolvedActors)
+	{
+		FSHA1 Sha;
+		Sha.Update((const uint8*)&StatsCacheVersion, sizeof(StatsCacheVersion));
+		Sha.Update((const uint8*)&bInLoadUnresolvedActors, sizeof(bInLoadUnresolvedActors));
+		TSet<FName> Packages;
+		for (const FWorldPartitionActorStats& ActorStats : InCell.Actors) {
+			Sha.Update((const uint8*)&ActorStats.ActorGuid, sizeof(FGuid));
+			Packages.Add(ActorStats.Package);
+			Packages.Append(InPackageStats.FindChecked(ActorStats.Package)->Packages);
+		}
+		TArray<FName> SortedPackages = Packages.Array();
+		SortedPackages.Sort(FNameLexicalLess());
+		for (FName Package : SortedPackages) {
+			const FString PackageName = Package.ToString();
+			Sha.UpdateWithString(*PackageName, PackageName.Len());
+			if (const FIoHash* SavedHash = InPackageHashes.Find(Package)) {
+				Sha.Update(SavedHash->GetBytes(), sizeof(FIoHash::ByteArray));
+			}
+		}
+		Sha.Final();
+		FSHAHash Key;
+		Sha.GetHash(Key.Hash);
+		return Key;
+	}
+
+	/** Sums the HLOD actors of every cell and the triangles of the source actors they stand in for. */
+	void AccumulateHLODStats(FWorldPartitionStats& InOutStats)
+	{
+		TMap<FTopLevelAssetPath, bool> HLODClasses;
+		auto IsHLODActor = [&HLODClasses](const FWorldPartitionActorStats& InActorStats) {
+			if (const bool* bCached = HLODClasses.Find(InActorStats.NativeClass))
+				return *bCached;
+			UClass* NativeClass = FindObject<UClass>(InActorStats.NativeClass);
+			return HLODClasses.Add(InActorStats.NativeClass, NativeClass && NativeClass->IsChildOf(AWorldPartitionHLOD::StaticClass()));
+		};
+		// HLOD actors stream in grids of their own per HLOD layer, their sources are found by guid in any grid.
+		TMap<FGuid, const FWorldPartitionActorStats*> Actors;
+		for (const FWorldPartitionGridStats& GridStats : InOutStats.Grids) {
+			for (const FWorldPartitionCellStats& CellStats : GridStats.Cells) {
+				for (const FWorldPartitionActorStats& ActorStats : CellStats.Actors) {
+					Actors.Add(ActorStats.ActorGuid, &ActorStats);
+				}
+			}
+		}
+		for (FWorldPartitionGridStats& GridStats : InOutStats.Grids) {
+			for (FWorldPartitionCellStats& CellStats : GridStats.Cells) {
+				for (const FWorldPartitionActorStats& ActorStats : CellStats.Actors) {
+					if (!IsHLODActor(ActorStats))
+						continue;
+					CellStats.HLOD.Triangles += ActorStats.TriangleCount;
+					CellStats.HLOD.DrawCalls += ActorStats.DrawCallCount;
+					CellStats.HLOD.TextureCount += ActorStats.TextureCount;
+					for (const FGuid& SourceActor : ActorStats.SourceActors) {
+						if (const FWorldPartitionActorStats* const* Source = Actors.Find(SourceActor)) {
+							CellStats.HLOD.SourceTriangles += (*Source)->TriangleCount;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/** Full mip chain of the texture once the LOD group of InLODSettings has biased and clamped it. */
+	int64 EstimateResidentTextureMemory(const FWorldPartitionTextureStats& InTexture, const UTextureLODSettings& InLODSettings)
+	{
+		const int64 GroupValue = StaticEnum<TextureGroup>()->GetValueByName(InTexture.LODGroup);
+		const FTextureLODGroup& LODGroup = InLODSettings.GetTextureLODGroup(GroupValue == INDEX_NONE ? TEXTUREGROUP_World : (TextureGroup)GroupValue);
+		int32 Bias = FMath::Max(LODGroup.LODBias, 0);
+		while (LODGroup.MaxLODSize > 0 && FMath::Max(InTexture.TextureSize.X, InTexture.TextureSize.Y) >> Bias > LODGroup.MaxLODSize) {
+			Bias++;
+		}
+		const FIntPoint Size(FMath::Max(InTexture.TextureSize.X >> Bias, 1), FMath::Max(InTexture.TextureSize.Y >> Bias, 1));
+		return FWorldPartitionAssetStatsCache::EstimateTextureMemory(Size, InTexture.Format);
+	}
+
+	/** Unique texture memory per cell, per loading range around every cell and per grid, plus what every cell adds to its neighbours. */
+	void AccumulateTextureStats(FWorldPartitionStats& InOutStats, const TArray<FString>& InPlatforms)
+	{
+		TArray<TPair<FName, const UTextureLODSettings*>> Platforms;
+		for (const FString& Platform : InPlatforms) {
+			UDeviceProfile* DeviceProfile = UDeviceProfileManager::Get().FindProfile(Platform, false);
+			if (DeviceProfile == nullptr) {
+				UE_LOG(LogTemp, Warning, TEXT("No device profile %s for the texture memory estimate"), *Platform);
+				continue;
+			}
+			Platforms.Add({ FName(*Platform), DeviceProfile->GetTextureLODSettings() });
+		}
+
+		// Textures are interned once, every set below is a list of indices into this table.
+		TMap<FSoftObjectPath, int32> TextureIndices;
+		TArray<const FWorldPartitionTextureStats*> Textures;
+		TextureIndices.Reserve(InOutStats.Textures.Num());
+		Textures.Reserve(InOutStats.Textures.Num());
+		for (auto& Pair : InOutStats.Textures) {
+			Pair.Value.PlatformMemorySize.Reset();
+			for (const auto& Platform : Platforms) {
+				Pair.Value.PlatformMemorySize.Add(Platform.Key, EstimateResidentTextureMemory(Pair.Value, *Platform.Value));
+			}
+			TextureIndices.Add(Pair.Key, Textures.Add(&Pair.Value));
+		}
+		auto AddMemory = [&Textures](FWorldPartitionTextureMemory& OutMemory, int32 InTexture) {
+			OutMemory.Total += Textures[InTexture]->MemorySize;
+			for (const auto& Pair : Textures[InTexture]->PlatformMemorySize) {
+				OutMemory.Platforms.FindOrAdd(Pair.Key) += Pair.Value;
+			}
+		};
+
+		for (FWorldPartitionGridStats& GridStats : InOutStats.Grids) {
+			TArray<TArray<int32>> CellTextures;
+			CellTextures.SetNum(GridStats.Cells.Num());
+			TMultiMap<TPair<int32, FIntPoint>, int32> CellsByCoord;
+			for (int32 CellIndex = 0; CellIndex < GridStats.Cells.Num(); CellIndex++) {
+				const FWorldPartitionCellStats& CellStats = GridStats.Cells[CellIndex];
+				for (const FSoftObjectPath& Texture : CellStats.UsedTextures) {
+					if (const int32* TextureIndex = TextureIndices.Find(Texture)) {
+						CellTextures[CellIndex].Add(*TextureIndex);
+					}
+				}
+				const FBox2D Bounds(FVector2D(CellStats.Bounds.Min), FVector2D(CellStats.Bounds.Max));
+				FWorldPartitionGridStats::ForEachCellCoord(Bounds, GridStats.GetLevelCellSize(CellStats.HierarchicalLevel), [&](const FIntPoint& InCoord) {
+					CellsByCoord.Add({ CellStats.HierarchicalLevel, InCoord }, CellIndex);
+				});
+			}
+
+			ParallelFor(GridStats.Cells.Num(), [&](int32 CellIndex) {
+				FWorldPartitionCellStats& CellStats = GridStats.Cells[CellIndex];
+				CellStats.TextureMemory = FWorldPartitionTextureMemory();
+				CellStats.LoadingRangeTextureMemory = FWorldPartitionTextureMemory();
+				CellStats.IncrementalTextureMemory = FWorldPartitionTextureMemory();
+				for (int32 Texture : CellTextures[CellIndex]) {
+					AddMemory(CellStats.TextureMemory, Texture);
+				}
+				const FVector2D Center(CellStats.Bounds.GetCenter());
+				const FBox2D Range(Center - GridStats.LoadingRange, Center + GridStats.LoadingRange);
+				const double RangeSquared = (double)GridStats.LoadingRange * GridStats.LoadingRange;
+				// A neighbour overlapping several squares is visited once per square, the resident bits keep its textures counted once.
+				TBitArray<> Resident(false, Textures.Num());
+				FWorldPartitionGridStats::ForEachCellCoord(Range, GridStats.GetLevelCellSize(CellStats.HierarchicalLevel), [&](const FIntPoint& InCoord) {
+					for (auto It = CellsByCoord.CreateConstKeyIterator({ CellStats.HierarchicalLevel, InCoord }); It; ++It) {
+						const FWorldPartitionCellStats& Neighbour = GridStats.Cells[It.Value()];
+						if (It.Value() == CellIndex || FBox2D(FVector2D(Neighbour.Bounds.Min), FVector2D(Neighbour.Bounds.Max)).ComputeSquaredDistanceToPoint(Center) > RangeSquared)
+							continue;
+						for (int32 Texture : CellTextures[It.Value()]) {
+							if (!Resident[Texture]) {
+								Resident[Texture] = true;
+								AddMemory(CellStats.LoadingRangeTextureMemory, Texture);
+							}
+						}
+					}
+				});
+				for (int32 Texture : CellTextures[CellIndex]) {
+					if (!Resident[Texture]) {
+						AddMemory(CellStats.IncrementalTextureMemory, Texture);
+						AddMemory(CellStats.LoadingRangeTextureMemory, Texture);
+					}
+				}
+			});
+
+			GridStats.TextureMemory = FWorldPartitionTextureMemory();
+			GridStats.NumTextures = 0;
+			TBitArray<> GridTextures(false, Textures.Num());
+			for (const TArray<int32>& Cell : CellTextures) {
+				for (int32 Texture : Cell) {
+					if (!GridTextures[Texture]) {
+						GridTextures[Texture] = true;
+						AddMemory(GridStats.TextureMemory, Texture);
+						GridStats.NumTextures++;
+					}
+				}
+			}
+		}
+	}
+}
+
+void UHLODPreviewTool::GatherActorStats(UWorldPartition* InWorldPartition, FWorldPartitionStats& InOutStats)
+{
+	FWorldPartitionAssetStatsCache Cache(InOutStats);
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	const FString CacheFilename = GetStatsCacheFilename(InWorldPartition);
+	FStatsCache StatsCache;
+	LoadStatsCache(CacheFilename, StatsCache);
+
+	struct FCellWork {
+		FWorldPartitionCellStats* Cell = nullptr;
+		FSHAHash Key;
+		const FCachedCellStats* Cached = nullptr;
+		TSet<FSoftObjectPath> Textures;
+		TArray<FWorldPartitionActorStats*> PendingActors;
+		bool bResolved = true;
+	};
+	TArray<FCellWork> CellWorks;
+	for (FWorldPartitionGridStats& GridStats : InOutStats.Grids) {
+		for (FWorldPartitionCellStats& CellStats : GridStats.Cells) {
+			CellWorks.AddDefaulted_GetRef().Cell = &CellStats;
+		}
+	}
+
+	// The dependency walk, class lookups and registry queries share caches, so they run up front on this thread.
+	TMap<FName, const FWorldPartitionAssetStatsCache::FPackageStats*> PackageStats;
+	TSet<const FWorldPartitionActorStats*> UnresolvableActors;
+	for (FCellWork& Work : CellWorks) {
+		for (const FWorldPartitionActorStats& ActorStats : Work.Cell->Actors) {
+			if (!PackageStats.Contains(ActorStats.Package)) {
+				PackageStats.Add(ActorStats.Package, &Cache.GetPackageStats(ActorStats.Package).Get());
+			}
+			if (!Cache.CanUseRegistry(ActorStats)) {
+				UnresolvableActors.Add(&ActorStats);
+			}
+		}
+	}
+	TMap<FName, FIoHash> PackageHashes;
+	auto AddPackageHash = [&](FName InPackage) {
+		if (!PackageHashes.Contains(InPackage)) {
+			TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(InPackage);
+			PackageHashes.Add(InPackage, PackageData ? PackageData->GetPackageSavedHash() : FIoHash());
+		}
+	};
+	for (const auto& Pair : PackageStats) {
+		AddPackageHash(Pair.Key);
+		for (FName Package : Pair.Value->Packages) {
+			AddPackageHash(Package);
+		}
+	}
+
+	// Everything below only touches its own cell.
+	ParallelFor(CellWorks.Num(), [&](int32 WorkIndex) {
+		FCellWork& Work = CellWorks[WorkIndex];
+		FWorldPartitionCellStats& CellStats = *Work.Cell;
+		Work.Key = ComputeCellKey(CellStats, PackageStats, PackageHashes, bLoadUnresolvedActors);
+		const FCachedCellStats* Cached = StatsCache.Cells.Find(CellStats.CellPackage.ToString());
+		if (Cached && Cached->Key == Work.Key && Cached->Actors.Num() == CellStats.Actors.Num()) {
+			Work.Cached = Cached;
+			CellStats.DrawCallCount = Cached->DrawCallCount;
+			CellStats.TriangleCount = Cached->TriangleCount;
+			CellStats.ComponentCount = Cached->ComponentCount;
+			for (const FString& Texture : Cached->UsedTextures) {
+				CellStats.UsedTextures.Add(FSoftObjectPath(Texture));
+			}
+			for (int32 Index = 0; Index < CellStats.Actors.Num(); Index++) {
+				FWorldPartitionActorStats& ActorStats = CellStats.Actors[Index];
+				const FCachedActorStats& CachedActor = Cached->Actors[Index];
+				ActorStats.DrawCallCount = CachedActor.DrawCallCount;
+				ActorStats.TriangleCount = CachedActor.TriangleCount;
+				ActorStats.TextureCount = CachedActor.TextureCount;
+				ActorStats.SourceActors = CachedActor.SourceActors;
+			}
+			return;
+		}
+		for (FWorldPartitionActorStats& ActorStats : CellStats.Actors) {
+			if (UnresolvableActors.Contains(&ActorStats)) {
+				Work.PendingActors.Add(&ActorStats);
+				continue;
+			}
+			const FWorldPartitionAssetStatsCache::FPackageStats& ActorPackageStats = *PackageStats.FindChecked(ActorStats.Package);
+			ActorStats.DrawCallCount = ActorPackageStats.Sections;
+			ActorStats.TriangleCount = ActorPackageStats.Triangles;
+			ActorStats.TextureCount = ActorPackageStats.Textures.Num();
+			if (ActorPackageStats.Meshes > 0) {
+				CellStats.ComponentCount.FindOrAdd(UStaticMeshComponent::StaticClass()->GetName()) += ActorPackageStats.Meshes;
+			}
+			Work.Textures.Append(ActorPackageStats.Textures);
+		}
+		Work.bResolved = Work.PendingActors.IsEmpty();
+	});
+
+	struct FPendingActor {
+		FCellWork* Work;
+		FWorldPartitionActorStats* Actor;
+	};
+	TArray<FPendingActor> PendingActors;
+	for (FCellWork& Work : CellWorks) {
+		if (Work.Cached) {
+			InOutStats.NumCellsFromCache++;
+			for (const FString& Texture : Work.Cached->UsedTextures) {
+				if (const FWorldPartitionTextureStats* TextureStats = StatsCache.Textures.Find(Texture)) {
+					InOutStats.Textures.Add(FSoftObjectPath(Texture), *TextureStats);
+				}
+			}
+			continue;
+		}
+		InOutStats.NumActorsFromRegistry += Work.Cell->Actors.Num() - Work.PendingActors.Num();
+		for (FWorldPartitionActorStats* Actor : Work.PendingActors) {
+			PendingActors.Add({ &Work, Actor });
+		}
+	}
+
+	if (bLoadUnresolvedActors && !PendingActors.IsEmpty()) {
+		FScopedSlowTask SlowTask(PendingActors.Num(), LOCTEXT("GatherActorStats", "Loading actors for HLOD statistics"));
+		SlowTask.MakeDialog(true);
+		int32 NumProcessed = 0;
+		for (int32 BatchBegin = 0; BatchBegin < PendingActors.Num() && !SlowTask.ShouldCancel(); BatchBegin += LoadBatchSize) {
+			const int32 BatchEnd = FMath::Min(BatchBegin + LoadBatchSize, PendingActors.Num());
+			SlowTask.EnterProgressFrame(BatchEnd - BatchBegin);
+			// Only the actors pinned here are released again, the ones the user had loaded stay.
+			TArray<FGuid> PinnedActors;
+			for (int32 Index = BatchBegin; Index < BatchEnd; Index++) {
+				FWorldPartitionActorDesc* ActorDesc = InWorldPartition->GetActorDescContainer()->GetActorDesc(PendingActors[Index].Actor->ActorGuid);
+				if (ActorDesc && !ActorDesc->IsLoaded()) {
+					PinnedActors.Add(ActorDesc->GetGuid());
+				}
+			}
+			InWorldPartition->PinActors(PinnedActors);
+			for (int32 Index = BatchBegin; Index < BatchEnd; Index++) {
+				FPendingActor& Pending = PendingActors[Index];
+				FWorldPartitionActorDesc* ActorDesc = InWorldPartition->GetActorDescContainer()->GetActorDesc(Pending.Actor->ActorGuid);
+				if (ActorDesc == nullptr)
+					continue;
+				if (AActor* Actor = ActorDesc->Load()) {
+					TSet<FSoftObjectPath> ActorTextures;
+					GatherLoadedActorStats(Actor, *Pending.Actor, *Pending.Work->Cell, ActorTextures);
+					Pending.Actor->TextureCount = ActorTextures.Num();
+					GatherHLODSourceActors(Actor, Pending.Actor->SourceActors);
+					for (const FSoftObjectPath& Texture : ActorTextures) {
+						const FAssetData TextureAsset = AssetRegistry.GetAssetByObjectPath(Texture);
+						if (TextureAsset.IsValid()) {
+							Cache.AddTexture(TextureAsset);
+						}
+					}
+					Pending.Work->Textures.Append(ActorTextures);
+					InOutStats.NumActorsLoaded++;
+				}
+			}
+			InWorldPartition->UnpinActors(PinnedActors);
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			NumProcessed = BatchEnd;
+		}
+		// Cells are only complete once all of their pending actors went through a batch.
+		for (int32 Index = 0; Index < NumProcessed; Index++) {
+			PendingActors[Index].Work->PendingActors.Remove(PendingActors[Index].Actor);
+		}
+		for (FCellWork& Work : CellWorks) {
+			Work.bResolved = Work.PendingActors.IsEmpty();
+		}
+	}
+
+	ParallelFor(CellWorks.Num(), [&](int32 WorkIndex) {
+		FCellWork& Work = CellWorks[WorkIndex];
+		if (Work.Cached)
+			return;
+		FWorldPartitionCellStats& CellStats = *Work.Cell;
+		for (const FWorldPartitionActorStats& ActorStats : CellStats.Actors) {
+			CellStats.DrawCallCount += ActorStats.DrawCallCount;
+			CellStats.TriangleCount += ActorStats.TriangleCount;
+		}
+		CellStats.UsedTextures = Work.Textures.Array();
+	});
+
+	FStatsCache NewStatsCache;
+	int32 NumUnresolvedCells = 0;
+	for (const FCellWork& Work : CellWorks) {
+		const FWorldPartitionCellStats& CellStats = *Work.Cell;
+		if (!Work.bResolved) {
+			NumUnresolvedCells++;
+			continue;
+		}
+		FCachedCellStats& Cached = NewStatsCache.Cells.Add(CellStats.CellPackage.ToString());
+		Cached.Key = Work.Key;
+		Cached.DrawCallCount = CellStats.DrawCallCount;
+		Cached.TriangleCount = CellStats.TriangleCount;
+		Cached.ComponentCount = CellStats.ComponentCount;
+		for (const FSoftObjectPath& Texture : CellStats.UsedTextures) {
+			const FString TexturePath = Texture.ToString();
+			Cached.UsedTextures.Add(TexturePath);
+			if (const FWorldPartitionTextureStats* TextureStats = InOutStats.Textures.Find(Texture)) {
+				NewStatsCache.Textures.Add(TexturePath, *TextureStats);
+			}
+		}
+		for (const FWorldPartitionActorStats& ActorStats : CellStats.Actors) {
+			Cached.Actors.Add({ ActorStats.ActorGuid, ActorStats.DrawCallCount, ActorStats.TriangleCount, ActorStats.TextureCount, ActorStats.SourceActors });
+		}
+	}
+	if (!SaveStatsCache(CacheFilename, NewStatsCache)) {
+		UE_LOG(LogTemp, Warning, TEXT("Failed to write the HLOD statistics cache %s"), *CacheFilename);
+	}
+	UE_LOG(LogTemp, Log, TEXT("HLOD statistics: %d cells from the cache, %d actors from the asset registry, %d loaded, %d cells unresolved"), InOutStats.NumCellsFromCache, InOutStats.NumActorsFromRegistry, InOutStats.NumActorsLoaded, NumUnresolvedCells);
+}
+
 TSharedPtr<SWidget> UHLODPreviewTool::BuildWidget()
 {
-	HLODOutliner = SNew(SHLODOutliner);
-	FWorldPartitionStats Stats = Generate(GetWorld());
+	Stats = MakeShared<FWorldPartitionStats>(Generate(GetWorld()));
+	HLODOutliner = SNew(SHLODOutliner)
+		.Stats(Stats)
+		.HotCellCount(HotCellCount)
+		.OnStatsCellClicked_UObject(this, &UHLODPreviewTool::ShowCellActors);
 	HLODOutliner->SetWorld(GetWorld());
-	return HLODOutliner;
+
+	FPropertyEditorModule& EditModule = FModuleManager::Get().GetModuleChecked<FPropertyEditorModule>("PropertyEditor");
+	FDetailsViewArgs DetailsViewArgs;
+	DetailsViewArgs.bShowObjectLabel = false;
+	DetailsViewArgs.bAllowSearch = false;
+	DetailsViewArgs.NameAreaSettings = FDetailsViewArgs::ENameAreaSettings::HideNameArea;
+	auto DetailView = EditModule.CreateDetailView(DetailsViewArgs);
+	DetailView->SetIsPropertyVisibleDelegate(FIsPropertyVisible::CreateLambda([](const FPropertyAndParent& Node) {
+		return !Node.Property.HasAnyPropertyFlags(EPropertyFlags::CPF_DisableEditOnInstance);
+	}));
+	DetailView->SetObject(this);
+
+	return SNew(SSplitter)
+		.Orientation(Orient_Vertical)
+		+ SSplitter::Slot()
+		.Value(0.55f)
+		[
+			HLODOutliner.ToSharedRef()
+		]
+		+ SSplitter::Slot()
+		.Value(0.15f)
+		[
+			SAssignNew(BudgetGraph, SHLODBudgetGraph)
+		]
+		+ SSplitter::Slot()
+		.Value(0.3f)
+		[
+			DetailView
+		];
+}
+
+void UHLODPreviewTool::SimulatePath()
+{
+	if (!Stats) {
+		Stats = MakeShared<FWorldPartitionStats>(Generate(GetWorld()));
+	}
+	// ClampMin only guards the details panel, config and Python can still set 0.
+	const float SampleSpacing = FMath::Max(SimulationSampleSpacing, 1.0f);
+	TArray<FVector> Points;
+	if (AActor* PathActor = SimulationSpline.Get()) {
+		if (USplineComponent* Spline = PathActor->FindComponentByClass<USplineComponent>()) {
+			const float Length = Spline->GetSplineLength();
+			for (float Distance = 0.0f; Distance < Length; Distance += SampleSpacing) {
+				Points.Add(Spline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World));
+			}
+			Points.Add(Spline->GetLocationAtDistanceAlongSpline(Length, ESplineCoordinateSpace::World));
+		}
+	}
+	else if (!SimulationCameraPath.FilePath.IsEmpty()) {
+		TArray<FString> Lines;
+		FFileHelper::LoadFileToStringArray(Lines, *SimulationCameraPath.FilePath);
+		for (const FString& Line : Lines) {
+			TArray<FString> Values;
+			if (Line.ParseIntoArray(Values, TEXT(",")) >= 3 && Values[0].IsNumeric()) {
+				Points.Add(FVector(FCString::Atod(*Values[0]), FCString::Atod(*Values[1]), FCString::Atod(*Values[2])));
+			}
+		}
+	}
+	if (Points.IsEmpty()) {
+		UE_LOG(LogTemp, Warning, TEXT("SimulatePath needs a spline actor or a camera path file"));
+		return;
+	}
+
+	const TArray<FVector> Path = FHLODStreamingSimulator::ResamplePath(Points, SampleSpacing);
+	TArray<FHLODStreamingSample> Samples = FHLODStreamingSimulator(*Stats).Simulate(Path);
+	const int64 TextureMemoryBudgetBytes = (int64)TextureMemoryBudget * 1024 * 1024;
+	FHLODStreamingSample Peak;
+	int32 NumOverBudget = 0;
+	for (const FHLODStreamingSample& Sample : Samples) {
+		Peak.Triangles = FMath::Max(Peak.Triangles, Sample.Triangles);
+		Peak.DrawCalls = FMath::Max(Peak.DrawCalls, Sample.DrawCalls);
+		Peak.TextureMemory = FMath::Max(Peak.TextureMemory, Sample.TextureMemory);
+		if (Sample.Triangles > TriangleBudget || Sample.DrawCalls > DrawCallBudget || Sample.TextureMemory > TextureMemoryBudgetBytes) {
+			NumOverBudget++;
+		}
+	}
+	UE_LOG(LogTemp, Log, TEXT("Streaming simulation: %d samples over %.0f m, peak %lld triangles, %lld draw calls, %lld MB textures, %d samples over budget"),
+		Samples.Num(), Samples.Last().Distance / 100.0, Peak.Triangles, Peak.DrawCalls, Peak.TextureMemory / (1024 * 1024), NumOverBudget);
+	if (BudgetGraph) {
+		BudgetGraph->SetSamples(MoveTemp(Samples), TriangleBudget, DrawCallBudget, TextureMemoryBudgetBytes);
+	}
+}
+
+void UHLODPreviewTool::ExportStats()
+{
+	if (StatsExportPath.FilePath.IsEmpty()) {
+		UE_LOG(LogTemp, Warning, TEXT("ExportStats needs a StatsExportPath"));
+		return;
+	}
+	if (!Stats) {
+		Stats = MakeShared<FWorldPartitionStats>(Generate(GetWorld()));
+	}
+	if (FHLODStatsExport::Write(StatsExportPath.FilePath, *Stats)) {
+		UE_LOG(LogTemp, Log, TEXT("World partition stats written to %s"), *StatsExportPath.FilePath);
+	}
+	else {
+		UE_LOG(LogTemp, Error, TEXT("Failed to write %s"), *StatsExportPath.FilePath);
+	}
+}
+
+void UHLODPreviewTool::DiffStats()
+{
+	TArray<FHLODStatsExport::FCell> BaseCells;
+	if (!FHLODStatsExport::Read(StatsBaselinePath.FilePath, BaseCells)) {
+		UE_LOG(LogTemp, Warning, TEXT("Failed to read the baseline %s"), *StatsBaselinePath.FilePath);
+		return;
+	}
+	if (!Stats) {
+		Stats = MakeShared<FWorldPartitionStats>(Generate(GetWorld()));
+	}
+	const TArray<FHLODStatsExport::FRegression> Regressions = FHLODStatsExport::Diff(BaseCells, FHLODStatsExport::Flatten(*Stats), HotCellCount);
+	for (const FHLODStatsExport::FRegression& Regression : Regressions) {
+		UE_LOG(LogTemp, Warning, TEXT("%s %s %s: %lld -> %lld"), *Regression.Metric, *Regression.Grid, *Regression.Package, Regression.Base, Regression.Current);
+	}
+	UE_LOG(LogTemp, Log, TEXT("%d cell regressions against %s"), Regressions.Num(), *StatsBaselinePath.FilePath);
+}
+
+void UHLODPreviewTool::ShowCellActors(const FWorldPartitionCellStats& InCell)
+{
+	UProceduralContentProcessorLibrary::ClearObjectMaterix(CellActors);
+	// The actors are usually not loaded, rows are keyed by their path like the asset rows.
+	auto AddField = [this](const TSharedPtr<FProceduralObjectMatrixRow>& InRow, FName InFieldName, FString InFieldValue) {
+		CellActors.FieldKeys.AddUnique(InFieldName);
+		TSharedPtr<FProceduralObjectMatrixTextField> Field = MakeShared<FProceduralObjectMatrixTextField>();
+		Field->Name = InFieldName;
+		Field->Text = MoveTemp(InFieldValue);
+		InRow->AddField(Field);
+	};
+	for (const FWorldPartitionActorStats& ActorStats : InCell.Actors) {
+		TSharedPtr<FProceduralObjectMatrixRow> Row = MakeShared<FProceduralObjectMatrixRow>();
+		Row->AssetPath = ActorStats.Path;
+		Row->Owner = ActorStats.Path.ResolveObject();
+		CellActors.AssetInfoMap.Add(ActorStats.Path, Row);
+		CellActors.ObjectInfoList.Add(Row);
+		AddField(Row, TEXT("Label"), ActorStats.Label);
+		AddField(Row, TEXT("Class"), ActorStats.NativeClass.GetAssetName().ToString());
+		AddField(Row, TEXT("Triangles"), FString::FromInt(ActorStats.TriangleCount));
+		AddField(Row, TEXT("DrawCalls"), FString::FromInt(ActorStats.DrawCallCount));
+		AddField(Row, TEXT("Textures"), FString::FromInt(ActorStats.TextureCount));
+	}
+	CellActors.SortRows(TEXT("Triangles"), EColumnSortMode::Descending);
+	CellActors.bIsDirty = true;
 }
 
 FWorldPartitionStats UHLODPreviewTool::Generate(UWorld* InWorld)
@@ -575,61 +1701,53 @@ FWorldPartitionStats UHLODPreviewTool::Generate(UWorld* InWorld)
 				ActorStats.ActorGuid = Actor.ActorGuid;
 			}
 		}
+		TArray<float> CellRadii, CellDistances, CellScreenSizes;
+		CellRadii.SetNumUninitialized(GridStats.Cells.Num());
+		CellDistances.Init(GridStats.LoadingRange, GridStats.Cells.Num());
+		CellScreenSizes.SetNumUninitialized(GridStats.Cells.Num());
+		for (int32 CellIndex = 0; CellIndex < GridStats.Cells.Num(); CellIndex++) {
+			CellRadii[CellIndex] = GridStats.Cells[CellIndex].Bounds.GetExtent().Size();
+		}
+		ProceduralLODMetrics::CalcScreenSizes(Projection.GetScreenMultiple(), CellRadii, CellDistances, CellScreenSizes);
+		for (int32 CellIndex = 0; CellIndex < GridStats.Cells.Num(); CellIndex++) {
+			GridStats.Cells[CellIndex].ScreenSizeAtLoadingRange = CellScreenSizes[CellIndex];
+		}
 	}
 
 	UWorldPartition * WorldPartition = InWorld->GetWorldPartition();
 	UWorldPartition::FGenerateStreamingParams StreamingParams = UWorldPartition::FGenerateStreamingParams();
 	UWorldPartition::FGenerateStreamingContext Context;
 	WorldPartition->GenerateStreaming(StreamingParams, Context);
-	WorldPartition->RuntimeHash->ForEachStreamingCells([&Stats](const UWorldPartitionRuntimeCell* Cell) {
-		FWorldPartitionGridStats* GridStats = Stats.Grids.FindByPredicate([Cell](const FWorldPartitionGridStats& GridStats) {
-			return GridStats.GridName == Cell->RuntimeCellData->GridName;
-		});
-		if (GridStats == nullptr) {
+	// Built once, a linear search per runtime cell is quadratic on large maps.
+	TMap<FName, TMap<FName, FWorldPartitionCellStats*>> CellsByGrid;
+	for (FWorldPartitionGridStats& GridStats : Stats.Grids) {
+		TMap<FName, FWorldPartitionCellStats*>& Cells = CellsByGrid.FindOrAdd(GridStats.GridName);
+		Cells.Reserve(GridStats.Cells.Num());
+		for (FWorldPartitionCellStats& CellStats : GridStats.Cells) {
+			Cells.Add(CellStats.CellPackage, &CellStats);
+		}
+	}
+	WorldPartition->RuntimeHash->ForEachStreamingCells([&CellsByGrid](const UWorldPartitionRuntimeCell* Cell) {
+		const TMap<FName, FWorldPartitionCellStats*>* Cells = CellsByGrid.Find(Cell->RuntimeCellData->GridName);
+		if (Cells == nullptr) {
 			return true;
 		}
-		FWorldPartitionCellStats* CellStats = GridStats->Cells.FindByPredicate([Cell, GridStats](const FWorldPartitionCellStats& CellStats) {
-			return CellStats.CellPackage == Cell->GetName();
-		});
-		if (CellStats == nullptr) {
+		FWorldPartitionCellStats* const* CellStatsPtr = Cells->Find(Cell->GetFName());
+		if (CellStatsPtr == nullptr) {
 			return true;
 		}
+		FWorldPartitionCellStats* CellStats = *CellStatsPtr;
 		CellStats->CellName = *Cell->GetDebugName();
 		CellStats->HierarchicalLevel = Cell->RuntimeCellData->HierarchicalLevel;
 		CellStats->Priority = Cell->RuntimeCellData->Priority;
-		for (auto& ActorStats: CellStats->Actors) {
-			AActor* Actor = Cast<AActor>(ActorStats.Path.TryLoad());
-			TArray<UActorComponent*> ActorCompoents;
-			TSet<UTexture*> CellUsedTextures;
-			Actor->GetComponents(ActorCompoents, true);
-			for (auto ActorComp : ActorCompoents) {
-				CellStats->ComponentCount.FindOrAdd(ActorComp->GetClass()->GetName())++;
-				if(auto SMC = Cast<UStaticMeshComponent>(ActorComp)){
-					UStaticMesh* Mesh = SMC->GetStaticMesh();
-					ActorStats.DrawCallCount += Mesh->GetNumSections(0);
-					if (auto ISMC = Cast<UInstancedStaticMeshComponent>(SMC)) {
-						ActorStats.TriangleCount += Mesh->GetNumTriangles(0) * ISMC->GetInstanceCount();
-					}
-					else {
-						ActorStats.TriangleCount += Mesh->GetNumTriangles(0);
-					}
-					for (UMaterialInterface* Material : SMC->GetMaterials()) {
-						if (Material) {
-							TArray<UTexture*> MaterialTextures;
-							Material->GetUsedTextures(MaterialTextures, EMaterialQualityLevel::Num, true, ERHIFeatureLevel::Num, true);
-							CellUsedTextures.Append(MaterialTextures);
-						}
-					}
-				}
-			}
-			CellStats->DrawCallCount += ActorStats.DrawCallCount;
-			CellStats->TriangleCount += ActorStats.TriangleCount;
-			CellStats->UsedTextures.Append(CellUsedTextures.Array());
-		}
 		UE_LOG(LogTemp, Warning, TEXT("%s"), *Cell->GetDebugName());
 		return true;
 	});
 
+	GatherActorStats(WorldPartition, Stats);
+	AccumulateHLODStats(Stats);
+	AccumulateTextureStats(Stats, TexturePlatforms);
+
 	//URuntimeHashExternalStreamingObjectBase* ExternalStreamingObject = WorldPartition->FlushStreamingToExternalStreamingObject();
 	//ExternalStreamingObject->ForEachStreamingCells([](const UWorldPartitionRuntimeCell& Cell){
 	//	UE_LOG(LogTemp, Warning, TEXT("%s"), *Cell.GetDebugName());
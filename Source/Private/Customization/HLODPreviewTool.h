@@ -1,14 +1,27 @@
 #pragma once
 
 #include "ProceduralContentProcessor.h"
+#include "ProceduralLODMetrics.h"
 #include "HLODPreviewTool.generated.h"
 
 class SHLODOutliner;
+class SHLODBudgetGraph;
 
 struct FWorldPartitionTextureStats {
 	FString Path;
-	int MemorySize;
+	/** Estimated from the dimensions and pixel format of the platform data when loaded, of the asset registry tags otherwise, including the mip chain. */
+	int64 MemorySize;
 	FIntPoint TextureSize;
+	FString Format;
+	FName LODGroup;
+	/** Full mip chain after the LOD group bias and size clamp of every device profile in TexturePlatforms. */
+	TMap<FName, int64> PlatformMemorySize;
+};
+
+/** Memory of a set of unique textures, the sum over the set and not over the cells. */
+struct FWorldPartitionTextureMemory {
+	int64 Total = 0;
+	TMap<FName, int64> Platforms;
 };
 
 struct FWorldPartitionActorStats {
@@ -18,6 +31,8 @@ struct FWorldPartitionActorStats {
 	FName Package;
 	FString Label;
 	FGuid ActorGuid;
+	/** Actors an HLOD actor stands in for, in whichever grid they stream, empty on any other actor. */
+	TArray<FGuid> SourceActors;
 
 	int DrawCallCount;
 	int TriangleCount;
@@ -28,6 +43,8 @@ struct FWorldPartitionHlodStats {
 	int Triangles;
 	int TextureCount;
 	int DrawCalls;
+	/** Triangles of the source actors the HLOD actors of this cell stand in for. */
+	int SourceTriangles;
 };
 
 struct FWorldPartitionCellStats{
@@ -40,11 +57,19 @@ struct FWorldPartitionCellStats{
 	TArray<FName> DataLayers;
 	TArray<FWorldPartitionActorStats> Actors;
 	FWorldPartitionHlodStats HLOD;
+	/** Screen size of the cell bounds seen from the grid loading range, what pops in when the cell streams. */
+	float ScreenSizeAtLoadingRange;
 
 	int DrawCallCount;
 	int TriangleCount;
 	TMap<FString, int> ComponentCount;
 	TArray<FSoftObjectPath> UsedTextures;
+
+	FWorldPartitionTextureMemory TextureMemory;
+	/** Textures of this cell and every cell of its level within the grid loading range of its center. */
+	FWorldPartitionTextureMemory LoadingRangeTextureMemory;
+	/** What this cell adds on top of the cells within loading range when it loads last. */
+	FWorldPartitionTextureMemory IncrementalTextureMemory;
 };
 
 struct FWorldPartitionGridStats{
@@ -53,19 +78,112 @@ struct FWorldPartitionGridStats{
 	int32 CellSize;
 	int32 LoadingRange;
 	TArray<FWorldPartitionCellStats> Cells;
+	int32 NumTextures;
+	FWorldPartitionTextureMemory TextureMemory;
+
+	double GetLevelCellSize(int32 InLevel) const
+	{
+		return (double)FMath::Max(CellSize, 1) * (1 << FMath::Clamp(InLevel, 0, 20));
+	}
+
+	/**
+	 * Calls InFunc with every InCellSize square InBounds overlaps. Where the runtime grid starts is not part of the stats,
+	 * so cells are bucketed under every square they touch, never under the one their center falls into.
+	 */
+	static void ForEachCellCoord(const FBox2D& InBounds, double InCellSize, TFunctionRef<void(const FIntPoint&)> InFunc)
+	{
+		const FIntPoint Min(FMath::FloorToInt(InBounds.Min.X / InCellSize), FMath::FloorToInt(InBounds.Min.Y / InCellSize));
+		const FIntPoint Max(FMath::FloorToInt(InBounds.Max.X / InCellSize), FMath::FloorToInt(InBounds.Max.Y / InCellSize));
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++) {
+			for (int32 X = Min.X; X <= Max.X; X++) {
+				InFunc(FIntPoint(X, Y));
+			}
+		}
+	}
 };
 
 struct FWorldPartitionStats{
 	TArray<FWorldPartitionGridStats> Grids;
 	int TotalTriangles;
+	TMap<FSoftObjectPath, FWorldPartitionTextureStats> Textures;
+	int32 NumCellsFromCache = 0;
+	int32 NumActorsFromRegistry = 0;
+	int32 NumActorsLoaded = 0;
 };
 
 UCLASS(EditInlineNew, CollapseCategories, config = ProceduralContentProcessor, defaultconfig, Category = "WorldPartition", meta = (DisplayName = "HLOD Preview Tool"))
 class PROCEDURALCONTENTPROCESSOR_API UHLODPreviewTool: public UProceduralWorldProcessor {
 	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, Config)
+	FProceduralProjectionSettings Projection;
+
+	/** Loads the actors whose instance counts are not known to the asset registry, e.g. foliage and ISM actors. */
+	UPROPERTY(EditAnywhere, Config)
+	bool bLoadUnresolvedActors = true;
+
+	/** Fallback loads are released and garbage collected after every batch of this many actors. */
+	UPROPERTY(EditAnywhere, Config, meta = (EditCondition = "bLoadUnresolvedActors", ClampMin = 1))
+	int32 LoadBatchSize = 64;
+
+	/** Length of the hot cell list next to the heatmap. */
+	UPROPERTY(EditAnywhere, Config, meta = (ClampMin = 1))
+	int32 HotCellCount = 20;
+
+	/** Device profiles to estimate resident texture memory for, e.g. Windows or Android_High. */
+	UPROPERTY(EditAnywhere, Config)
+	TArray<FString> TexturePlatforms;
+
+	/** Actor with a spline component, the path SimulatePath follows. */
+	UPROPERTY(EditAnywhere)
+	TSoftObjectPtr<AActor> SimulationSpline;
+
+	/** Recorded camera locations, one X,Y,Z line each, used when no spline is set. */
+	UPROPERTY(EditAnywhere, Config, meta = (FilePathFilter = "csv"))
+	FFilePath SimulationCameraPath;
+
+	UPROPERTY(EditAnywhere, Config, meta = (ClampMin = 1, Units = "cm"))
+	float SimulationSampleSpacing = 500.0f;
+
+	UPROPERTY(EditAnywhere, Config)
+	int64 TriangleBudget = 5000000;
+
+	UPROPERTY(EditAnywhere, Config)
+	int32 DrawCallBudget = 5000;
+
+	UPROPERTY(EditAnywhere, Config, meta = (Units = "Megabytes"))
+	int32 TextureMemoryBudget = 1024;
+
+	/** JSON or CSV file ExportStats writes. */
+	UPROPERTY(EditAnywhere, Config, meta = (FilePathFilter = "Stats (*.json, *.csv)|*.json;*.csv"))
+	FFilePath StatsExportPath;
+
+	/** Export of an earlier build DiffStats compares the current cells against. */
+	UPROPERTY(EditAnywhere, Config, meta = (FilePathFilter = "Stats (*.json, *.csv)|*.json;*.csv"))
+	FFilePath StatsBaselinePath;
+
+	/** Actors of the cell last clicked on the heatmap. */
+	UPROPERTY(EditAnywhere, Transient)
+	FProceduralObjectMatrix CellActors;
+
+	FWorldPartitionStats Generate(UWorld* InWorld);
 protected:
+	/** Replays streaming along the spline or camera path and plots the loaded totals against the budgets. */
+	UFUNCTION(CallInEditor)
+	void SimulatePath();
+
+	UFUNCTION(CallInEditor)
+	void ExportStats();
+
+	/** Logs the cells that grew the most since the baseline export. */
+	UFUNCTION(CallInEditor)
+	void DiffStats();
+
 	virtual TSharedPtr<SWidget> BuildWidget() override;
-	FWorldPartitionStats Generate(UWorld* InWorld);
+	void GatherActorStats(UWorldPartition* InWorldPartition, FWorldPartitionStats& InOutStats);
+	void ShowCellActors(const FWorldPartitionCellStats& InCell);
 private:
 	TSharedPtr<SHLODOutliner> HLODOutliner;
+	TSharedPtr<SHLODBudgetGraph> BudgetGraph;
+	TSharedPtr<FWorldPartitionStats> Stats;
 };
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "HLODStatsExport.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace
+{
+	constexpr int32 StatsExportVersion = 1;
+
+	struct FMetric
+	{
+		const TCHAR* Name;
+		int64 FHLODStatsExport::FCell::* Value;
+	};
+	const FMetric Metrics[] = {
+		{ TEXT("Triangles"), &FHLODStatsExport::FCell::Triangles },
+		{ TEXT("DrawCalls"), &FHLODStatsExport::FCell::DrawCalls },
+		{ TEXT("TextureMemory"), &FHLODStatsExport::FCell::TextureMemory },
+	};
+
+	bool IsCsv(const FString& InFilename)
+	{
+		return FPaths::GetExtension(InFilename).Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+	}
+}
+
+TArray<FHLODStatsExport::FCell> FHLODStatsExport::Flatten(const FWorldPartitionStats& InStats)
+{
+	TArray<FCell> Cells;
+	for (const FWorldPartitionGridStats& GridStats : InStats.Grids) {
+		for (const FWorldPartitionCellStats& CellStats : GridStats.Cells) {
+			FCell& Cell = Cells.AddDefaulted_GetRef();
+			Cell.Grid = GridStats.GridName.ToString();
+			Cell.Package = CellStats.CellPackage.ToString();
+			// Debug names are free text, nothing in them may break a CSV row.
+			Cell.Name = CellStats.CellName.ToString().Replace(TEXT(","), TEXT(" "));
+			Cell.Level = CellStats.HierarchicalLevel;
+			Cell.Actors = CellStats.Actors.Num();
+			Cell.Triangles = CellStats.TriangleCount;
+			Cell.DrawCalls = CellStats.DrawCallCount;
+			Cell.TextureMemory = CellStats.TextureMemory.Total;
+			Cell.IncrementalTextureMemory = CellStats.IncrementalTextureMemory.Total;
+		}
+	}
+	Cells.Sort([](const FCell& Lhs, const FCell& Rhs) {
+		const int32 GridOrder = Lhs.Grid.Compare(Rhs.Grid);
+		return GridOrder != 0 ? GridOrder < 0 : Lhs.Package.Compare(Rhs.Package) < 0;
+	});
+	return Cells;
+}
+
+bool FHLODStatsExport::Write(const FString& InFilename, const FWorldPartitionStats& InStats)
+{
+	const TArray<FCell> Cells = Flatten(InStats);
+	if (IsCsv(InFilename)) {
+		TArray<FString> Lines;
+		Lines.Reserve(Cells.Num() + 1);
+		Lines.Add(TEXT("Grid,Package,Name,Level,Actors,Triangles,DrawCalls,TextureMemory,IncrementalTextureMemory"));
+		for (const FCell& Cell : Cells) {
+			Lines.Add(FString::Printf(TEXT("%s,%s,%s,%d,%d,%lld,%lld,%lld,%lld"), *Cell.Grid, *Cell.Package, *Cell.Name, Cell.Level, Cell.Actors,
+				Cell.Triangles, Cell.DrawCalls, Cell.TextureMemory, Cell.IncrementalTextureMemory));
+		}
+		return FFileHelper::SaveStringArrayToFile(Lines, *InFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	}
+
+	// Cells are sorted by grid already, every grid is one contiguous run.
+	TArray<TPair<FString, TArray<TSharedPtr<FJsonValue>>>> GridCells;
+	for (const FCell& Cell : Cells) {
+		if (GridCells.IsEmpty() || GridCells.Last().Key != Cell.Grid) {
+			GridCells.Add({ Cell.Grid, {} });
+		}
+		TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+		Entry->SetStringField(TEXT("Package"), Cell.Package);
+		Entry->SetStringField(TEXT("Name"), Cell.Name);
+		Entry->SetNumberField(TEXT("Level"), Cell.Level);
+		Entry->SetNumberField(TEXT("Actors"), Cell.Actors);
+		Entry->SetNumberField(TEXT("Triangles"), Cell.Triangles);
+		Entry->SetNumberField(TEXT("DrawCalls"), Cell.DrawCalls);
+		Entry->SetNumberField(TEXT("TextureMemory"), Cell.TextureMemory);
+		Entry->SetNumberField(TEXT("IncrementalTextureMemory"), Cell.IncrementalTextureMemory);
+		GridCells.Last().Value.Add(MakeShared<FJsonValueObject>(Entry));
+	}
+	TArray<TSharedPtr<FJsonValue>> Grids;
+	for (const auto& Pair : GridCells) {
+		const FWorldPartitionGridStats* GridStats = InStats.Grids.FindByPredicate([&Pair](const FWorldPartitionGridStats& InGrid) {
+			return InGrid.GridName.ToString() == Pair.Key;
+		});
+		TSharedRef<FJsonObject> Grid = MakeShared<FJsonObject>();
+		Grid->SetStringField(TEXT("Name"), Pair.Key);
+		Grid->SetNumberField(TEXT("CellSize"), GridStats->CellSize);
+		Grid->SetNumberField(TEXT("LoadingRange"), GridStats->LoadingRange);
+		Grid->SetNumberField(TEXT("NumTextures"), GridStats->NumTextures);
+		Grid->SetNumberField(TEXT("TextureMemory"), GridStats->TextureMemory.Total);
+		Grid->SetArrayField(TEXT("Cells"), Pair.Value);
+		Grids.Add(MakeShared<FJsonValueObject>(Grid));
+	}
+	TSharedRef<FJsonObject> Export = MakeShared<FJsonObject>();
+	Export->SetNumberField(TEXT("Version"), StatsExportVersion);
+	Export->SetArrayField(TEXT("Grids"), Grids);
+
+	// One value per line, a changed cell shows up as a few changed lines in any text diff.
+	FString Json;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+	FJsonSerializer::Serialize(Export, Writer);
+	return FFileHelper::SaveStringToFile(Json, *InFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+bool FHLODStatsExport::Read(const FString& InFilename, TArray<FCell>& OutCells)
+{
+	OutCells.Reset();
+	if (IsCsv(InFilename)) {
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *InFilename))
+			return false;
+		for (int32 Index = 1; Index < Lines.Num(); Index++) {
+			TArray<FString> Values;
+			if (Lines[Index].ParseIntoArray(Values, TEXT(","), false) < 9)
+				continue;
+			FCell& Cell = OutCells.AddDefaulted_GetRef();
+			Cell.Grid = Values[0];
+			Cell.Package = Values[1];
+			Cell.Name = Values[2];
+			Cell.Level = FCString::Atoi(*Values[3]);
+			Cell.Actors = FCString::Atoi(*Values[4]);
+			Cell.Triangles = FCString::Atoi64(*Values[5]);
+			Cell.DrawCalls = FCString::Atoi64(*Values[6]);
+			Cell.TextureMemory = FCString::Atoi64(*Values[7]);
+			Cell.IncrementalTextureMemory = FCString::Atoi64(*Values[8]);
+		}
+		return true;
+	}
+
+	FString Json;
+	TSharedPtr<FJsonObject> Export;
+	if (!FFileHelper::LoadFileToString(Json, *InFilename) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Export) || !Export.IsValid())
+		return false;
+	const TArray<TSharedPtr<FJsonValue>>* Grids = nullptr;
+	if (!Export->TryGetArrayField(TEXT("Grids"), Grids))
+		return false;
+	for (const TSharedPtr<FJsonValue>& GridValue : *Grids) {
+		const TSharedPtr<FJsonObject> Grid = GridValue->AsObject();
+		const TArray<TSharedPtr<FJsonValue>>* Cells = nullptr;
+		if (!Grid.IsValid() || !Grid->TryGetArrayField(TEXT("Cells"), Cells))
+			continue;
+		const FString GridName = Grid->GetStringField(TEXT("Name"));
+		for (const TSharedPtr<FJsonValue>& CellValue : *Cells) {
+			const TSharedPtr<FJsonObject> Entry = CellValue->AsObject();
+			if (!Entry.IsValid())
+				continue;
+			FCell& Cell = OutCells.AddDefaulted_GetRef();
+			Cell.Grid = GridName;
+			Cell.Package = Entry->GetStringField(TEXT("Package"));
+			Cell.Name = Entry->GetStringField(TEXT("Name"));
+			Cell.Level = (int32)Entry->GetNumberField(TEXT("Level"));
+			Cell.Actors = (int32)Entry->GetNumberField(TEXT("Actors"));
+			Cell.Triangles = (int64)Entry->GetNumberField(TEXT("Triangles"));
+			Cell.DrawCalls = (int64)Entry->GetNumberField(TEXT("DrawCalls"));
+			Cell.TextureMemory = (int64)Entry->GetNumberField(TEXT("TextureMemory"));
+			Cell.IncrementalTextureMemory = (int64)Entry->GetNumberField(TEXT("IncrementalTextureMemory"));
+		}
+	}
+	return true;
+}
+
+TArray<FHLODStatsExport::FRegression> FHLODStatsExport::Diff(TConstArrayView<FCell> InBase, TConstArrayView<FCell> InCurrent, int32 InCount)
+{
+	TMap<TPair<FString, FString>, const FCell*> BaseCells;
+	BaseCells.Reserve(InBase.Num());
+	for (const FCell& Cell : InBase) {
+		BaseCells.Add({ Cell.Grid, Cell.Package }, &Cell);
+	}
+	TArray<FRegression> Regressions;
+	for (const FMetric& Metric : Metrics) {
+		TArray<FRegression> MetricRegressions;
+		for (const FCell& Cell : InCurrent) {
+			const FCell* const* BaseCell = BaseCells.Find({ Cell.Grid, Cell.Package });
+			const int64 Base = BaseCell ? (*BaseCell)->*Metric.Value : 0;
+			if (Cell.*Metric.Value > Base) {
+				MetricRegressions.Add({ Metric.Name, Cell.Grid, Cell.Package, Base, Cell.*Metric.Value });
+			}
+		}
+		MetricRegressions.Sort([](const FRegression& Lhs, const FRegression& Rhs) {
+			return Lhs.Current - Lhs.Base > Rhs.Current - Rhs.Base;
+		});
+		if (InCount > 0 && MetricRegressions.Num() > InCount) {
+			MetricRegressions.SetNum(InCount);
+		}
+		Regressions.Append(MoveTemp(MetricRegressions));
+	}
+	return Regressions;
+}
+
+bool FHLODStatsExport::WriteDiffCsv(const FString& InFilename, TConstArrayView<FRegression> InRegressions)
+{
+	TArray<FString> Lines;
+	Lines.Add(TEXT("Metric,Grid,Package,Base,Current,Delta,DeltaPercent"));
+	for (const FRegression& Regression : InRegressions) {
+		Lines.Add(FString::Printf(TEXT("%s,%s,%s,%lld,%lld,%lld,%s"), *Regression.Metric, *Regression.Grid, *Regression.Package, Regression.Base, Regression.Current,
+			Regression.Current - Regression.Base, Regression.Base > 0 ? *FString::Printf(TEXT("%.1f"), ((double)Regression.Current / Regression.Base - 1.0) * 100.0) : TEXT("")));
+	}
+	return FFileHelper::SaveStringArrayToFile(Lines, *InFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+TArray<FString> FHLODStatsExport::CheckBudgets(TConstArrayView<FCell> InCells, int64 InTriangleBudget, int64 InDrawCallBudget, int64 InTextureMemoryBudget)
+{
+	const int64 Budgets[] = { InTriangleBudget, InDrawCallBudget, InTextureMemoryBudget };
+	TArray<FString> Overruns;
+	for (const FCell& Cell : InCells) {
+		for (int32 Index = 0; Index < UE_ARRAY_COUNT(Metrics); Index++) {
+			if (Budgets[Index] > 0 && Cell.*Metrics[Index].Value > Budgets[Index]) {
+				Overruns.Add(FString::Printf(TEXT("%s %s: %s %lld, budget %lld"), *Cell.Grid, *Cell.Package, Metrics[Index].Name, Cell.*Metrics[Index].Value, Budgets[Index]));
+			}
+		}
+	}
+	return Overruns;
+}
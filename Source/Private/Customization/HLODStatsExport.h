@@ -0,0 +1,51 @@
+#pragma once
+
+#include "HLODPreviewTool.h"
+
+/**
+ * Stable text exports of FWorldPartitionStats to compare the cell costs of two builds.
+ * Grids and cells are sorted by name, so exports of unchanged content are identical and line diffs stay small.
+ */
+class FHLODStatsExport
+{
+public:
+	struct FCell
+	{
+		FString Grid;
+		FString Package;
+		FString Name;
+		int32 Level = 0;
+		int32 Actors = 0;
+		int64 Triangles = 0;
+		int64 DrawCalls = 0;
+		int64 TextureMemory = 0;
+		int64 IncrementalTextureMemory = 0;
+	};
+
+	struct FRegression
+	{
+		FString Metric;
+		FString Grid;
+		FString Package;
+		/** Zero for cells missing from the base export. */
+		int64 Base = 0;
+		int64 Current = 0;
+	};
+
+	static TArray<FCell> Flatten(const FWorldPartitionStats& InStats);
+
+	/** Writes JSON, or Grid,Package,Name,Level,Actors,Triangles,DrawCalls,TextureMemory,IncrementalTextureMemory rows when InFilename ends with .csv. */
+	static bool Write(const FString& InFilename, const FWorldPartitionStats& InStats);
+
+	/** Reads the cells of a file written by Write. */
+	static bool Read(const FString& InFilename, TArray<FCell>& OutCells);
+
+	/** The InCount cells with the largest growth of triangles, draw calls and texture memory each, largest first. */
+	static TArray<FRegression> Diff(TConstArrayView<FCell> InBase, TConstArrayView<FCell> InCurrent, int32 InCount);
+
+	/** Metric,Grid,Package,Base,Current,Delta,DeltaPercent */
+	static bool WriteDiffCsv(const FString& InFilename, TConstArrayView<FRegression> InRegressions);
+
+	/** Cells above any of the budgets, budgets at or below zero are ignored. */
+	static TArray<FString> CheckBudgets(TConstArrayView<FCell> InCells, int64 InTriangleBudget, int64 InDrawCallBudget, int64 InTextureMemoryBudget);
+};
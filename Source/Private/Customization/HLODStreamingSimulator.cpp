@@ -0,0 +1,153 @@
+#include "HLODStreamingSimulator.h"
+#include "Async/ParallelFor.h"
+
+FHLODStreamingSimulator::FHLODStreamingSimulator(const FWorldPartitionStats& InStats)
+{
+	TMap<FSoftObjectPath, int32> TextureIndices;
+	TMap<FGuid, int32> ActorCells;
+	for (const FWorldPartitionGridStats& GridStats : InStats.Grids) {
+		FGrid& Grid = Grids.AddDefaulted_GetRef();
+		Grid.LoadingRange = GridStats.LoadingRange;
+		for (const FWorldPartitionCellStats& CellStats : GridStats.Cells) {
+			const int32 CellIndex = Cells.Num();
+			FCell& Cell = Cells.AddDefaulted_GetRef();
+			Cell.Bounds = FBox2D(FVector2D(CellStats.Bounds.Min), FVector2D(CellStats.Bounds.Max));
+			Cell.Triangles = CellStats.TriangleCount;
+			Cell.DrawCalls = CellStats.DrawCallCount;
+			for (const FWorldPartitionActorStats& ActorStats : CellStats.Actors) {
+				ActorCells.Add(ActorStats.ActorGuid, CellIndex);
+			}
+			Cell.Textures.Reserve(CellStats.UsedTextures.Num());
+			for (const FSoftObjectPath& Texture : CellStats.UsedTextures) {
+				int32* TextureIndex = TextureIndices.Find(Texture);
+				if (TextureIndex == nullptr) {
+					const FWorldPartitionTextureStats* TextureStats = InStats.Textures.Find(Texture);
+					TextureIndex = &TextureIndices.Add(Texture, TextureMemory.Add(TextureStats ? TextureStats->MemorySize : 0));
+				}
+				Cell.Textures.Add(*TextureIndex);
+			}
+			if (!CellStats.bIsSpatiallyLoaded) {
+				AlwaysLoadedCells.Add(CellIndex);
+				continue;
+			}
+			const int32 Level = FMath::Clamp(CellStats.HierarchicalLevel, 0, 20);
+			if (Grid.Levels.Num() <= Level) {
+				const int32 FirstLevel = Grid.Levels.Num();
+				Grid.Levels.SetNum(Level + 1);
+				for (int32 Index = FirstLevel; Index <= Level; Index++) {
+					Grid.Levels[Index].CellSize = GridStats.GetLevelCellSize(Index);
+				}
+			}
+			FLevel& GridLevel = Grid.Levels[Level];
+			FWorldPartitionGridStats::ForEachCellCoord(Cell.Bounds, GridLevel.CellSize, [&GridLevel, CellIndex](const FIntPoint& InCoord) {
+				GridLevel.Cells.Add(InCoord, CellIndex);
+			});
+		}
+	}
+
+	// Source actors may stream in any grid, HLOD actors are linked once every actor is located.
+	int32 CellIndex = 0;
+	for (const FWorldPartitionGridStats& GridStats : InStats.Grids) {
+		for (const FWorldPartitionCellStats& CellStats : GridStats.Cells) {
+			FCell& Cell = Cells[CellIndex++];
+			for (const FWorldPartitionActorStats& ActorStats : CellStats.Actors) {
+				TArray<int32> SourceCells;
+				for (const FGuid& SourceActor : ActorStats.SourceActors) {
+					if (const int32* SourceCell = ActorCells.Find(SourceActor)) {
+						SourceCells.AddUnique(*SourceCell);
+					}
+				}
+				// HLOD actors without any known source render whenever their cell is loaded.
+				if (SourceCells.IsEmpty())
+					continue;
+				Cell.Triangles -= ActorStats.TriangleCount;
+				Cell.DrawCalls -= ActorStats.DrawCallCount;
+				Cell.HLODActors.Add(HLODActors.Add({ ActorStats.TriangleCount, ActorStats.DrawCallCount, MoveTemp(SourceCells) }));
+			}
+		}
+	}
+}
+
+TArray<FHLODStreamingSample> FHLODStreamingSimulator::Simulate(TConstArrayView<FVector> InPath) const
+{
+	TArray<FHLODStreamingSample> Samples;
+	Samples.SetNum(InPath.Num());
+	for (int32 Index = 0; Index < InPath.Num(); Index++) {
+		Samples[Index].Location = InPath[Index];
+		Samples[Index].Distance = Index > 0 ? Samples[Index - 1].Distance + FVector::Dist(InPath[Index - 1], InPath[Index]) : 0.0;
+	}
+
+	ParallelFor(Samples.Num(), [this, &Samples](int32 SampleIndex) {
+		FHLODStreamingSample& Sample = Samples[SampleIndex];
+		TBitArray<> Loaded(false, Cells.Num());
+		TArray<int32> LoadedCells;
+		auto Load = [&Loaded, &LoadedCells](int32 InCell) {
+			if (!Loaded[InCell]) {
+				Loaded[InCell] = true;
+				LoadedCells.Add(InCell);
+			}
+		};
+		for (int32 CellIndex : AlwaysLoadedCells) {
+			Load(CellIndex);
+		}
+		const FVector2D Location(Sample.Location);
+		for (const FGrid& Grid : Grids) {
+			const double RangeSquared = Grid.LoadingRange * Grid.LoadingRange;
+			const FBox2D Range(Location - Grid.LoadingRange, Location + Grid.LoadingRange);
+			for (const FLevel& Level : Grid.Levels) {
+				FWorldPartitionGridStats::ForEachCellCoord(Range, Level.CellSize, [&](const FIntPoint& InCoord) {
+					for (auto It = Level.Cells.CreateConstKeyIterator(InCoord); It; ++It) {
+						if (Cells[It.Value()].Bounds.ComputeSquaredDistanceToPoint(Location) <= RangeSquared) {
+							Load(It.Value());
+						}
+					}
+				});
+			}
+		}
+
+		TBitArray<> UsedTextures(false, TextureMemory.Num());
+		for (int32 CellIndex : LoadedCells) {
+			const FCell& Cell = Cells[CellIndex];
+			Sample.Triangles += Cell.Triangles;
+			Sample.DrawCalls += Cell.DrawCalls;
+			for (int32 HLODActorIndex : Cell.HLODActors) {
+				const FHLODActor& HLODActor = HLODActors[HLODActorIndex];
+				if (!HLODActor.SourceCells.ContainsByPredicate([&Loaded](int32 InSourceCell) { return Loaded[InSourceCell]; })) {
+					Sample.Triangles += HLODActor.Triangles;
+					Sample.DrawCalls += HLODActor.DrawCalls;
+				}
+			}
+			for (int32 Texture : Cell.Textures) {
+				if (!UsedTextures[Texture]) {
+					UsedTextures[Texture] = true;
+					Sample.TextureMemory += TextureMemory[Texture];
+				}
+			}
+		}
+		Sample.LoadedCells = LoadedCells.Num();
+	});
+	return Samples;
+}
+
+TArray<FVector> FHLODStreamingSimulator::ResamplePath(TConstArrayView<FVector> InPoints, double InSpacing)
+{
+	TArray<FVector> Path;
+	if (InPoints.IsEmpty())
+		return Path;
+	InSpacing = FMath::Max(InSpacing, 1.0);
+	Path.Add(InPoints[0]);
+	double Carry = 0.0;
+	for (int32 Index = 1; Index < InPoints.Num(); Index++) {
+		const FVector Start = InPoints[Index - 1];
+		const double Length = FVector::Dist(Start, InPoints[Index]);
+		double Distance = InSpacing - Carry;
+		for (; Distance <= Length; Distance += InSpacing) {
+			Path.Add(FMath::Lerp(Start, InPoints[Index], Distance / Length));
+		}
+		Carry = Length - (Distance - InSpacing);
+	}
+	if (!Path.Last().Equals(InPoints.Last())) {
+		Path.Add(InPoints.Last());
+	}
+	return Path;
+}
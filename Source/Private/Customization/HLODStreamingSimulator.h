@@ -0,0 +1,63 @@
+#pragma once
+
+#include "HLODPreviewTool.h"
+
+struct FHLODStreamingSample
+{
+	FVector Location = FVector::ZeroVector;
+	/** Path length up to this sample. */
+	double Distance = 0.0;
+	int32 LoadedCells = 0;
+	int64 Triangles = 0;
+	int64 DrawCalls = 0;
+	/** Unique textures of the loaded cells. */
+	int64 TextureMemory = 0;
+};
+
+/**
+ * Replays the streaming of the cell statistics along a path, nothing but the statistics is touched so samples run in parallel.
+ * A cell is loaded while its bounds are within the loading range of its grid, non spatially loaded cells always are.
+ * Everything loaded counts towards memory, HLOD actors only render while none of the cells holding their source actors are loaded.
+ */
+class FHLODStreamingSimulator
+{
+public:
+	explicit FHLODStreamingSimulator(const FWorldPartitionStats& InStats);
+
+	TArray<FHLODStreamingSample> Simulate(TConstArrayView<FVector> InPath) const;
+
+	/** Points every InSpacing along InPoints, the first and the last point are always kept. */
+	static TArray<FVector> ResamplePath(TConstArrayView<FVector> InPoints, double InSpacing);
+private:
+	struct FCell
+	{
+		FBox2D Bounds;
+		/** Everything but the HLOD actors linked to their sources. */
+		int64 Triangles = 0;
+		int64 DrawCalls = 0;
+		TArray<int32> HLODActors;
+		TArray<int32> Textures;
+	};
+	struct FHLODActor
+	{
+		int64 Triangles = 0;
+		int64 DrawCalls = 0;
+		TArray<int32> SourceCells;
+	};
+	struct FLevel
+	{
+		double CellSize = 1.0;
+		/** Grid square to the cells overlapping it, several with data layers. */
+		TMultiMap<FIntPoint, int32> Cells;
+	};
+	struct FGrid
+	{
+		double LoadingRange = 0.0;
+		TArray<FLevel> Levels;
+	};
+	TArray<FCell> Cells;
+	TArray<FHLODActor> HLODActors;
+	TArray<FGrid> Grids;
+	TArray<int32> AlwaysLoadedCells;
+	TArray<int64> TextureMemory;
+};
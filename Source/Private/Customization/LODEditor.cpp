@@ -128,11 +128,7 @@ void ULODEditor::GenerateLODForSelected()
 		bStaticMeshIsEdited = true;
 	}
 		
-	const float FOV = 90.0f;
-	const float FOVRad = FOV * (float)UE_PI / 360.0f;
-	const FMatrix ProjectionMatrix = FPerspectiveMatrix(FOVRad, 1920, 1080, 0.01f);
-		
-	const float ScreenMultiple = FMath::Max(0.5f * ProjectionMatrix.M[0][0], 0.5f * ProjectionMatrix.M[1][1]);
+	const float ScreenMultiple = Projection.GetScreenMultiple();
 	const float SphereRadius = StaticMesh->GetBounds().SphereRadius;
 		
 	StaticMesh->Modify();
@@ -141,12 +137,7 @@ void ULODEditor::GenerateLODForSelected()
 	StaticMesh->GetSourceModel(0).ScreenSize = SelectedStaticMeshLODChain[0].ScreenSize;
 
 	if (SelectedStaticMeshLODChain[0].bUseDistance) {
-		if (SelectedStaticMeshLODChain[0].Distance == 0) {
-			StaticMesh->GetSourceModel(0).ScreenSize = 2.0f;
-		}
-		else {
-			StaticMesh->GetSourceModel(0).ScreenSize = 2.0f * ScreenMultiple * SphereRadius / FMath::Max(1.0f, SelectedStaticMeshLODChain[0].Distance);
-		}
+		StaticMesh->GetSourceModel(0).ScreenSize = ProceduralLODMetrics::CalcScreenSize(ScreenMultiple, SphereRadius, SelectedStaticMeshLODChain[0].Distance);
 	}
 		
 	int32 LODIndex = 1;
@@ -154,12 +145,7 @@ void ULODEditor::GenerateLODForSelected()
 		const FStaticMeshChainNode& ChainNode = SelectedStaticMeshLODChain[LODIndex];
 		float ScreenSize = SelectedStaticMeshLODChain[LODIndex].ScreenSize;
 		if (SelectedStaticMeshLODChain[LODIndex].bUseDistance) {
-			if (SelectedStaticMeshLODChain[LODIndex].Distance == 0) {
-				ScreenSize = 2.0f;
-			}
-			else {
-				ScreenSize = 2.0f * ScreenMultiple * SphereRadius / FMath::Max(1.0f, SelectedStaticMeshLODChain[LODIndex].Distance);
-			}
+			ScreenSize = ProceduralLODMetrics::CalcScreenSize(ScreenMultiple, SphereRadius, SelectedStaticMeshLODChain[LODIndex].Distance);
 		}
 		if (ChainNode.Type == EStaticMeshLODGenerateType::Reduce) {
 			FStaticMeshSourceModel& SrcModel = StaticMesh->AddSourceModel();
@@ -310,7 +296,7 @@ void ULODEditor::RefreshLODChain()
 		SelectedStaticMeshLODChain[i].BuildSettings = StaticMesh->GetSourceModel(i).BuildSettings;
 		SelectedStaticMeshLODChain[i].ReductionSettings = StaticMesh->GetSourceModel(i).ReductionSettings;
 		SelectedStaticMeshLODChain[i].ScreenSize = StaticMesh->GetSourceModel(i).ScreenSize.GetValue();
-		SelectedStaticMeshLODChain[i].Distance = UProceduralContentProcessorLibrary::GetLodDistance(StaticMesh, i);
+		SelectedStaticMeshLODChain[i].Distance = i == 0 ? 0.0f : ProceduralLODMetrics::CalcLodDistance(Projection.GetScreenMultiple(), StaticMesh->GetBounds().SphereRadius, UProceduralContentProcessorLibrary::GetLodScreenSize(StaticMesh, i));
 	}
 }
 
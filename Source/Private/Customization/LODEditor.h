@@ -2,6 +2,7 @@
 
 #include "ProceduralContentProcessor.h"
 #include "Engine/StaticMeshActor.h"
+#include "ProceduralLODMetrics.h"
 #include "LODEditor.generated.h"
 
 UENUM(BlueprintType)
@@ -80,6 +81,9 @@ public:
 	UPROPERTY(EditAnywhere, Config)
 	FMeshImposterSettings ImposterSettings;
 
+	UPROPERTY(EditAnywhere, Config)
+	FProceduralProjectionSettings Projection;
+
 	UPROPERTY(Transient)
 	TObjectPtr<AActor> BP_Generate_ImposterSpritesActor;
 
@@ -0,0 +1,73 @@
+#include "ProceduralPipelineProcessor.h"
+
+void UProceduralPipelineProcessor::SetPipeline(UProceduralProcessorPipeline* InPipeline, FName InResumeFromNode)
+{
+	Pipeline = InPipeline;
+	ResumeFromNode = InResumeFromNode;
+	ClearCache();
+}
+
+void UProceduralPipelineProcessor::Run()
+{
+	Execute(NAME_None);
+}
+
+void UProceduralPipelineProcessor::Resume()
+{
+	Execute(ResumeFromNode);
+}
+
+void UProceduralPipelineProcessor::ClearCache()
+{
+	Cache.Reset();
+	NodeReport.Reset();
+}
+
+void UProceduralPipelineProcessor::Deactivate()
+{
+	Super::Deactivate();
+	// Cached actor sets would otherwise keep the world alive after a map change.
+	ClearCache();
+}
+
+void UProceduralPipelineProcessor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	const FName PropertyName = (PropertyChangedEvent.Property != NULL) ? PropertyChangedEvent.Property->GetFName() : NAME_None;
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UProceduralPipelineProcessor, Pipeline)) {
+		ClearCache();
+	}
+}
+
+TArray<FName> UProceduralPipelineProcessor::GetNodeNames() const
+{
+	if (UProceduralProcessorPipeline* PipelineAsset = Pipeline.LoadSynchronous()) {
+		return PipelineAsset->GetNodeNames();
+	}
+	return {};
+}
+
+void UProceduralPipelineProcessor::Execute(FName InFromNode)
+{
+	bLastRunSucceeded = false;
+	UProceduralProcessorPipeline* PipelineAsset = Pipeline.LoadSynchronous();
+	if (PipelineAsset == nullptr) {
+		UE_LOG(LogTemp, Error, TEXT("%s: no pipeline selected"), *GetClass()->GetName());
+		return;
+	}
+	bLastRunSucceeded = PipelineAsset->Execute(GetWorld(), InFromNode, Cache);
+
+	NodeReport.Reset();
+	for (const FProceduralPipelineNode& Node : PipelineAsset->Nodes) {
+		const FProceduralPipelineNodeResult* Result = Cache.Find(Node.Name);
+		if (Result == nullptr) {
+			NodeReport.Add(FString::Printf(TEXT("%s: not run"), *Node.Name.ToString()));
+			continue;
+		}
+		FString Outputs;
+		for (const auto& Output : Result->Outputs) {
+			Outputs += FString::Printf(TEXT(" %s=%d"), *Output.Key.ToString(), Output.Value.Num());
+		}
+		NodeReport.Add(FString::Printf(TEXT("%s: %s %.2fs%s"), *Node.Name.ToString(), Result->bSucceeded ? TEXT("succeeded") : TEXT("failed"), Result->Seconds, *Outputs));
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ProceduralContentProcessor.h"
+#include "ProceduralProcessorPipeline.h"
+#include "ProceduralPipelineProcessor.generated.h"
+
+UCLASS(EditInlineNew, CollapseCategories, config = ProceduralContentProcessor, defaultconfig, Category = "Pipeline")
+class PROCEDURALCONTENTPROCESSOR_API UProceduralPipelineProcessor: public UProceduralWorldProcessor {
+	GENERATED_BODY()
+public:
+	void SetPipeline(UProceduralProcessorPipeline* InPipeline, FName InResumeFromNode = NAME_None);
+
+	bool LastRunSucceeded() const { return bLastRunSucceeded; }
+
+	/** Runs every node of the pipeline. */
+	UFUNCTION(BlueprintCallable, CallInEditor)
+	void Run();
+
+	/** Reruns ResumeFromNode and everything downstream of it, upstream nodes reuse their cached results. */
+	UFUNCTION(BlueprintCallable, CallInEditor)
+	void Resume();
+
+	UFUNCTION(BlueprintCallable, CallInEditor)
+	void ClearCache();
+protected:
+	virtual void Deactivate() override;
+
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+
+	UFUNCTION()
+	TArray<FName> GetNodeNames() const;
+
+	void Execute(FName InFromNode);
+
+	UPROPERTY(EditAnywhere, Config)
+	TSoftObjectPtr<UProceduralProcessorPipeline> Pipeline;
+
+	UPROPERTY(EditAnywhere, meta = (GetOptions = "GetNodeNames"))
+	FName ResumeFromNode;
+
+	UPROPERTY(VisibleAnywhere)
+	TArray<FString> NodeReport;
+
+	UPROPERTY(Transient)
+	TMap<FName, FProceduralPipelineNodeResult> Cache;
+
+	bool bLastRunSucceeded = false;
+};
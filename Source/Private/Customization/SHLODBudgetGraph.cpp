@@ -0,0 +1,147 @@
+#include "SHLODBudgetGraph.h"
+#include "Algo/BinarySearch.h"
+#include "Fonts/FontMeasure.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/DrawElements.h"
+
+#define LOCTEXT_NAMESPACE "ProceduralContentProcessor"
+
+void SHLODBudgetGraph::Construct(const FArguments& InArgs)
+{
+}
+
+void SHLODBudgetGraph::SetSamples(TArray<FHLODStreamingSample> InSamples, int64 InTriangleBudget, int64 InDrawCallBudget, int64 InTextureMemoryBudget)
+{
+	Samples = MoveTemp(InSamples);
+	Series.Reset();
+	Series.Add({ LOCTEXT("BudgetTriangles", "Triangles"), FLinearColor(0.1f, 0.6f, 1.0f), (double)InTriangleBudget, false, {} });
+	Series.Add({ LOCTEXT("BudgetDrawCalls", "Draw Calls"), FLinearColor(1.0f, 0.6f, 0.1f), (double)InDrawCallBudget, false, {} });
+	Series.Add({ LOCTEXT("BudgetTextureMemory", "Texture Memory"), FLinearColor(0.7f, 0.3f, 1.0f), (double)InTextureMemoryBudget, true, {} });
+	for (const FHLODStreamingSample& Sample : Samples) {
+		Series[0].Values.Add(Sample.Triangles);
+		Series[1].Values.Add(Sample.DrawCalls);
+		Series[2].Values.Add(Sample.TextureMemory);
+	}
+	Peaks.Reset();
+	MaxRatio = 1.25;
+	for (const FSeries& Item : Series) {
+		Peaks.Add(Item.Values.IsEmpty() ? 0.0 : FMath::Max(Item.Values));
+	}
+	for (int32 Index = 0; Index < Series.Num(); Index++) {
+		MaxRatio = FMath::Max(MaxRatio, GetRatio(Index, Peaks[Index]) * 1.05);
+	}
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+double SHLODBudgetGraph::GetRatio(int32 InSeries, double InValue) const
+{
+	if (Series[InSeries].Budget > 0.0)
+		return InValue / Series[InSeries].Budget;
+	return Peaks[InSeries] > 0.0 ? InValue / Peaks[InSeries] : 0.0;
+}
+
+FString SHLODBudgetGraph::FormatValue(const FSeries& InSeries, double InValue) const
+{
+	return InSeries.bIsMemory ? FText::AsMemory((uint64)InValue).ToString() : FText::AsNumber((int64)InValue).ToString();
+}
+
+int32 SHLODBudgetGraph::FindSampleAt(const FGeometry& InGeometry, float InLocalX) const
+{
+	if (Samples.IsEmpty())
+		return INDEX_NONE;
+	const double TotalDistance = FMath::Max(Samples.Last().Distance, UE_KINDA_SMALL_NUMBER);
+	const double Distance = FMath::Clamp(InLocalX / InGeometry.GetLocalSize().X, 0.0f, 1.0f) * TotalDistance;
+	const int32 Index = Algo::LowerBoundBy(Samples, Distance, &FHLODStreamingSample::Distance);
+	return FMath::Min(Index, Samples.Num() - 1);
+}
+
+int32 SHLODBudgetGraph::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const FSlateBrush* WhiteBrush = FAppStyle::GetBrush("WhiteBrush");
+	const FSlateFontInfo Font = FAppStyle::GetFontStyle("SmallFont");
+	const FVector2D Size = AllottedGeometry.GetLocalSize();
+	FSlateDrawElement::MakeBox(OutDrawElements, LayerId, AllottedGeometry.ToPaintGeometry(), WhiteBrush, ESlateDrawEffect::None, FLinearColor(0.01f, 0.01f, 0.01f));
+	if (Samples.IsEmpty() || Size.X <= 1.0f) {
+		FSlateDrawElement::MakeText(OutDrawElements, LayerId + 1, AllottedGeometry.ToPaintGeometry(Size, FSlateLayoutTransform(FVector2D(4.0, 4.0))),
+			LOCTEXT("NoSimulation", "Simulate a path to see its streaming budget"), Font, ESlateDrawEffect::None, FLinearColor::Gray);
+		return LayerId + 1;
+	}
+
+	auto ToY = [&Size, this](double InRatio) {
+		return Size.Y * (1.0 - InRatio / MaxRatio);
+	};
+	const TArray<FVector2D> BudgetLine = { FVector2D(0.0, ToY(1.0)), FVector2D(Size.X, ToY(1.0)) };
+	FSlateDrawElement::MakeLines(OutDrawElements, LayerId + 1, AllottedGeometry.ToPaintGeometry(), BudgetLine, ESlateDrawEffect::None, FLinearColor(0.8f, 0.1f, 0.1f), true, 1.0f);
+
+	// One point per pixel column keeps the column maximum, so no peak gets lost on long paths.
+	const double TotalDistance = FMath::Max(Samples.Last().Distance, UE_KINDA_SMALL_NUMBER);
+	const int32 Columns = FMath::Max(1, FMath::FloorToInt(Size.X));
+	for (int32 SeriesIndex = 0; SeriesIndex < Series.Num(); SeriesIndex++) {
+		const FSeries& Item = Series[SeriesIndex];
+		TArray<FVector2D> Points;
+		Points.Reserve(FMath::Min(Samples.Num(), Columns + 1));
+		int32 CurrentColumn = INDEX_NONE;
+		for (int32 Index = 0; Index < Samples.Num(); Index++) {
+			const int32 Column = FMath::Min(FMath::FloorToInt(Samples[Index].Distance / TotalDistance * Columns), Columns - 1);
+			const double Y = ToY(GetRatio(SeriesIndex, Item.Values[Index]));
+			if (Column == CurrentColumn) {
+				Points.Last().Y = FMath::Min(Points.Last().Y, Y);
+				continue;
+			}
+			CurrentColumn = Column;
+			Points.Add(FVector2D(Column, Y));
+		}
+		if (Points.Num() == 1) {
+			Points.Add(FVector2D(Size.X, Points[0].Y));
+		}
+		FSlateDrawElement::MakeLines(OutDrawElements, LayerId + 2, AllottedGeometry.ToPaintGeometry(), Points, ESlateDrawEffect::None, Item.Color, true, 1.5f);
+	}
+
+	const TSharedRef<FSlateFontMeasure> FontMeasure = FSlateApplication::Get().GetRenderer()->GetFontMeasureService();
+	const int32 HoverSample = HoverX.IsSet() ? FindSampleAt(AllottedGeometry, HoverX.GetValue()) : INDEX_NONE;
+	if (HoverSample != INDEX_NONE) {
+		const float X = Samples[HoverSample].Distance / TotalDistance * Size.X;
+		const TArray<FVector2D> HoverLine = { FVector2D(X, 0.0), FVector2D(X, Size.Y) };
+		FSlateDrawElement::MakeLines(OutDrawElements, LayerId + 1, AllottedGeometry.ToPaintGeometry(), HoverLine, ESlateDrawEffect::None, FLinearColor(0.5f, 0.5f, 0.5f), true, 1.0f);
+	}
+	FVector2D TextPosition(4.0, 4.0);
+	for (int32 Index = 0; Index < Series.Num(); Index++) {
+		const FSeries& Item = Series[Index];
+		FString Text = HoverSample != INDEX_NONE
+			? FString::Printf(TEXT("%s: %s"), *Item.Name.ToString(), *FormatValue(Item, Item.Values[HoverSample]))
+			: FString::Printf(TEXT("%s peak: %s"), *Item.Name.ToString(), *FormatValue(Item, Peaks[Index]));
+		if (Item.Budget > 0.0) {
+			Text += FString::Printf(TEXT(" / %s"), *FormatValue(Item, Item.Budget));
+		}
+		FSlateDrawElement::MakeText(OutDrawElements, LayerId + 3, AllottedGeometry.ToPaintGeometry(Size, FSlateLayoutTransform(TextPosition)), Text, Font, ESlateDrawEffect::None,
+			Item.Budget > 0.0 && Peaks[Index] > Item.Budget ? FLinearColor(1.0f, 0.3f, 0.3f) : Item.Color);
+		TextPosition.Y += FontMeasure->GetMaxCharacterHeight(Font);
+	}
+	if (HoverSample != INDEX_NONE) {
+		const FHLODStreamingSample& Sample = Samples[HoverSample];
+		const FString Text = FString::Printf(TEXT("%.0f m, %d cells"), Sample.Distance / 100.0, Sample.LoadedCells);
+		FSlateDrawElement::MakeText(OutDrawElements, LayerId + 3, AllottedGeometry.ToPaintGeometry(Size, FSlateLayoutTransform(TextPosition)), Text, Font, ESlateDrawEffect::None, FLinearColor::White);
+	}
+	return LayerId + 3;
+}
+
+FVector2D SHLODBudgetGraph::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D(256.0, 120.0);
+}
+
+FReply SHLODBudgetGraph::OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	HoverX = MyGeometry.AbsoluteToLocal(MouseEvent.GetScreenSpacePosition()).X;
+	Invalidate(EInvalidateWidgetReason::Paint);
+	return FReply::Unhandled();
+}
+
+void SHLODBudgetGraph::OnMouseLeave(const FPointerEvent& MouseEvent)
+{
+	SLeafWidget::OnMouseLeave(MouseEvent);
+	HoverX.Reset();
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+#undef LOCTEXT_NAMESPACE
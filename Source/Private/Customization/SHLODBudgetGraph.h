@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Widgets/SLeafWidget.h"
+#include "HLODStreamingSimulator.h"
+
+/** Plots triangles, draw calls and texture memory of a simulated path as a fraction of their budgets. */
+class SHLODBudgetGraph : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SHLODBudgetGraph) {}
+	SLATE_END_ARGS()
+
+	struct FSeries
+	{
+		FText Name;
+		FLinearColor Color;
+		/** Values at or below zero plot against the series peak instead. */
+		double Budget = 0.0;
+		bool bIsMemory = false;
+		TArray<double> Values;
+	};
+public:
+	void Construct(const FArguments& InArgs);
+	void SetSamples(TArray<FHLODStreamingSample> InSamples, int64 InTriangleBudget, int64 InDrawCallBudget, int64 InTextureMemoryBudget);
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+	virtual FReply OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual void OnMouseLeave(const FPointerEvent& MouseEvent) override;
+protected:
+	double GetRatio(int32 InSeries, double InValue) const;
+	FString FormatValue(const FSeries& InSeries, double InValue) const;
+	int32 FindSampleAt(const FGeometry& InGeometry, float InLocalX) const;
+private:
+	TArray<FHLODStreamingSample> Samples;
+	TArray<FSeries> Series;
+	TArray<double> Peaks;
+	double MaxRatio = 1.25;
+	TOptional<float> HoverX;
+};
@@ -0,0 +1,268 @@
+#include "SHLODCellCanvas.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/DrawElements.h"
+
+namespace
+{
+	const int32 MaxGridSize = 256;
+	const float ClickDragThreshold = 4.0f;
+	const FVector2D MinLabelSize(40.0, 14.0);
+}
+
+void SHLODCellCanvas::Construct(const FArguments& InArgs)
+{
+	OnCellClicked = InArgs._OnCellClicked;
+	OnGetCellMenu = InArgs._OnGetCellMenu;
+	OnGetObserverView = InArgs._OnGetObserverView;
+}
+
+void SHLODCellCanvas::SetCells(TArray<FCell> InCells, const FBox2D& InBounds)
+{
+	Cells = MoveTemp(InCells);
+	Bounds = InBounds;
+	if (!Bounds.bIsValid) {
+		for (const FCell& Cell : Cells) {
+			Bounds += Cell.Bounds;
+		}
+	}
+	BuildGrid();
+	ResetView();
+}
+
+void SHLODCellCanvas::SetCellColor(int32 InIndex, const FLinearColor& InColor)
+{
+	if (Cells.IsValidIndex(InIndex)) {
+		Cells[InIndex].Color = InColor;
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void SHLODCellCanvas::ResetView()
+{
+	Zoom = 1.0;
+	PanOffset = FVector2D::ZeroVector;
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SHLODCellCanvas::BuildGrid()
+{
+	Grid.Reset();
+	GridSize = FIntPoint::ZeroValue;
+	if (Cells.IsEmpty() || !Bounds.bIsValid)
+		return;
+	// About one cell per bucket, so a click tests a handful of cells whatever the map size is.
+	const int32 Dimension = FMath::Clamp(FMath::CeilToInt(FMath::Sqrt((float)Cells.Num())), 1, MaxGridSize);
+	GridSize = FIntPoint(Dimension, Dimension);
+	const FVector2D Extent = Bounds.GetSize();
+	GridBucketSize = FVector2D(FMath::Max(Extent.X / Dimension, UE_KINDA_SMALL_NUMBER), FMath::Max(Extent.Y / Dimension, UE_KINDA_SMALL_NUMBER));
+	Grid.SetNum(GridSize.X * GridSize.Y);
+	for (int32 Index = 0; Index < Cells.Num(); Index++) {
+		const FIntPoint Min = GetGridCoord(Cells[Index].Bounds.Min);
+		const FIntPoint Max = GetGridCoord(Cells[Index].Bounds.Max);
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++) {
+			for (int32 X = Min.X; X <= Max.X; X++) {
+				Grid[Y * GridSize.X + X].Add(Index);
+			}
+		}
+	}
+}
+
+FIntPoint SHLODCellCanvas::GetGridCoord(const FVector2D& InWorld) const
+{
+	const FVector2D Coord = (InWorld - Bounds.Min) / GridBucketSize;
+	return FIntPoint(
+		FMath::Clamp(FMath::FloorToInt(Coord.X), 0, GridSize.X - 1),
+		FMath::Clamp(FMath::FloorToInt(Coord.Y), 0, GridSize.Y - 1)
+	);
+}
+
+double SHLODCellCanvas::GetScale(const FGeometry& InGeometry) const
+{
+	const FVector2D Extent = Bounds.GetSize();
+	const FVector2D Size = InGeometry.GetLocalSize();
+	if (Extent.X <= 0.0 || Extent.Y <= 0.0)
+		return Zoom;
+	return FMath::Min(Size.X / Extent.X, Size.Y / Extent.Y) * Zoom;
+}
+
+FVector2D SHLODCellCanvas::WorldToLocal(const FGeometry& InGeometry, const FVector2D& InWorld) const
+{
+	return (InWorld - Bounds.GetCenter()) * GetScale(InGeometry) + InGeometry.GetLocalSize() * 0.5 + PanOffset;
+}
+
+FVector2D SHLODCellCanvas::LocalToWorld(const FGeometry& InGeometry, const FVector2D& InLocal) const
+{
+	return (InLocal - PanOffset - InGeometry.GetLocalSize() * 0.5) / GetScale(InGeometry) + Bounds.GetCenter();
+}
+
+int32 SHLODCellCanvas::FindCellAt(const FGeometry& InGeometry, const FVector2D& InLocalPosition) const
+{
+	if (Grid.IsEmpty())
+		return INDEX_NONE;
+	const FVector2D World = LocalToWorld(InGeometry, InLocalPosition);
+	if (!Bounds.IsInside(World))
+		return INDEX_NONE;
+	const FIntPoint Coord = GetGridCoord(World);
+	for (int32 Index : Grid[Coord.Y * GridSize.X + Coord.X]) {
+		if (Cells[Index].Bounds.IsInside(World))
+			return Index;
+	}
+	return INDEX_NONE;
+}
+
+int32 SHLODCellCanvas::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const FSlateBrush* WhiteBrush = FAppStyle::GetBrush("WhiteBrush");
+	FSlateDrawElement::MakeBox(OutDrawElements, LayerId, AllottedGeometry.ToPaintGeometry(), WhiteBrush, ESlateDrawEffect::None, FLinearColor(0.01f, 0.01f, 0.01f));
+	if (Grid.IsEmpty())
+		return LayerId;
+
+	// Only the buckets under the visible region are walked, cells spanning several buckets are painted once.
+	const FSlateRect VisibleRect = MyCullingRect.IntersectionWith(FSlateRect(AllottedGeometry.GetAbsolutePosition(), AllottedGeometry.GetAbsolutePosition() + AllottedGeometry.GetAbsoluteSize()));
+	const FVector2D VisibleMin = LocalToWorld(AllottedGeometry, AllottedGeometry.AbsoluteToLocal(VisibleRect.GetTopLeft()));
+	const FVector2D VisibleMax = LocalToWorld(AllottedGeometry, AllottedGeometry.AbsoluteToLocal(VisibleRect.GetBottomRight()));
+	const FBox2D VisibleBounds(FVector2D::Min(VisibleMin, VisibleMax), FVector2D::Max(VisibleMin, VisibleMax));
+	if (!VisibleBounds.Intersect(Bounds))
+		return LayerId;
+
+	const FSlateFontInfo Font = FAppStyle::GetFontStyle("SmallFont");
+	const double Scale = GetScale(AllottedGeometry);
+	const FIntPoint GridMin = GetGridCoord(VisibleBounds.Min);
+	const FIntPoint GridMax = GetGridCoord(VisibleBounds.Max);
+	TBitArray<> Painted(false, Cells.Num());
+	for (int32 Y = GridMin.Y; Y <= GridMax.Y; Y++) {
+		for (int32 X = GridMin.X; X <= GridMax.X; X++) {
+			for (int32 Index : Grid[Y * GridSize.X + X]) {
+				if (Painted[Index])
+					continue;
+				Painted[Index] = true;
+				const FCell& Cell = Cells[Index];
+				if (!Cell.Bounds.Intersect(VisibleBounds))
+					continue;
+				const FVector2D CellPosition = WorldToLocal(AllottedGeometry, Cell.Bounds.Min);
+				FVector2D CellSize = Cell.Bounds.GetSize() * Scale;
+				// Keep a gap between neighbours once they are large enough to tell apart.
+				const double Inset = CellSize.GetMin() > 4.0 ? 1.0 : 0.0;
+				CellSize = FVector2D::Max(CellSize - Inset * 2.0, FVector2D::UnitVector);
+				FSlateDrawElement::MakeBox(
+					OutDrawElements,
+					LayerId + 1,
+					AllottedGeometry.ToPaintGeometry(CellSize, FSlateLayoutTransform(CellPosition + Inset)),
+					WhiteBrush,
+					ESlateDrawEffect::None,
+					Cell.Color
+				);
+				if (!Cell.Label.IsEmpty() && CellSize.X >= MinLabelSize.X && CellSize.Y >= MinLabelSize.Y) {
+					FSlateDrawElement::MakeText(
+						OutDrawElements,
+						LayerId + 2,
+						AllottedGeometry.ToPaintGeometry(CellSize, FSlateLayoutTransform(CellPosition + Inset + 2.0)),
+						Cell.Label,
+						Font,
+						ESlateDrawEffect::None,
+						FLinearColor::White
+					);
+				}
+			}
+		}
+	}
+	int32 NewLayerId = LayerId + 2;
+
+	FVector ObserverPosition;
+	FRotator ObserverRotation;
+	if (OnGetObserverView.IsBound() && OnGetObserverView.Execute(ObserverPosition, ObserverRotation)) {
+		const FSlateBrush* CameraImage = FAppStyle::GetBrush(TEXT("WorldPartition.SimulationViewPosition"));
+		const FVector2D ShadowSize(2, 2);
+		const FVector2D LocalLocation = WorldToLocal(AllottedGeometry, FVector2D(ObserverPosition));
+		FSlateDrawElement::MakeRotatedBox(
+			OutDrawElements,
+			++NewLayerId,
+			AllottedGeometry.ToPaintGeometry(CameraImage->ImageSize + ShadowSize, FSlateLayoutTransform(LocalLocation - (CameraImage->ImageSize + ShadowSize) * 0.5f)),
+			CameraImage,
+			ESlateDrawEffect::None,
+			FMath::DegreesToRadians(ObserverRotation.Yaw),
+			(CameraImage->ImageSize + ShadowSize) * 0.5f,
+			FSlateDrawElement::RelativeToElement,
+			FLinearColor::Black
+		);
+		FSlateDrawElement::MakeRotatedBox(
+			OutDrawElements,
+			++NewLayerId,
+			AllottedGeometry.ToPaintGeometry(CameraImage->ImageSize, FSlateLayoutTransform(LocalLocation - CameraImage->ImageSize * 0.5f)),
+			CameraImage,
+			ESlateDrawEffect::None,
+			FMath::DegreesToRadians(ObserverRotation.Yaw),
+			CameraImage->ImageSize * 0.5f,
+			FSlateDrawElement::RelativeToElement,
+			FLinearColor::White
+		);
+	}
+	return NewLayerId;
+}
+
+FVector2D SHLODCellCanvas::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D(256.0, 256.0);
+}
+
+FReply SHLODCellCanvas::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (MouseEvent.GetEffectingButton() != EKeys::LeftMouseButton && MouseEvent.GetEffectingButton() != EKeys::RightMouseButton)
+		return FReply::Unhandled();
+	bIsPanning = true;
+	PanDistance = 0.0f;
+	return FReply::Handled().CaptureMouse(SharedThis(this));
+}
+
+FReply SHLODCellCanvas::OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (!bIsPanning)
+		return FReply::Unhandled();
+	bIsPanning = false;
+	if (PanDistance < ClickDragThreshold) {
+		const int32 Index = FindCellAt(MyGeometry, MyGeometry.AbsoluteToLocal(MouseEvent.GetScreenSpacePosition()));
+		if (Index != INDEX_NONE) {
+			if (MouseEvent.GetEffectingButton() == EKeys::LeftMouseButton) {
+				OnCellClicked.ExecuteIfBound(Index);
+			}
+			else if (OnGetCellMenu.IsBound()) {
+				if (TSharedPtr<SWidget> Menu = OnGetCellMenu.Execute(Index)) {
+					FWidgetPath WidgetPath = MouseEvent.GetEventPath() != nullptr ? *MouseEvent.GetEventPath() : FWidgetPath();
+					FSlateApplication::Get().PushMenu(SharedThis(this), WidgetPath, Menu.ToSharedRef(), MouseEvent.GetScreenSpacePosition(), FPopupTransitionEffect::ContextMenu);
+				}
+			}
+		}
+	}
+	return FReply::Handled().ReleaseMouseCapture();
+}
+
+FReply SHLODCellCanvas::OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (!bIsPanning || !HasMouseCapture())
+		return FReply::Unhandled();
+	const FVector2D Delta = MouseEvent.GetCursorDelta() / MyGeometry.Scale;
+	PanDistance += Delta.Size();
+	if (PanDistance >= ClickDragThreshold) {
+		PanOffset += Delta;
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+	return FReply::Handled();
+}
+
+FReply SHLODCellCanvas::OnMouseWheel(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	// Zoom around the cursor, the world position under it stays put.
+	const FVector2D CursorPosition = MyGeometry.AbsoluteToLocal(MouseEvent.GetScreenSpacePosition());
+	const FVector2D WorldPosition = LocalToWorld(MyGeometry, CursorPosition);
+	Zoom = FMath::Clamp(Zoom * FMath::Pow(1.2, MouseEvent.GetWheelDelta()), 0.1, 1000.0);
+	PanOffset += CursorPosition - WorldToLocal(MyGeometry, WorldPosition);
+	Invalidate(EInvalidateWidgetReason::Paint);
+	return FReply::Handled();
+}
+
+FCursorReply SHLODCellCanvas::OnCursorQuery(const FGeometry& MyGeometry, const FPointerEvent& CursorEvent) const
+{
+	if (bIsPanning && PanDistance >= ClickDragThreshold)
+		return FCursorReply::Cursor(EMouseCursor::GrabHandClosed);
+	return FCursorReply::Unhandled();
+}
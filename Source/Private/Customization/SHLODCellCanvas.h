@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Widgets/SLeafWidget.h"
+
+/**
+ * Paints world partition cells as boxes, only the ones inside the visible region are drawn.
+ * Drag to pan, scroll to zoom, clicks are resolved through a uniform grid over the cell bounds.
+ */
+class SHLODCellCanvas : public SLeafWidget
+{
+public:
+	DECLARE_DELEGATE_OneParam(FOnCellClicked, int32);
+	DECLARE_DELEGATE_RetVal_OneParam(TSharedPtr<SWidget>, FOnGetCellMenu, int32);
+	DECLARE_DELEGATE_RetVal_TwoParams(bool, FOnGetObserverView, FVector&, FRotator&);
+
+	SLATE_BEGIN_ARGS(SHLODCellCanvas) {}
+		SLATE_EVENT(FOnCellClicked, OnCellClicked)
+		SLATE_EVENT(FOnGetCellMenu, OnGetCellMenu)
+		SLATE_EVENT(FOnGetObserverView, OnGetObserverView)
+	SLATE_END_ARGS()
+
+	struct FCell
+	{
+		FBox2D Bounds;
+		FText Label;
+		FLinearColor Color = FLinearColor::Black;
+	};
+public:
+	void Construct(const FArguments& InArgs);
+
+	/** Replaces the cells and resets the view to fit InBounds. */
+	void SetCells(TArray<FCell> InCells, const FBox2D& InBounds);
+	void SetCellColor(int32 InIndex, const FLinearColor& InColor);
+	int32 GetNumCells() const { return Cells.Num(); }
+	void ResetView();
+
+	/** Index of the cell under the local widget position, INDEX_NONE if there is none. */
+	int32 FindCellAt(const FGeometry& InGeometry, const FVector2D& InLocalPosition) const;
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+	virtual FReply OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FReply OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FReply OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FReply OnMouseWheel(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FCursorReply OnCursorQuery(const FGeometry& MyGeometry, const FPointerEvent& CursorEvent) const override;
+protected:
+	double GetScale(const FGeometry& InGeometry) const;
+	FVector2D WorldToLocal(const FGeometry& InGeometry, const FVector2D& InWorld) const;
+	FVector2D LocalToWorld(const FGeometry& InGeometry, const FVector2D& InLocal) const;
+	FIntPoint GetGridCoord(const FVector2D& InWorld) const;
+	void BuildGrid();
+private:
+	TArray<FCell> Cells;
+	FBox2D Bounds = FBox2D(ForceInit);
+
+	/** Cell indices per grid bucket, a cell is listed in every bucket its bounds overlap. */
+	TArray<TArray<int32>> Grid;
+	FIntPoint GridSize = FIntPoint::ZeroValue;
+	FVector2D GridBucketSize = FVector2D::UnitVector;
+
+	double Zoom = 1.0;
+	FVector2D PanOffset = FVector2D::ZeroVector;
+	bool bIsPanning = false;
+	float PanDistance = 0.0f;
+
+	FOnCellClicked OnCellClicked;
+	FOnGetCellMenu OnGetCellMenu;
+	FOnGetObserverView OnGetObserverView;
+};
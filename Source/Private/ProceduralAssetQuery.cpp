@@ -0,0 +1,159 @@
+#include "ProceduralContentProcessorLibrary.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	struct FSortKey {
+		double Number = 0.0;
+		FString Text;
+		bool bNumeric = false;
+	};
+
+	int32 CompareStrings(const FString& Lhs, const FString& Rhs, double LhsNumber, double RhsNumber, bool bNumeric)
+	{
+		if (bNumeric) {
+			return LhsNumber < RhsNumber ? -1 : (LhsNumber > RhsNumber ? 1 : 0);
+		}
+		return Lhs.Compare(Rhs, ESearchCase::IgnoreCase);
+	}
+}
+
+bool FProceduralAssetTagPredicate::TryParseNumber(FStringView InString, double& OutNumber)
+{
+	InString.TrimStartAndEndInline();
+	if (InString.IsEmpty())
+		return false;
+	int32 SeparatorIndex = INDEX_NONE;
+	if (InString.FindChar(TEXT('x'), SeparatorIndex) && SeparatorIndex > 0) {
+		double Max = 0.0;
+		for (FStringView Remaining = InString; !Remaining.IsEmpty();) {
+			int32 Index = INDEX_NONE;
+			const FStringView Component = Remaining.FindChar(TEXT('x'), Index) ? Remaining.Left(Index) : Remaining;
+			Remaining = Index == INDEX_NONE ? FStringView() : Remaining.RightChop(Index + 1);
+			double Value = 0.0;
+			if (!TryParseNumber(Component, Value))
+				return false;
+			Max = FMath::Max(Max, Value);
+		}
+		OutNumber = Max;
+		return true;
+	}
+	const FString String(InString);
+	if (!String.IsNumeric())
+		return false;
+	OutNumber = FCString::Atod(*String);
+	return true;
+}
+
+bool FProceduralAssetTagPredicate::Evaluate(const FAssetData& InAsset) const
+{
+	FString TagValue;
+	const bool bHasTag = InAsset.GetTagValue(Tag, TagValue);
+	switch (Op) {
+	case EProceduralAssetTagOp::Exists:
+		return bHasTag;
+	case EProceduralAssetTagOp::NotExists:
+		return !bHasTag;
+	case EProceduralAssetTagOp::Contains:
+		return bHasTag && TagValue.Contains(Value);
+	default:
+		break;
+	}
+	if (!bHasTag)
+		return Op == EProceduralAssetTagOp::NotEqual;
+
+	double TagNumber = 0.0, ValueNumber = 0.0;
+	const bool bNumeric = TryParseNumber(TagValue, TagNumber) && TryParseNumber(Value, ValueNumber);
+	const int32 Result = CompareStrings(TagValue, Value, TagNumber, ValueNumber, bNumeric);
+	switch (Op) {
+	case EProceduralAssetTagOp::Equal:			return Result == 0;
+	case EProceduralAssetTagOp::NotEqual:		return Result != 0;
+	case EProceduralAssetTagOp::Less:			return Result < 0;
+	case EProceduralAssetTagOp::LessEqual:		return Result <= 0;
+	case EProceduralAssetTagOp::Greater:		return Result > 0;
+	case EProceduralAssetTagOp::GreaterEqual:	return Result >= 0;
+	default:									return false;
+	}
+}
+
+TArray<FAssetData> FProceduralAssetQuery::Execute() const
+{
+	FARFilter Filter;
+	Filter.PackagePaths = PackagePaths;
+	Filter.bRecursivePaths = bRecursivePaths;
+	Filter.ClassPaths = ClassPaths;
+	Filter.bRecursiveClasses = bRecursiveClasses;
+	TArray<FAssetData> Assets;
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	if (Filter.IsEmpty()) {
+		AssetRegistry.GetAllAssets(Assets, true);
+	}
+	else {
+		AssetRegistry.GetAssets(Filter, Assets);
+	}
+
+	FProceduralStringMatcher Matcher;
+	const bool bFilterPaths = !IncludeList.IsEmpty() || !ExcludeList.IsEmpty();
+	if (bFilterPaths) {
+		Matcher.Compile(IncludeList.IsEmpty() ? TArray<FString>{ FString() } : IncludeList, ExcludeList);
+	}
+
+	// FAssetData copies are immutable, so the tag lookups and string parsing can run on any thread.
+	TArray<bool> Passed;
+	Passed.SetNumZeroed(Assets.Num());
+	ParallelFor(Assets.Num(), [&](int32 Index) {
+		const FAssetData& Asset = Assets[Index];
+		if (bFilterPaths && !Matcher.Match(Asset.GetObjectPathString()))
+			return;
+		for (const FProceduralAssetTagPredicate& Predicate : Predicates) {
+			if (!Predicate.Evaluate(Asset))
+				return;
+		}
+		Passed[Index] = true;
+	}, Assets.Num() < 1024 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	TArray<FAssetData> Results;
+	for (int32 Index = 0; Index < Assets.Num(); Index++) {
+		if (Passed[Index]) {
+			Results.Add(MoveTemp(Assets[Index]));
+		}
+	}
+
+	if (!SortTag.IsNone()) {
+		TArray<FSortKey> Keys;
+		Keys.SetNum(Results.Num());
+		ParallelFor(Results.Num(), [&](int32 Index) {
+			FSortKey& Key = Keys[Index];
+			Results[Index].GetTagValue(SortTag, Key.Text);
+			Key.bNumeric = FProceduralAssetTagPredicate::TryParseNumber(Key.Text, Key.Number);
+		}, Results.Num() < 1024 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+		TArray<int32> Order;
+		Order.Reserve(Results.Num());
+		for (int32 Index = 0; Index < Results.Num(); Index++) {
+			Order.Add(Index);
+		}
+		Order.StableSort([&](int32 Lhs, int32 Rhs) {
+			const FSortKey& LhsKey = Keys[Lhs];
+			const FSortKey& RhsKey = Keys[Rhs];
+			// Assets without a numeric value always go last.
+			if (LhsKey.bNumeric != RhsKey.bNumeric)
+				return LhsKey.bNumeric;
+			const int32 Result = CompareStrings(LhsKey.Text, RhsKey.Text, LhsKey.Number, RhsKey.Number, LhsKey.bNumeric);
+			return bSortDescending ? Result > 0 : Result < 0;
+		});
+
+		TArray<FAssetData> Sorted;
+		Sorted.Reserve(Results.Num());
+		for (int32 Index : Order) {
+			Sorted.Add(MoveTemp(Results[Index]));
+		}
+		Results = MoveTemp(Sorted);
+	}
+
+	if (MaxResults > 0 && Results.Num() > MaxResults) {
+		Results.SetNum(MaxResults);
+	}
+	return Results;
+}
@@ -0,0 +1,317 @@
+#include "ProceduralAsyncTask.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Misc/SlowTask.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+#define LOCTEXT_NAMESPACE "ProceduralContentProcessor"
+
+namespace
+{
+	TSharedPtr<SNotificationItem> CreateProgressNotification(const FText& InTaskName, TFunction<void()> OnCancel)
+	{
+		if (!FSlateApplication::IsInitialized() || IsRunningCommandlet())
+			return nullptr;
+		FNotificationInfo Info(InTaskName);
+		Info.bFireAndForget = false;
+		Info.bUseThrobber = true;
+		Info.FadeOutDuration = 1.0f;
+		Info.ExpireDuration = 1.0f;
+		if (OnCancel) {
+			Info.ButtonDetails.Add(FNotificationButtonInfo(
+				LOCTEXT("CancelTask", "Cancel"),
+				LOCTEXT("CancelTaskTooltip", "Cancel this task"),
+				FSimpleDelegate::CreateLambda(MoveTemp(OnCancel)),
+				SNotificationItem::ECompletionState::CS_Pending
+			));
+		}
+		TSharedPtr<SNotificationItem> Notification = FSlateNotificationManager::Get().AddNotification(Info);
+		if (Notification.IsValid()) {
+			Notification->SetCompletionState(SNotificationItem::CS_Pending);
+		}
+		return Notification;
+	}
+
+	void CloseProgressNotification(TSharedPtr<SNotificationItem>& InNotification, bool bCancelled)
+	{
+		if (InNotification.IsValid()) {
+			InNotification->SetCompletionState(bCancelled ? SNotificationItem::CS_Fail : SNotificationItem::CS_Success);
+			InNotification->ExpireAndFadeout();
+			InNotification.Reset();
+		}
+	}
+}
+
+TArray<FProceduralTaskScope*> FProceduralTaskScope::ScopeStack;
+
+FProceduralTaskScope::FProceduralTaskScope(const FText& InTaskName, float InAmountOfWork, bool bInCancellable)
+	: TaskName(InTaskName)
+	, AmountOfWork(FMath::Max(InAmountOfWork, UE_SMALL_NUMBER))
+{
+	check(IsInGameThread());
+	if (ScopeStack.IsEmpty()) {
+		bCancelled = MakeShared<std::atomic<bool>>(false);
+		SlowTask = MakeUnique<FSlowTask>(1.0f, TaskName);
+		SlowTask->Initialize();
+		SlowTask->MakeDialog(bInCancellable);
+	}
+	else {
+		bCancelled = ScopeStack.Last()->bCancelled;
+	}
+	ScopeStack.Add(this);
+}
+
+FProceduralTaskScope::~FProceduralTaskScope()
+{
+	ScopeStack.RemoveSingle(this);
+	if (SlowTask.IsValid()) {
+		SlowTask->Destroy();
+	}
+}
+
+void FProceduralTaskScope::EnterProgressFrame(float ExpectedWorkThisFrame, const FText& InText)
+{
+	CompletedWork = FMath::Min(CompletedWork + CurrentFrameWork, AmountOfWork);
+	CurrentFrameWork = ExpectedWorkThisFrame;
+	FrameText = InText;
+	UpdateProgress(false);
+}
+
+bool FProceduralTaskScope::ShouldCancel() const
+{
+	if (!bCancelled.IsValid())
+		return false;
+	if (!*bCancelled && IsInGameThread() && !ScopeStack.IsEmpty() && ScopeStack[0]->SlowTask.IsValid() && ScopeStack[0]->SlowTask->ShouldCancel()) {
+		*bCancelled = true;
+	}
+	return *bCancelled;
+}
+
+FProceduralTaskScope* FProceduralTaskScope::GetCurrent()
+{
+	return ScopeStack.IsEmpty() ? nullptr : ScopeStack.Last();
+}
+
+void FProceduralTaskScope::CancelAll()
+{
+	for (FProceduralTaskScope* Scope : ScopeStack) {
+		*Scope->bCancelled = true;
+	}
+}
+
+float FProceduralTaskScope::GetOverallProgress() const
+{
+	float Progress = 0.0f;
+	float Scale = 1.0f;
+	for (const FProceduralTaskScope* Scope : ScopeStack) {
+		Progress += Scale * Scope->CompletedWork / Scope->AmountOfWork;
+		Scale *= Scope->CurrentFrameWork / Scope->AmountOfWork;
+	}
+	return FMath::Clamp(Progress, 0.0f, 1.0f);
+}
+
+void FProceduralTaskScope::UpdateProgress(bool bForce)
+{
+	if (ScopeStack.IsEmpty() || !ScopeStack[0]->SlowTask.IsValid())
+		return;
+	const double CurrentTime = FPlatformTime::Seconds();
+	FProceduralTaskScope* Root = ScopeStack[0];
+	if (!bForce && CurrentTime - Root->LastUpdateTime < 0.1)
+		return;
+	Root->LastUpdateTime = CurrentTime;
+	// The nested scopes are flattened into the root's single unit of work, the dialog ticks slate modally.
+	Root->SlowTask->CompletedWork = GetOverallProgress();
+	Root->SlowTask->CurrentFrameScope = 0.0f;
+	Root->SlowTask->EnterProgressFrame(0.0f, FrameText.IsEmpty() ? TaskName : FrameText);
+}
+
+TArray<TSharedRef<FProceduralAsyncTaskRunner>> FProceduralAsyncTaskRunner::ActiveRunners;
+
+FProceduralAsyncTaskRunner::FProceduralAsyncTaskRunner(const FText& InTaskName)
+	: TaskName(InTaskName)
+{
+}
+
+TSharedRef<FProceduralAsyncTaskRunner> FProceduralAsyncTaskRunner::Create(const FText& InTaskName)
+{
+	return MakeShareable(new FProceduralAsyncTaskRunner(InTaskName));
+}
+
+FProceduralAsyncTaskRunner::~FProceduralAsyncTaskRunner()
+{
+	bCancelled = true;
+	UE::Tasks::Wait(PendingChunks);
+}
+
+FProceduralAsyncTaskRunner& FProceduralAsyncTaskRunner::ThenAsync(int32 InNum, TFunction<void(int32)> InWork, int32 InChunkSize)
+{
+	check(!IsRunning());
+	Stages.Add({ InNum, FMath::Max(1, InChunkSize), false, MoveTemp(InWork) });
+	return *this;
+}
+
+FProceduralAsyncTaskRunner& FProceduralAsyncTaskRunner::ThenOnGameThread(int32 InNum, TFunction<void(int32)> InWork)
+{
+	check(!IsRunning());
+	Stages.Add({ InNum, 1, true, MoveTemp(InWork) });
+	return *this;
+}
+
+FProceduralAsyncTaskRunner& FProceduralAsyncTaskRunner::OnFinished(TFunction<void(bool)> InCallback)
+{
+	FinishedCallback = MoveTemp(InCallback);
+	return *this;
+}
+
+FProceduralAsyncTaskRunner& FProceduralAsyncTaskRunner::SetGameThreadBudget(float InBudgetMs)
+{
+	GameThreadBudgetMs = FMath::Max(0.1f, InBudgetMs);
+	return *this;
+}
+
+void FProceduralAsyncTaskRunner::Start()
+{
+	check(IsInGameThread() && !IsRunning());
+	ActiveRunners.Add(AsShared());
+	TWeakPtr<FProceduralAsyncTaskRunner> WeakThis = AsShared();
+	Notification = CreateProgressNotification(TaskName, [WeakThis]() {
+		if (TSharedPtr<FProceduralAsyncTaskRunner> Runner = WeakThis.Pin()) {
+			Runner->Cancel();
+		}
+	});
+	LaunchStage();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FProceduralAsyncTaskRunner::Tick));
+}
+
+void FProceduralAsyncTaskRunner::Cancel()
+{
+	bCancelled = true;
+}
+
+void FProceduralAsyncTaskRunner::CancelAll()
+{
+	TArray<TSharedRef<FProceduralAsyncTaskRunner>> Runners = ActiveRunners;
+	for (const TSharedRef<FProceduralAsyncTaskRunner>& Runner : Runners) {
+		Runner->Cancel();
+		Runner->Finish();
+	}
+}
+
+void FProceduralAsyncTaskRunner::LaunchStage()
+{
+	StageIndex++;
+	GameThreadCursor = 0;
+	CompletedItems = 0;
+	PendingChunks.Reset();
+	if (!Stages.IsValidIndex(StageIndex) || bCancelled)
+		return;
+	const FStage& Stage = Stages[StageIndex];
+	if (Stage.bGameThread)
+		return;
+	for (int32 ChunkBegin = 0; ChunkBegin < Stage.Num; ChunkBegin += Stage.ChunkSize) {
+		const int32 ChunkEnd = FMath::Min(ChunkBegin + Stage.ChunkSize, Stage.Num);
+		PendingChunks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, &Stage, ChunkBegin, ChunkEnd]() {
+			for (int32 Index = ChunkBegin; Index < ChunkEnd && !bCancelled; Index++) {
+				Stage.Work(Index);
+				CompletedItems++;
+			}
+		}));
+	}
+}
+
+bool FProceduralAsyncTaskRunner::Tick(float InDeltaTime)
+{
+	while (Stages.IsValidIndex(StageIndex) && !bCancelled) {
+		const FStage& Stage = Stages[StageIndex];
+		if (Stage.bGameThread) {
+			const double EndTime = FPlatformTime::Seconds() + GameThreadBudgetMs / 1000.0;
+			while (GameThreadCursor < Stage.Num && !bCancelled && FPlatformTime::Seconds() < EndTime) {
+				Stage.Work(GameThreadCursor++);
+				CompletedItems++;
+			}
+			if (GameThreadCursor < Stage.Num)
+				break;
+		}
+		else if (PendingChunks.ContainsByPredicate([](const UE::Tasks::FTask& Chunk) { return !Chunk.IsCompleted(); })) {
+			break;
+		}
+		LaunchStage();
+	}
+	if (!Stages.IsValidIndex(StageIndex) || bCancelled) {
+		TickerHandle.Reset();
+		Finish();
+		return false;
+	}
+	UpdateNotification();
+	return true;
+}
+
+void FProceduralAsyncTaskRunner::Finish()
+{
+	TSharedRef<FProceduralAsyncTaskRunner> Self = AsShared();
+	if (!ActiveRunners.Contains(Self))
+		return;
+	UE::Tasks::Wait(PendingChunks);
+	PendingChunks.Reset();
+	if (TickerHandle.IsValid()) {
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	CloseProgressNotification(Notification, bCancelled);
+	ActiveRunners.Remove(Self);
+	if (FinishedCallback) {
+		FinishedCallback(bCancelled);
+	}
+}
+
+void FProceduralAsyncTaskRunner::UpdateNotification()
+{
+	if (!Notification.IsValid() || Stages.IsEmpty() || !Stages.IsValidIndex(StageIndex))
+		return;
+	const int32 StageNum = Stages[StageIndex].Num;
+	const float StageProgress = StageNum > 0 ? (float)CompletedItems / StageNum : 1.0f;
+	const float Progress = (StageIndex + StageProgress) / Stages.Num();
+	Notification->SetText(FText::Format(LOCTEXT("AsyncTaskProgress", "{0} {1}%"), TaskName, FText::AsNumber(FMath::FloorToInt(Progress * 100))));
+}
+
+UProceduralAsyncTaskAction* UProceduralAsyncTaskAction::RunTimeSlicedTask(FText TaskName, int32 Num, float BudgetMs)
+{
+	UProceduralAsyncTaskAction* Action = NewObject<UProceduralAsyncTaskAction>();
+	Action->TaskName = TaskName;
+	Action->Num = Num;
+	Action->BudgetMs = BudgetMs;
+	return Action;
+}
+
+void UProceduralAsyncTaskAction::CancelAllAsyncTasks()
+{
+	FProceduralAsyncTaskRunner::CancelAll();
+}
+
+void UProceduralAsyncTaskAction::Activate()
+{
+	AddToRoot();
+	TWeakObjectPtr<UProceduralAsyncTaskAction> WeakThis = this;
+	TSharedRef<FProceduralAsyncTaskRunner> Runner = FProceduralAsyncTaskRunner::Create(TaskName);
+	Runner->ThenOnGameThread(Num, [WeakThis](int32 Index) {
+		if (WeakThis.IsValid()) {
+			WeakThis->OnStep.Broadcast(Index);
+		}
+	})
+	.SetGameThreadBudget(BudgetMs)
+	.OnFinished([WeakThis](bool bCancelled) {
+		if (UProceduralAsyncTaskAction* Action = WeakThis.Get()) {
+			if (bCancelled) {
+				Action->OnCancelled.Broadcast();
+			}
+			else {
+				Action->OnCompleted.Broadcast();
+			}
+			Action->RemoveFromRoot();
+			Action->SetReadyToDestroy();
+		}
+	});
+	Runner->Start();
+}
+
+#undef LOCTEXT_NAMESPACE
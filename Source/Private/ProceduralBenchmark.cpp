@@ -0,0 +1,344 @@
+#include "ProceduralBenchmark.h"
+#include "ProceduralContentProcessorLibrary.h"
+#include "Customization/FoliagePartitionTool.h"
+#include "Editor.h"
+#include "Engine/Selection.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Misc/FileHelper.h"
+#include "UObject/StrongObjectPtr.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogProceduralBenchmark, Log, All);
+
+namespace
+{
+	const TCHAR* BenchmarkMeshPath = TEXT("/Engine/BasicShapes/Cube.Cube");
+	constexpr double BenchmarkSpacing = 500.0;
+	// Matches the foliage partition tool's default cell size, so generated partitions line up with the ones Toggle creates.
+	constexpr int32 FoliagePartitionCellSize = 25600;
+
+	/** Stands in for the editor world while it lives, the level and the selection the user had open come back afterwards. */
+	struct FBenchmarkWorld
+	{
+		UWorld* World = nullptr;
+		UWorld* PreviousWorld = nullptr;
+		UWorld* PreviousGWorld = nullptr;
+		TArray<TWeakObjectPtr<AActor>> PreviousSelection;
+
+		FBenchmarkWorld(int32 InIndex)
+		{
+			FWorldContext& WorldContext = GEditor->GetEditorWorldContext(true);
+			PreviousWorld = WorldContext.World();
+			PreviousGWorld = GWorld;
+			for (FSelectionIterator It(*GEditor->GetSelectedActors()); It; ++It) {
+				PreviousSelection.Add(Cast<AActor>(*It));
+			}
+			const FName WorldName = MakeUniqueObjectName(GetTransientPackage(), UWorld::StaticClass(), *FString::Printf(TEXT("ProceduralBenchmark_%d"), InIndex));
+			World = UWorld::CreateWorld(EWorldType::Editor, false, WorldName, GetTransientPackage());
+			WorldContext.SetCurrentWorld(World);
+			GWorld = World;
+		}
+
+		~FBenchmarkWorld()
+		{
+			GEditor->SelectNone(false, true, false);
+			GEditor->GetEditorWorldContext(true).SetCurrentWorld(PreviousWorld);
+			GWorld = PreviousGWorld;
+			World->RemoveFromRoot();
+			World->DestroyWorld(false);
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			for (const TWeakObjectPtr<AActor>& Actor : PreviousSelection) {
+				if (Actor.IsValid()) {
+					GEditor->SelectActor(Actor.Get(), true, false, true);
+				}
+			}
+			GEditor->NoteSelectionChange();
+		}
+	};
+
+	/** The inputs of one case in one iteration, everything lives in World. */
+	struct FBenchmarkContext
+	{
+		UWorld* World = nullptr;
+		UStaticMesh* Mesh = nullptr;
+		UFoliagePartitionTool* FoliageTool = nullptr;
+		int32 Size = 0;
+		TArray<AActor*> Actors;
+		AActor* ISMActor = nullptr;
+		FProceduralObjectMatrix Matrix;
+		/** Set by a body that could not run, the sample fails instead of timing a no-op. */
+		FString Error;
+	};
+
+	struct FBenchmarkCase
+	{
+		const TCHAR* Name;
+		/** Generates the inputs, untimed. */
+		void (*Setup)(FBenchmarkContext&);
+		void (*Body)(FBenchmarkContext&);
+	};
+
+	FTransform GetGridTransform(int32 InIndex, int32 InCount)
+	{
+		const int32 Columns = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt((float)InCount)));
+		return FTransform(FRotator(0.0, InIndex * 37 % 360, 0.0), FVector(InIndex % Columns * BenchmarkSpacing, InIndex / Columns * BenchmarkSpacing, 0.0));
+	}
+
+	TArray<AActor*> SpawnMeshActors(UWorld* InWorld, UStaticMesh* InMesh, int32 InCount)
+	{
+		TArray<AActor*> Actors;
+		Actors.Reserve(InCount);
+		FActorSpawnParameters SpawnInfo;
+		SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		for (int32 Index = 0; Index < InCount; Index++) {
+			AStaticMeshActor* Actor = InWorld->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), GetGridTransform(Index, InCount), SpawnInfo);
+			Actor->GetStaticMeshComponent()->SetStaticMesh(InMesh);
+			Actor->SetActorLabel(FString::Printf(TEXT("Benchmark_%d"), Index));
+			Actors.Add(Actor);
+		}
+		return Actors;
+	}
+
+	/** An actor holding one instanced component with the given world space instances, built the way MergeISM and the foliage partition tool build theirs. */
+	AActor* SpawnInstancedActor(UWorld* InWorld, UStaticMesh* InMesh, TSubclassOf<UInstancedStaticMeshComponent> InComponentClass, const FString& InLabel, TConstArrayView<FTransform> InInstances)
+	{
+		FActorSpawnParameters SpawnInfo;
+		SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		AActor* Actor = InWorld->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnInfo);
+		USceneComponent* RootComponent = NewObject<USceneComponent>(Actor, USceneComponent::GetDefaultSceneRootVariableName(), RF_Transactional);
+		RootComponent->Mobility = EComponentMobility::Static;
+		Actor->SetRootComponent(RootComponent);
+		Actor->AddInstanceComponent(RootComponent);
+		RootComponent->OnComponentCreated();
+		RootComponent->RegisterComponent();
+		UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(Actor, InComponentClass, *InMesh->GetName(), RF_Transactional);
+		Component->Mobility = EComponentMobility::Static;
+		Actor->AddInstanceComponent(Component);
+		Component->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
+		Component->OnComponentCreated();
+		Component->RegisterComponent();
+		Component->SetStaticMesh(InMesh);
+		Component->AddInstances(TArray<FTransform>(InInstances), false, true);
+		Actor->SetActorLabel(InLabel);
+		return Actor;
+	}
+
+	/** InCount instances spread over FoliagePartition_X_Y actors, every tenth one doubled so Fixup has duplicates to remove. */
+	void SpawnFoliagePartitions(UWorld* InWorld, UStaticMesh* InMesh, int32 InCount)
+	{
+		TMap<FIntPoint, TArray<FTransform>> CellInstances;
+		for (int32 Index = 0; Index < InCount; Index++) {
+			const FTransform Transform = GetGridTransform(Index, InCount);
+			const FVector Location = Transform.GetLocation();
+			TArray<FTransform>& Instances = CellInstances.FindOrAdd(FIntPoint(FMath::FloorToInt(Location.X / FoliagePartitionCellSize), FMath::FloorToInt(Location.Y / FoliagePartitionCellSize)));
+			Instances.Add(Transform);
+			if (Index % 10 == 0) {
+				Instances.Add(Transform);
+			}
+		}
+		for (const auto& Pair : CellInstances) {
+			SpawnInstancedActor(InWorld, InMesh, UHierarchicalInstancedStaticMeshComponent::StaticClass(), FString::Printf(TEXT("FoliagePartition_%d_%d"), Pair.Key.X, Pair.Key.Y), Pair.Value);
+		}
+	}
+
+	void SpawnActorsSetup(FBenchmarkContext& Context)
+	{
+		Context.Actors = SpawnMeshActors(Context.World, Context.Mesh, Context.Size);
+	}
+
+	void BuildMatrix(FBenchmarkContext& Context)
+	{
+		for (int32 Index = 0; Index < Context.Actors.Num(); Index++) {
+			UProceduralContentProcessorLibrary::AddTextField(Context.Matrix, Context.Actors[Index], TEXT("Value"), FString::FromInt(Index * 7919 % 10007));
+			UProceduralContentProcessorLibrary::AddTextField(Context.Matrix, Context.Actors[Index], TEXT("Label"), Context.Actors[Index]->GetActorLabel());
+		}
+	}
+
+	void MatrixSetup(FBenchmarkContext& Context)
+	{
+		SpawnActorsSetup(Context);
+		BuildMatrix(Context);
+	}
+
+	void FoliagePartitionSetup(FBenchmarkContext& Context)
+	{
+		SpawnFoliagePartitions(Context.World, Context.Mesh, Context.Size);
+	}
+
+	void InvokeFunction(FBenchmarkContext& Context, UObject* InObject, const TCHAR* InFunctionName)
+	{
+		UFunction* Function = InObject->FindFunction(InFunctionName);
+		if (Function == nullptr || Function->ParmsSize != 0) {
+			Context.Error = FString::Printf(TEXT("%s has no parameterless function %s"), *InObject->GetClass()->GetName(), InFunctionName);
+			return;
+		}
+		InObject->ProcessEvent(Function, nullptr);
+	}
+
+	const FBenchmarkCase BenchmarkCases[] = {
+		{ TEXT("SpawnStaticMeshActors"), [](FBenchmarkContext&) {}, SpawnActorsSetup },
+		{ TEXT("GetAllActorsByName"), SpawnActorsSetup, [](FBenchmarkContext& Context) {
+			Context.FoliageTool->GetAllActorsByName(TEXT("Benchmark_1"));
+		} },
+		{ TEXT("MatrixBuild"), SpawnActorsSetup, BuildMatrix },
+		{ TEXT("MatrixSort"), MatrixSetup, [](FBenchmarkContext& Context) {
+			Context.Matrix.SortRows(TEXT("Value"), EColumnSortMode::Ascending);
+			Context.Matrix.SortRows(TEXT("Label"), EColumnSortMode::Descending);
+		} },
+		{ TEXT("MatrixSearch"), MatrixSetup, [](FBenchmarkContext& Context) {
+			TArray<TSharedPtr<FProceduralObjectMatrixRow>> Rows;
+			Context.Matrix.SearchRows(TEXT("Benchmark_1"), Rows);
+		} },
+		{ TEXT("GetAssetReferences"), SpawnActorsSetup, [](FBenchmarkContext& Context) {
+			UProceduralContentProcessorLibrary::GetAssetReferences(Context.World->PersistentLevel, {});
+		} },
+		{ TEXT("MergeISM"), SpawnActorsSetup, [](FBenchmarkContext& Context) {
+			UProceduralContentProcessorLibrary::MergeISM(Context.Actors, UInstancedStaticMeshComponent::StaticClass(), true);
+		} },
+		{ TEXT("BreakISM"), [](FBenchmarkContext& Context) {
+			TArray<FTransform> Instances;
+			for (int32 Index = 0; Index < Context.Size; Index++) {
+				Instances.Add(GetGridTransform(Index, Context.Size));
+			}
+			Context.ISMActor = SpawnInstancedActor(Context.World, Context.Mesh, UInstancedStaticMeshComponent::StaticClass(), TEXT("BenchmarkISM"), Instances);
+		}, [](FBenchmarkContext& Context) {
+			UProceduralContentProcessorLibrary::BreakISM(Context.ISMActor, true);
+		} },
+		// The tool works on the selection, any of the meshes pulls every matching actor into the partitions.
+		{ TEXT("FoliageToggle"), [](FBenchmarkContext& Context) {
+			SpawnActorsSetup(Context);
+			GEditor->SelectNone(false, true, false);
+			if (!Context.Actors.IsEmpty()) {
+				GEditor->SelectActor(Context.Actors[0], true, false, true);
+			}
+		}, [](FBenchmarkContext& Context) {
+			InvokeFunction(Context, Context.FoliageTool, TEXT("ToggleFoliagePartition"));
+		} },
+		{ TEXT("FoliageFixup"), FoliagePartitionSetup, [](FBenchmarkContext& Context) {
+			InvokeFunction(Context, Context.FoliageTool, TEXT("Fixup"));
+		} },
+		{ TEXT("FoliageBreakAllHISM"), FoliagePartitionSetup, [](FBenchmarkContext& Context) {
+			InvokeFunction(Context, Context.FoliageTool, TEXT("BreakAllHISM"));
+		} },
+	};
+}
+
+double FProceduralBenchmark::FSample::GetMedianMs() const
+{
+	if (Seconds.IsEmpty())
+		return 0.0;
+	TArray<double> Sorted = Seconds;
+	Sorted.Sort();
+	return Sorted[Sorted.Num() / 2] * 1000.0;
+}
+
+double FProceduralBenchmark::FSample::GetMinMs() const
+{
+	return Seconds.IsEmpty() ? 0.0 : FMath::Min(Seconds) * 1000.0;
+}
+
+TArray<FString> FProceduralBenchmark::GetCaseNames()
+{
+	TArray<FString> Names;
+	for (const FBenchmarkCase& Case : BenchmarkCases) {
+		Names.Add(Case.Name);
+	}
+	return Names;
+}
+
+TArray<FProceduralBenchmark::FSample> FProceduralBenchmark::Run(TConstArrayView<int32> InSizes, int32 InIterations, const FString& InCase)
+{
+	TArray<FSample> Samples;
+	UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, BenchmarkMeshPath);
+	if (Mesh == nullptr || GEditor == nullptr) {
+		UE_LOG(LogProceduralBenchmark, Error, TEXT("The benchmark needs the editor and %s"), BenchmarkMeshPath);
+		return Samples;
+	}
+	FArrayProperty* StaticMeshesProperty = FindFProperty<FArrayProperty>(UFoliagePartitionTool::StaticClass(), TEXT("StaticMeshes"));
+	check(StaticMeshesProperty);
+
+	for (int32 Size : InSizes) {
+		for (const FBenchmarkCase& Case : BenchmarkCases) {
+			if (!InCase.IsEmpty() && InCase != Case.Name)
+				continue;
+			FSample& Sample = Samples.AddDefaulted_GetRef();
+			Sample.Case = Case.Name;
+			Sample.Size = Size;
+			for (int32 Iteration = 0; Iteration < InIterations; Iteration++) {
+				FBenchmarkWorld BenchmarkWorld(Iteration);
+				FBenchmarkContext Context;
+				Context.World = BenchmarkWorld.World;
+				Context.Mesh = Mesh;
+				Context.Size = Size;
+				Context.FoliageTool = NewObject<UFoliagePartitionTool>(GetTransientPackage());
+				TStrongObjectPtr<UFoliagePartitionTool> FoliageToolReference(Context.FoliageTool);
+				Context.FoliageTool->SetWorldOverride(Context.World);
+				*StaticMeshesProperty->ContainerPtrToValuePtr<TArray<TObjectPtr<UStaticMesh>>>(Context.FoliageTool) = { Mesh };
+
+				Case.Setup(Context);
+				const double StartTime = FPlatformTime::Seconds();
+				Case.Body(Context);
+				const double Seconds = FPlatformTime::Seconds() - StartTime;
+				UProceduralContentProcessorLibrary::ClearObjectMaterix(Context.Matrix);
+				if (!Context.Error.IsEmpty()) {
+					Sample.Error = MoveTemp(Context.Error);
+					Sample.Seconds.Reset();
+					break;
+				}
+				Sample.Seconds.Add(Seconds);
+			}
+			if (!Sample.Error.IsEmpty()) {
+				UE_LOG(LogProceduralBenchmark, Error, TEXT("%-24s %8d failed: %s"), *Sample.Case, Size, *Sample.Error);
+				continue;
+			}
+			UE_LOG(LogProceduralBenchmark, Display, TEXT("%-24s %8d %10.2f ms"), *Sample.Case, Size, Sample.GetMedianMs());
+		}
+	}
+	return Samples;
+}
+
+bool FProceduralBenchmark::WriteCsv(const FString& InFilename, TConstArrayView<FSample> InSamples)
+{
+	TArray<FString> Lines;
+	Lines.Add(TEXT("Case,Size,Iterations,MedianMs,MinMs,BaselineMs,DeltaPercent"));
+	for (const FSample& Sample : InSamples) {
+		const double MedianMs = Sample.GetMedianMs();
+		const bool bHasBaseline = Sample.BaselineMs > 0.0;
+		Lines.Add(FString::Printf(TEXT("%s,%d,%d,%.3f,%.3f,%s,%s"), *Sample.Case, Sample.Size, Sample.Seconds.Num(), MedianMs, Sample.GetMinMs(),
+			bHasBaseline ? *FString::Printf(TEXT("%.3f"), Sample.BaselineMs) : TEXT(""),
+			bHasBaseline ? *FString::Printf(TEXT("%.1f"), (MedianMs / Sample.BaselineMs - 1.0) * 100.0) : TEXT("")));
+	}
+	return FFileHelper::SaveStringArrayToFile(Lines, *InFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+TArray<FString> FProceduralBenchmark::CompareToBaseline(const FString& InFilename, TArrayView<FSample> InOutSamples, float InTolerance, float InNoiseFloorMs)
+{
+	TArray<FString> Regressions;
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *InFilename)) {
+		UE_LOG(LogProceduralBenchmark, Warning, TEXT("No baseline at %s"), *InFilename);
+		return Regressions;
+	}
+	TMap<TPair<FString, int32>, double> Baseline;
+	for (int32 Index = 1; Index < Lines.Num(); Index++) {
+		TArray<FString> Values;
+		Lines[Index].ParseIntoArray(Values, TEXT(","), false);
+		if (Values.Num() >= 4) {
+			Baseline.Add({ Values[0], FCString::Atoi(*Values[1]) }, FCString::Atod(*Values[3]));
+		}
+	}
+	for (FSample& Sample : InOutSamples) {
+		const double* BaselineMs = Baseline.Find({ Sample.Case, Sample.Size });
+		if (BaselineMs == nullptr)
+			continue;
+		Sample.BaselineMs = *BaselineMs;
+		const double MedianMs = Sample.GetMedianMs();
+		// Tiny cases jitter by more than any sensible tolerance, they only count once the absolute change is noticeable.
+		if (MedianMs > *BaselineMs * (1.0 + InTolerance) && MedianMs - *BaselineMs > InNoiseFloorMs) {
+			Regressions.Add(FString::Printf(TEXT("%s@%d: %.2f ms, baseline %.2f ms"), *Sample.Case, Sample.Size, MedianMs, *BaselineMs));
+		}
+	}
+	return Regressions;
+}
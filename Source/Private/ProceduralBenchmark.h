@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Times the heavy library and tool operations on synthetic editor worlds of several sizes.
+ * Every case generates its own input in a fresh world per iteration, since most of the operations consume it:
+ * Size static mesh actors, an ISM actor with Size instances, or foliage partitions holding Size instances.
+ */
+class FProceduralBenchmark
+{
+public:
+	struct FSample
+	{
+		FString Case;
+		int32 Size = 0;
+		TArray<double> Seconds;
+		double BaselineMs = -1.0;
+		/** Why the case could not run, it has no timings then. */
+		FString Error;
+
+		double GetMedianMs() const;
+		double GetMinMs() const;
+	};
+
+	static TArray<FString> GetCaseNames();
+
+	/** Runs every case, or only InCase when set. */
+	static TArray<FSample> Run(TConstArrayView<int32> InSizes, int32 InIterations, const FString& InCase = FString());
+
+	/** Case,Size,Iterations,MedianMs,MinMs,BaselineMs,DeltaPercent */
+	static bool WriteCsv(const FString& InFilename, TConstArrayView<FSample> InSamples);
+
+	/** Fills BaselineMs from a CSV written by WriteCsv and returns the cases slower than the baseline by more than InTolerance. */
+	static TArray<FString> CompareToBaseline(const FString& InFilename, TArrayView<FSample> InOutSamples, float InTolerance, float InNoiseFloorMs);
+};
@@ -10,6 +10,7 @@
 #include "Selection.h"
 #include "DataLayer/DataLayerEditorSubsystem.h"
 #include "AssetRegistry/AssetRegistryHelpers.h"
+#include "AssetRegistry/AssetRegistryModule.h"
 #include "SLevelViewport.h"
 #include "Factories/MaterialInstanceConstantFactoryNew.h"
 #include "Materials/MaterialInstanceConstant.h"
@@ -20,6 +21,12 @@
 #include "StaticMeshCompiler.h"
 #include "Engine/TextureRenderTarget2D.h"
 #include "PropertyCustomizationHelpers.h"
+#include "ProceduralContentProcessorLibrary.h"
+#include "ProceduralAsyncTask.h"
+#include "ProceduralContentProcessorSettings.h"
+#include "ProceduralShardCoordinator.h"
+#include "ProceduralProfiler.h"
+#include "PackageTools.h"
 
 #if ENGINE_MAJOR_VERSION >=5 && ENGINE_MINOR_VERSION >= 4
 #include "GameFramework/ActorPrimitiveColorHandler.h"
@@ -40,6 +47,69 @@ void UProceduralContentProcessor::Tick(const float InDeltaTime)
 void UProceduralContentProcessor::Deactivate()
 {
 	ReceiveDeactivate();
+	Continuations.Reset();
+	TickDebtMs = 0.0;
+	SkippedDeltaTime = 0.0f;
+	UProceduralContentProcessorLibrary::ClearAllSlowTask();
+	FProceduralAsyncTaskRunner::CancelAll();
+}
+
+void UProceduralContentProcessor::ExecuteTick(const float InDeltaTime)
+{
+	const double BudgetMs = GetTickBudgetMs();
+	if (TickDebtMs > 0.0) {
+		TickDebtMs = FMath::Max(0.0, TickDebtMs - BudgetMs);
+		SkippedDeltaTime += InDeltaTime;
+		return;
+	}
+	const double StartTime = FPlatformTime::Seconds();
+	FrameDeadline = StartTime + BudgetMs / 1000.0;
+	bInTick = true;
+	Tick(InDeltaTime + SkippedDeltaTime);
+	SkippedDeltaTime = 0.0f;
+	const int32 NumContinuations = Continuations.Num();
+	for (int32 Step = 0; Step < NumContinuations && !Continuations.IsEmpty(); Step++) {
+		TFunction<bool()> Continuation = MoveTemp(Continuations[0]);
+#if ENGINE_MAJOR_VERSION >=5 && ENGINE_MINOR_VERSION >= 4
+		Continuations.RemoveAt(0, 1, EAllowShrinking::No);
+#else
+		Continuations.RemoveAt(0, 1, false);
+#endif
+		if (!Continuation()) {
+			Continuations.Add(MoveTemp(Continuation));
+		}
+		if (ShouldYield())
+			break;
+	}
+	bInTick = false;
+	LastTickCostMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	TickDebtMs = FMath::Max(0.0, LastTickCostMs - BudgetMs);
+}
+
+float UProceduralContentProcessor::GetTickBudgetMs() const
+{
+	return GetDefault<UProceduralContentProcessorSettings>()->TickBudgetMs;
+}
+
+void UProceduralContentProcessor::AddContinuation(TFunction<bool()> InContinuation)
+{
+	if (InContinuation) {
+		Continuations.Add(MoveTemp(InContinuation));
+	}
+}
+
+void UProceduralContentProcessor::AddBlueprintContinuation(const FProceduralContinuation& Continuation)
+{
+	if (!Continuation.IsBound())
+		return;
+	AddContinuation([Continuation]() {
+		return !Continuation.IsBound() || Continuation.Execute();
+	});
+}
+
+bool UProceduralContentProcessor::ShouldYield() const
+{
+	return bInTick && FPlatformTime::Seconds() >= FrameDeadline;
 }
 
 void UProceduralContentProcessor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
@@ -48,6 +118,20 @@ void UProceduralContentProcessor::PostEditChangeProperty(FPropertyChangedEvent&
 	TryUpdateDefaultConfigFile();
 }
 
+void UProceduralContentProcessor::ProcessEvent(UFunction* Function, void* Parms)
+{
+#if CPUPROFILERTRACE_ENABLED
+	const FString EventName = UE_TRACE_CHANNELEXPR_IS_ENABLED(CpuChannel) ? FString::Printf(TEXT("%s::%s"), *GetClass()->GetName(), *Function->GetName()) : FString();
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*EventName);
+#endif
+	// Only what the user launches starts a run, events like Colour or Tick fire per primitive or per frame
+	// and would replace that run before anyone could look at it, they are recorded as children of a run in progress.
+	const bool bRoot = Function->HasAnyFunctionFlags(FUNC_Exec) || Function->HasMetaData(TEXT("CallInEditor"))
+		|| Function->GetFName() == GET_FUNCTION_NAME_CHECKED(UProceduralContentProcessor, ReceiveActivate);
+	FProceduralProfiler::FScope Scope(Function->GetFName(), bRoot);
+	Super::ProcessEvent(Function, Parms);
+}
+
 TSharedPtr<SWidget> UProceduralContentProcessor::BuildWidget()
 {
 	if (UProceduralContentProcessorBlueprint* BP = Cast<UProceduralContentProcessorBlueprint>(GetClass()->ClassGeneratedBy)) {
@@ -92,12 +176,112 @@ TScriptInterface<IAssetRegistry> UProceduralAssetProcessor::GetAllAssetRegistry(
 	return ReturnParam;
 }
 
+TArray<FAssetData> UProceduralAssetProcessor::QueryAssets(const FProceduralAssetQuery& Query) const
+{
+	TArray<FAssetData> Results = Query.Execute();
+	if (HasAssetsToProcess()) {
+		TSet<FSoftObjectPath> AssetPaths;
+		for (const FAssetData& AssetData : AssetsToProcess) {
+			AssetPaths.Add(AssetData.GetSoftObjectPath());
+		}
+		Results.RemoveAll([&AssetPaths](const FAssetData& AssetData) {
+			return !AssetPaths.Contains(AssetData.GetSoftObjectPath());
+		});
+	}
+	return Results;
+}
+
+void UProceduralAssetProcessor::ReportAssetResult(const FSoftObjectPath& Asset, FName Field, const FString& Value)
+{
+	AssetResults.FindOrAdd(Asset).Add(Field, Value);
+}
+
+bool UProceduralAssetProcessor::RunSharded(FName FunctionName, const TArray<FName>& PackagePaths, const TArray<FTopLevelAssetPath>& ClassPaths, int32 NumWorkers, int32 MaxRetries, bool bSavePackages)
+{
+	if (ShardCoordinator.IsValid() && ShardCoordinator->IsRunning()) {
+		UE_LOG(LogTemp, Warning, TEXT("%s: a sharded run is already in progress"), *GetClass()->GetName());
+		return false;
+	}
+	if (FindFunction(FunctionName) == nullptr) {
+		UE_LOG(LogTemp, Error, TEXT("%s: function %s not found"), *GetClass()->GetName(), *FunctionName.ToString());
+		return false;
+	}
+	if (GetClass()->GetOutermost()->IsDirty()) {
+		UE_LOG(LogTemp, Warning, TEXT("%s has unsaved changes, workers run the version on disk"), *GetClass()->GetName());
+	}
+	if (PackagePaths.IsEmpty() && ClassPaths.IsEmpty()) {
+		UE_LOG(LogTemp, Error, TEXT("%s: a sharded run needs at least one package path or class"), *GetClass()->GetName());
+		return false;
+	}
+
+	FARFilter Filter;
+	Filter.PackagePaths = PackagePaths;
+	Filter.ClassPaths = ClassPaths;
+	Filter.bRecursivePaths = true;
+	Filter.bRecursiveClasses = true;
+	TArray<FAssetData> Assets;
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	// Workers save over the files on disk, the editor's copies of those packages would go stale and overwrite the results on the next save.
+	TArray<FName> LoadedPackageNames;
+	if (bSavePackages) {
+		for (const FAssetData& AssetData : Assets) {
+			UPackage* Package = FindPackage(nullptr, *AssetData.PackageName.ToString());
+			if (Package == nullptr)
+				continue;
+			if (Package->IsDirty()) {
+				UE_LOG(LogTemp, Error, TEXT("%s: %s has unsaved changes in the editor, save or revert it before a sharded run that saves packages"), *GetClass()->GetName(), *AssetData.PackageName.ToString());
+				return false;
+			}
+			LoadedPackageNames.AddUnique(AssetData.PackageName);
+		}
+	}
+
+	FProceduralShardSettings Settings;
+	Settings.ProcessorClassPath = GetClass()->GetPathName();
+	Settings.FunctionName = FunctionName.ToString();
+	Settings.NumWorkers = NumWorkers;
+	Settings.MaxRetries = MaxRetries;
+	Settings.bSavePackages = bSavePackages;
+	for (const FAssetData& AssetData : Assets) {
+		Settings.Assets.Add(AssetData.GetSoftObjectPath());
+	}
+	ShardCoordinator = MakeShared<FProceduralShardCoordinator>(MoveTemp(Settings));
+	if (!ShardCoordinator->Start()) {
+		ShardCoordinator.Reset();
+		return false;
+	}
+	TWeakObjectPtr<UProceduralAssetProcessor> WeakThis(this);
+	ShardCoordinator->RunAsync([WeakThis, LoadedPackageNames](const FProceduralShardedRunResult& Result) {
+		TArray<UPackage*> PackagesToReload;
+		for (const FName& PackageName : LoadedPackageNames) {
+			if (UPackage* Package = FindPackage(nullptr, *PackageName.ToString())) {
+				PackagesToReload.Add(Package);
+			}
+		}
+		if (!PackagesToReload.IsEmpty()) {
+			UPackageTools::ReloadPackages(PackagesToReload);
+		}
+		if (UProceduralAssetProcessor* Processor = WeakThis.Get()) {
+			Processor->ReceiveShardedRunCompleted(Result);
+		}
+	});
+	return true;
+}
+
+void UProceduralAssetProcessor::Deactivate()
+{
+	Super::Deactivate();
+	ShardCoordinator.Reset();
+}
+
 TArray<AActor*> UProceduralWorldProcessor::GetAllActorsByName(FString InName, bool bCompleteMatching /*= false*/)
 {
 	TArray<AActor*> OutActors;
-	if (!GEditor)
-		return OutActors;
 	UWorld* World = GetWorld();
+	if (!World)
+		return OutActors;
 	TArray<AActor*> AllActors;
 	UGameplayStatics::GetAllActorsOfClass(World, AActor::StaticClass(), AllActors);
 	if (bCompleteMatching) {
@@ -119,7 +303,13 @@ TArray<AActor*> UProceduralWorldProcessor::GetAllActorsByName(FString InName, bo
 
 UWorld* UProceduralWorldProcessor::GetWorld() const
 {
-	if (GEditor && GEditor->PlayWorld != nullptr) {
+	if (WorldOverride.IsValid()) {
+		return WorldOverride.Get();
+	}
+	if (GEditor == nullptr) {
+		return nullptr;
+	}
+	if (GEditor->PlayWorld != nullptr) {
 		return GEditor->PlayWorld;
 	}
 	return GEditor->GetEditorWorldContext().World();
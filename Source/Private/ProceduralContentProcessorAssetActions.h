@@ -29,7 +29,7 @@ class PROCEDURALCONTENTPROCESSOR_API UProceduralContentProcessorBlueprint : publ
 	}
 #endif
 public:
-	UPROPERTY(EditAnywhere, Category = ProceduralContentProcessor)
+	UPROPERTY(EditAnywhere, AssetRegistrySearchable, Category = ProceduralContentProcessor)
 	float SortPriority;
 
 	UPROPERTY(EditAnywhere, Category = ProceduralContentProcessor)
@@ -0,0 +1,582 @@
+#include "ProceduralContentProcessorCommandlet.h"
+#include "ProceduralContentProcessor.h"
+#include "ProceduralShardCoordinator.h"
+#include "ProceduralBenchmark.h"
+#include "Customization/ProceduralPipelineProcessor.h"
+#include "Customization/HLODPreviewTool.h"
+#include "Customization/HLODStatsExport.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Editor.h"
+#include "Engine/Blueprint.h"
+#include "FileHelpers.h"
+#include "EditorLoadingAndSavingUtils.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonSerializer.h"
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/LoaderAdapter/LoaderAdapterShape.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogProceduralContentProcessorCommandlet, Log, All);
+
+UProceduralContentProcessorCommandlet::UProceduralContentProcessorCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UProceduralContentProcessorCommandlet::Main(const FString& Params)
+{
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+	if (ParamVals.Contains(TEXT("Shards"))) {
+		return RunSharded(Params);
+	}
+	if (Switches.Contains(TEXT("Benchmark"))) {
+		return RunBenchmark(Params);
+	}
+	if (ParamVals.Contains(TEXT("StatsExport")) || ParamVals.Contains(TEXT("StatsDiff"))) {
+		return RunStats(Params);
+	}
+	return RunProcessor(Params);
+}
+
+UClass* UProceduralContentProcessorCommandlet::ResolveProcessorClass(const FString& InName)
+{
+	UClass* Class = FindFirstObject<UClass>(*InName, EFindFirstObjectOptions::NativeFirst);
+	if (Class == nullptr) {
+		UObject* Object = StaticLoadObject(UObject::StaticClass(), nullptr, *InName);
+		if (UBlueprint* Blueprint = Cast<UBlueprint>(Object)) {
+			Class = Blueprint->GeneratedClass;
+		}
+		else {
+			Class = Cast<UClass>(Object);
+		}
+	}
+	if (Class == nullptr || !Class->IsChildOf(UProceduralContentProcessor::StaticClass()) || Class->HasAnyClassFlags(CLASS_Abstract)) {
+		return nullptr;
+	}
+	return Class;
+}
+
+bool UProceduralContentProcessorCommandlet::InvokeProcessorFunction(UObject* InProcessor, FName InFunctionName)
+{
+	UFunction* Function = InProcessor ? InProcessor->FindFunction(InFunctionName) : nullptr;
+	if (Function == nullptr) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Function %s not found on %s"), *InFunctionName.ToString(), InProcessor ? *InProcessor->GetClass()->GetName() : TEXT("None"));
+		return false;
+	}
+	uint8* Parms = (uint8*)FMemory_Alloca_Aligned(FMath::Max<int32>(Function->ParmsSize, 1), Function->GetMinAlignment());
+	FMemory::Memzero(Parms, Function->ParmsSize);
+	for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It) {
+		if (!It->HasAnyPropertyFlags(CPF_ReturnParm | CPF_OutParm)) {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Warning, TEXT("%s: parameter %s is default initialized"), *InFunctionName.ToString(), *It->GetName());
+		}
+		It->InitializeValue_InContainer(Parms);
+	}
+	InProcessor->ProcessEvent(Function, Parms);
+	for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It) {
+		It->DestroyValue_InContainer(Parms);
+	}
+	return true;
+}
+
+UWorld* UProceduralContentProcessorCommandlet::LoadWorld(const FString& InMapPackageName)
+{
+	UPackage* Package = LoadPackage(nullptr, *InMapPackageName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (World == nullptr) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to load map %s"), *InMapPackageName);
+		return nullptr;
+	}
+	World->AddToRoot();
+	if (!World->bIsWorldInitialized) {
+		World->WorldType = EWorldType::Editor;
+		UWorld::InitializationValues IVS;
+		IVS.RequiresHitProxies(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(false)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true);
+		World->InitWorld(IVS);
+		World->PersistentLevel->UpdateModelComponents();
+		World->UpdateWorldComponents(true, false);
+	}
+	if (GEditor) {
+		GEditor->GetEditorWorldContext(true).SetCurrentWorld(World);
+	}
+	GWorld = World;
+	return World;
+}
+
+void UProceduralContentProcessorCommandlet::UnloadWorld(UWorld* InWorld)
+{
+	if (InWorld == nullptr)
+		return;
+	if (GEditor) {
+		GEditor->GetEditorWorldContext(true).SetCurrentWorld(nullptr);
+	}
+	GWorld = nullptr;
+	InWorld->RemoveFromRoot();
+	InWorld->DestroyWorld(false);
+	CollectGarbage(RF_NoFlags);
+}
+
+int32 UProceduralContentProcessorCommandlet::SaveDirtyPackages(int32& OutNumDirty, const TSet<FName>* InPackageNames, TArray<FString>* OutSkippedPackages)
+{
+	TArray<UPackage*> DirtyPackages;
+	FEditorFileUtils::GetDirtyPackages(DirtyPackages);
+	if (InPackageNames) {
+		DirtyPackages.RemoveAll([InPackageNames, OutSkippedPackages](UPackage* Package) {
+			if (InPackageNames->Contains(Package->GetFName()))
+				return false;
+			if (OutSkippedPackages) {
+				OutSkippedPackages->AddUnique(Package->GetName());
+			}
+			return true;
+		});
+	}
+	OutNumDirty = DirtyPackages.Num();
+	if (DirtyPackages.IsEmpty())
+		return 0;
+	UEditorLoadingAndSavingUtils::SavePackages(DirtyPackages, true);
+	int32 NumSaved = 0;
+	for (UPackage* Package : DirtyPackages) {
+		if (!Package->IsDirty()) {
+			NumSaved++;
+		}
+		else {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to save %s"), *Package->GetName());
+		}
+	}
+	return NumSaved;
+}
+
+bool UProceduralContentProcessorCommandlet::WriteReport(const FString& InFilename, const TSharedRef<FJsonObject>& InReport)
+{
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(InReport, Writer);
+	return FFileHelper::SaveStringToFile(Json, *InFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+int32 UProceduralContentProcessorCommandlet::RunProcessor(const FString& Params)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	FString ProcessorName, FunctionName, PipelinePath;
+	const bool bPipeline = FParse::Value(*Params, TEXT("Pipeline="), PipelinePath);
+	if (bPipeline) {
+		ProcessorName = UProceduralPipelineProcessor::StaticClass()->GetPathName();
+		FunctionName = GET_FUNCTION_NAME_STRING_CHECKED(UProceduralPipelineProcessor, Run);
+	}
+	else if (!FParse::Value(*Params, TEXT("Processor="), ProcessorName) || !FParse::Value(*Params, TEXT("Function="), FunctionName)) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Usage: -run=ProceduralContentProcessor -Processor=<Class> -Function=<Name> [-Maps=A+B] [-Region=MinX,MinY,MaxX,MaxY] [-Assets=/Game/A+/Game/B] [-Report=File.json] [-NoSave] [-Activate]\n       -run=ProceduralContentProcessor -Pipeline=/Game/Pipeline.Pipeline [-Maps=A+B] [-Report=File.json] [-NoSave]"));
+		return 1;
+	}
+	UClass* ProcessorClass = ResolveProcessorClass(ProcessorName);
+	if (ProcessorClass == nullptr) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("%s is not a processor class"), *ProcessorName);
+		return 1;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FString> Maps;
+	FString MapsParam;
+	if (FParse::Value(*Params, TEXT("Maps="), MapsParam, false)) {
+		MapsParam.ParseIntoArray(Maps, TEXT("+"));
+	}
+
+	FBox Region(ForceInit);
+	FString RegionParam;
+	if (FParse::Value(*Params, TEXT("Region="), RegionParam, false)) {
+		TArray<FString> Values;
+		RegionParam.ParseIntoArray(Values, TEXT(","));
+		if (Values.Num() == 4) {
+			Region = FBox(FVector(FCString::Atod(*Values[0]), FCString::Atod(*Values[1]), -HALF_WORLD_MAX), FVector(FCString::Atod(*Values[2]), FCString::Atod(*Values[3]), HALF_WORLD_MAX));
+		}
+		else if (Values.Num() == 6) {
+			Region = FBox(FVector(FCString::Atod(*Values[0]), FCString::Atod(*Values[1]), FCString::Atod(*Values[2])), FVector(FCString::Atod(*Values[3]), FCString::Atod(*Values[4]), FCString::Atod(*Values[5])));
+		}
+		else {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("-Region expects MinX,MinY,MaxX,MaxY or MinX,MinY,MinZ,MaxX,MaxY,MaxZ"));
+			return 1;
+		}
+	}
+
+	UProceduralContentProcessor* Processor = NewObject<UProceduralContentProcessor>(GetTransientPackage(), ProcessorClass);
+	Processor->AddToRoot();
+
+	if (bPipeline) {
+		UProceduralProcessorPipeline* Pipeline = LoadObject<UProceduralProcessorPipeline>(nullptr, *PipelinePath);
+		if (Pipeline == nullptr) {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to load pipeline %s"), *PipelinePath);
+			Processor->RemoveFromRoot();
+			return 1;
+		}
+		CastChecked<UProceduralPipelineProcessor>(Processor)->SetPipeline(Pipeline);
+	}
+
+	FString AssetsParam;
+	if (FParse::Value(*Params, TEXT("Assets="), AssetsParam, false)) {
+		if (UProceduralAssetProcessor* AssetProcessor = Cast<UProceduralAssetProcessor>(Processor)) {
+			FARFilter Filter;
+			TArray<FString> PackagePaths;
+			AssetsParam.ParseIntoArray(PackagePaths, TEXT("+"));
+			for (const FString& PackagePath : PackagePaths) {
+				Filter.PackagePaths.Add(*PackagePath);
+			}
+			Filter.bRecursivePaths = true;
+			TArray<FAssetData> Assets;
+			AssetRegistry.GetAssets(Filter, Assets);
+			AssetProcessor->SetAssetsToProcess(MoveTemp(Assets));
+		}
+	}
+
+	FString AssetListFilename;
+	if (FParse::Value(*Params, TEXT("AssetList="), AssetListFilename)) {
+		if (UProceduralAssetProcessor* AssetProcessor = Cast<UProceduralAssetProcessor>(Processor)) {
+			TArray<FString> Lines;
+			if (!FFileHelper::LoadFileToStringArray(Lines, *AssetListFilename)) {
+				UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to read asset list %s"), *AssetListFilename);
+				Processor->RemoveFromRoot();
+				return 1;
+			}
+			TArray<FAssetData> Assets;
+			TSet<FName> AssetPackageNames;
+			for (const FString& Line : Lines) {
+				const FSoftObjectPath AssetPath(Line.TrimStartAndEnd());
+				AssetPackageNames.Add(AssetPath.GetLongPackageFName());
+				FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(AssetPath);
+				if (AssetData.IsValid()) {
+					Assets.Add(MoveTemp(AssetData));
+				}
+				else {
+					UE_LOG(LogProceduralContentProcessorCommandlet, Warning, TEXT("Asset %s not found"), *Line);
+				}
+			}
+			// Shard workers only own the packages of their asset list, shared dependencies would otherwise be saved by several workers at once.
+			if (Switches.Contains(TEXT("SaveAssetListOnly"))) {
+				PackagesToSave = MoveTemp(AssetPackageNames);
+			}
+			AssetProcessor->SetAssetsToProcess(MoveTemp(Assets));
+		}
+	}
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("Processor"), ProcessorClass->GetPathName());
+	Report->SetStringField(TEXT("Function"), FunctionName);
+	TArray<TSharedPtr<FJsonValue>> Runs;
+	bool bSucceeded = true;
+
+	if (Processor->IsA<UProceduralWorldProcessor>() && !Maps.IsEmpty()) {
+		for (const FString& Map : Maps) {
+			const double LoadStartTime = FPlatformTime::Seconds();
+			UWorld* World = LoadWorld(Map);
+			if (World == nullptr) {
+				bSucceeded = false;
+				continue;
+			}
+			TUniquePtr<FLoaderAdapterShape> RegionLoader;
+			if (UWorldPartition* WorldPartition = World->GetWorldPartition()) {
+				const FBox LoadBounds = Region.IsValid ? Region : WorldPartition->GetEditorWorldBounds();
+				RegionLoader = MakeUnique<FLoaderAdapterShape>(World, LoadBounds, TEXT("ProceduralContentProcessorCommandlet"));
+				RegionLoader->Load();
+			}
+			const double LoadSeconds = FPlatformTime::Seconds() - LoadStartTime;
+
+			bool bRunSucceeded = false;
+			TSharedRef<FJsonObject> Run = RunOnce(Processor, *FunctionName, World, Map, bRunSucceeded);
+			Run->SetNumberField(TEXT("LoadSeconds"), LoadSeconds);
+			Runs.Add(MakeShared<FJsonValueObject>(Run));
+			bSucceeded &= bRunSucceeded;
+
+			if (RegionLoader.IsValid()) {
+				RegionLoader->Unload();
+				RegionLoader.Reset();
+			}
+			UnloadWorld(World);
+		}
+	}
+	else {
+		bool bRunSucceeded = false;
+		UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+		Runs.Add(MakeShared<FJsonValueObject>(RunOnce(Processor, *FunctionName, World, ProcessorClass->GetName(), bRunSucceeded)));
+		bSucceeded &= bRunSucceeded;
+	}
+
+	if (UProceduralAssetProcessor* AssetProcessor = Cast<UProceduralAssetProcessor>(Processor)) {
+		TArray<TSharedPtr<FJsonValue>> Results;
+		for (const auto& AssetResult : AssetProcessor->GetAssetResults()) {
+			TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+			Entry->SetStringField(TEXT("Asset"), AssetResult.Key.ToString());
+			TSharedRef<FJsonObject> Fields = MakeShared<FJsonObject>();
+			for (const auto& Field : AssetResult.Value) {
+				Fields->SetStringField(Field.Key.ToString(), Field.Value);
+			}
+			Entry->SetObjectField(TEXT("Fields"), Fields);
+			Results.Add(MakeShared<FJsonValueObject>(Entry));
+		}
+		Report->SetArrayField(TEXT("Results"), Results);
+	}
+
+	if (!UnsavedPackages.IsEmpty()) {
+		TArray<TSharedPtr<FJsonValue>> Unsaved;
+		for (const FString& PackageName : UnsavedPackages) {
+			Unsaved.Add(MakeShared<FJsonValueString>(PackageName));
+		}
+		Report->SetArrayField(TEXT("UnsavedPackages"), Unsaved);
+	}
+
+	Processor->RemoveFromRoot();
+	Report->SetArrayField(TEXT("Runs"), Runs);
+	Report->SetBoolField(TEXT("Succeeded"), bSucceeded);
+	Report->SetNumberField(TEXT("TotalSeconds"), FPlatformTime::Seconds() - StartTime);
+
+	FString ReportFilename;
+	if (FParse::Value(*Params, TEXT("Report="), ReportFilename)) {
+		if (!WriteReport(ReportFilename, Report)) {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to write report %s"), *ReportFilename);
+			bSucceeded = false;
+		}
+	}
+	return bSucceeded ? 0 : 1;
+}
+
+int32 UProceduralContentProcessorCommandlet::RunSharded(const FString& Params)
+{
+	FProceduralShardSettings Settings;
+	FString ProcessorName, AssetsParam;
+	if (!FParse::Value(*Params, TEXT("Processor="), ProcessorName) || !FParse::Value(*Params, TEXT("Function="), Settings.FunctionName) || !FParse::Value(*Params, TEXT("Assets="), AssetsParam, false)) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Usage: -run=ProceduralContentProcessor -Processor=<Class> -Function=<Name> -Assets=/Game/A+/Game/B -Shards=<Workers> [-ClassPaths=/Script/Engine.StaticMesh+...] [-Retries=2] [-Report=File.json] [-NoSave]"));
+		return 1;
+	}
+	UClass* ProcessorClass = ResolveProcessorClass(ProcessorName);
+	if (ProcessorClass == nullptr || !ProcessorClass->IsChildOf(UProceduralAssetProcessor::StaticClass())) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("%s is not an asset processor class"), *ProcessorName);
+		return 1;
+	}
+	Settings.ProcessorClassPath = ProcessorClass->GetPathName();
+	FParse::Value(*Params, TEXT("Shards="), Settings.NumWorkers);
+	FParse::Value(*Params, TEXT("Retries="), Settings.MaxRetries);
+	Settings.bSavePackages = !Switches.Contains(TEXT("NoSave"));
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+	FARFilter Filter;
+	TArray<FString> PackagePaths;
+	AssetsParam.ParseIntoArray(PackagePaths, TEXT("+"));
+	for (const FString& PackagePath : PackagePaths) {
+		Filter.PackagePaths.Add(*PackagePath);
+	}
+	FString ClassPathsParam;
+	if (FParse::Value(*Params, TEXT("ClassPaths="), ClassPathsParam, false)) {
+		TArray<FString> ClassPaths;
+		ClassPathsParam.ParseIntoArray(ClassPaths, TEXT("+"));
+		for (const FString& ClassPath : ClassPaths) {
+			Filter.ClassPaths.Add(FTopLevelAssetPath(ClassPath));
+		}
+		Filter.bRecursiveClasses = true;
+	}
+	if (Filter.PackagePaths.IsEmpty() && Filter.ClassPaths.IsEmpty()) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("-Assets or -ClassPaths must name at least one package path or class"));
+		return 1;
+	}
+	Filter.bRecursivePaths = true;
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+	for (const FAssetData& AssetData : Assets) {
+		Settings.Assets.Add(AssetData.GetSoftObjectPath());
+	}
+
+	TSharedRef<FProceduralShardCoordinator> Coordinator = MakeShared<FProceduralShardCoordinator>(MoveTemp(Settings));
+	if (!Coordinator->Start()) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("No assets to process"));
+		return 1;
+	}
+	const FProceduralShardedRunResult Result = Coordinator->RunBlocking();
+
+	FString ReportFilename;
+	if (FParse::Value(*Params, TEXT("Report="), ReportFilename)) {
+		if (IFileManager::Get().Copy(*ReportFilename, *Result.ReportFilename) != COPY_OK) {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to write report %s"), *ReportFilename);
+			return 1;
+		}
+	}
+	return Result.bSucceeded ? 0 : 1;
+}
+
+int32 UProceduralContentProcessorCommandlet::RunBenchmark(const FString& Params)
+{
+	TArray<int32> Sizes = { 100, 1000, 5000 };
+	FString SizesParam;
+	if (FParse::Value(*Params, TEXT("Sizes="), SizesParam, false)) {
+		TArray<FString> Values;
+		SizesParam.ParseIntoArray(Values, TEXT("+"));
+		Sizes.Reset();
+		for (const FString& Value : Values) {
+			Sizes.Add(FMath::Max(1, FCString::Atoi(*Value)));
+		}
+	}
+	int32 Iterations = 3;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	float Tolerance = 0.2f;
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+	float NoiseFloorMs = 2.0f;
+	FParse::Value(*Params, TEXT("NoiseFloorMs="), NoiseFloorMs);
+
+	FString Case;
+	FParse::Value(*Params, TEXT("Case="), Case);
+
+	TArray<FProceduralBenchmark::FSample> Samples = FProceduralBenchmark::Run(Sizes, FMath::Max(1, Iterations), Case);
+	if (Samples.IsEmpty())
+		return 1;
+
+	TArray<FString> Regressions;
+	FString BaselineFilename;
+	if (FParse::Value(*Params, TEXT("Baseline="), BaselineFilename)) {
+		Regressions = FProceduralBenchmark::CompareToBaseline(BaselineFilename, Samples, Tolerance, NoiseFloorMs);
+	}
+	FString CsvFilename = FPaths::ProjectSavedDir() / TEXT("ProceduralContentProcessor/Benchmark.csv");
+	FParse::Value(*Params, TEXT("Csv="), CsvFilename);
+	if (!FProceduralBenchmark::WriteCsv(CsvFilename, Samples)) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to write %s"), *CsvFilename);
+		return 1;
+	}
+	UE_LOG(LogProceduralContentProcessorCommandlet, Display, TEXT("Benchmark results written to %s"), *CsvFilename);
+	for (const FString& Regression : Regressions) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Regression: %s"), *Regression);
+	}
+	const bool bFailed = Samples.ContainsByPredicate([](const FProceduralBenchmark::FSample& InSample) { return !InSample.Error.IsEmpty(); });
+	return Regressions.IsEmpty() && !bFailed ? 0 : 1;
+}
+
+int32 UProceduralContentProcessorCommandlet::RunStats(const FString& Params)
+{
+	FString ExportFilename, DiffParam;
+	const bool bExport = FParse::Value(*Params, TEXT("StatsExport="), ExportFilename);
+	TArray<FString> DiffFilenames;
+	if (FParse::Value(*Params, TEXT("StatsDiff="), DiffParam, false)) {
+		DiffParam.ParseIntoArray(DiffFilenames, TEXT("+"));
+	}
+	if (DiffFilenames.Num() > 2 || (DiffFilenames.Num() < 2 && !bExport)) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Usage: -run=ProceduralContentProcessor -StatsExport=Stats.json -Map=/Game/Map [-StatsDiff=Base.json]\n       -run=ProceduralContentProcessor -StatsDiff=Base.json+Current.json [-Top=20] [-Csv=Diff.csv] [-CellTriangleBudget=N] [-CellDrawCallBudget=N] [-CellTextureMemoryBudget=MB]"));
+		return 1;
+	}
+
+	TArray<FHLODStatsExport::FCell> CurrentCells;
+	if (bExport) {
+		FString Map;
+		if (!FParse::Value(*Params, TEXT("Map="), Map)) {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("-StatsExport needs a -Map"));
+			return 1;
+		}
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.SearchAllAssets(true);
+		UWorld* World = LoadWorld(Map);
+		if (World == nullptr)
+			return 1;
+		UHLODPreviewTool* Tool = NewObject<UHLODPreviewTool>(GetTransientPackage());
+		Tool->AddToRoot();
+		const FWorldPartitionStats Stats = Tool->Generate(World);
+		Tool->RemoveFromRoot();
+		UnloadWorld(World);
+		if (Stats.Grids.IsEmpty()) {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("%s has no world partition streaming grids"), *Map);
+			return 1;
+		}
+		if (!FHLODStatsExport::Write(ExportFilename, Stats)) {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to write %s"), *ExportFilename);
+			return 1;
+		}
+		UE_LOG(LogProceduralContentProcessorCommandlet, Display, TEXT("World partition stats written to %s"), *ExportFilename);
+		CurrentCells = FHLODStatsExport::Flatten(Stats);
+	}
+	else if (!FHLODStatsExport::Read(DiffFilenames[1], CurrentCells)) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to read %s"), *DiffFilenames[1]);
+		return 1;
+	}
+
+	if (!DiffFilenames.IsEmpty()) {
+		TArray<FHLODStatsExport::FCell> BaseCells;
+		if (!FHLODStatsExport::Read(DiffFilenames[0], BaseCells)) {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to read %s"), *DiffFilenames[0]);
+			return 1;
+		}
+		int32 Top = 20;
+		FParse::Value(*Params, TEXT("Top="), Top);
+		const TArray<FHLODStatsExport::FRegression> Regressions = FHLODStatsExport::Diff(BaseCells, CurrentCells, Top);
+		for (const FHLODStatsExport::FRegression& Regression : Regressions) {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Display, TEXT("%s %s %s: %lld -> %lld (+%lld)"), *Regression.Metric, *Regression.Grid, *Regression.Package,
+				Regression.Base, Regression.Current, Regression.Current - Regression.Base);
+		}
+		FString CsvFilename;
+		if (FParse::Value(*Params, TEXT("Csv="), CsvFilename) && !FHLODStatsExport::WriteDiffCsv(CsvFilename, Regressions)) {
+			UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Failed to write %s"), *CsvFilename);
+			return 1;
+		}
+	}
+
+	int64 TriangleBudget = 0, DrawCallBudget = 0, TextureMemoryBudget = 0;
+	FParse::Value(*Params, TEXT("CellTriangleBudget="), TriangleBudget);
+	FParse::Value(*Params, TEXT("CellDrawCallBudget="), DrawCallBudget);
+	FParse::Value(*Params, TEXT("CellTextureMemoryBudget="), TextureMemoryBudget);
+	const TArray<FString> Overruns = FHLODStatsExport::CheckBudgets(CurrentCells, TriangleBudget, DrawCallBudget, TextureMemoryBudget * 1024 * 1024);
+	for (const FString& Overrun : Overruns) {
+		UE_LOG(LogProceduralContentProcessorCommandlet, Error, TEXT("Over budget: %s"), *Overrun);
+	}
+	return Overruns.IsEmpty() ? 0 : 1;
+}
+
+TSharedRef<FJsonObject> UProceduralContentProcessorCommandlet::RunOnce(UProceduralContentProcessor* InProcessor, FName InFunctionName, UWorld* InWorld, const FString& InTarget, bool& bOutSucceeded)
+{
+	TSharedRef<FJsonObject> Run = MakeShared<FJsonObject>();
+	Run->SetStringField(TEXT("Target"), InTarget);
+	if (UProceduralWorldProcessor* WorldProcessor = Cast<UProceduralWorldProcessor>(InProcessor)) {
+		WorldProcessor->SetWorldOverride(InWorld);
+	}
+	if (InWorld) {
+		int32 NumActors = 0;
+		for (ULevel* Level : InWorld->GetLevels()) {
+			NumActors += Level ? Level->Actors.Num() : 0;
+		}
+		Run->SetNumberField(TEXT("Actors"), NumActors);
+	}
+	if (UProceduralAssetProcessor* AssetProcessor = Cast<UProceduralAssetProcessor>(InProcessor)) {
+		Run->SetNumberField(TEXT("Assets"), AssetProcessor->GetAssetsToProcess().Num());
+	}
+
+	const bool bActivate = Switches.Contains(TEXT("Activate"));
+	const double ExecuteStartTime = FPlatformTime::Seconds();
+	if (bActivate) {
+		InProcessor->Activate();
+	}
+	bOutSucceeded = InvokeProcessorFunction(InProcessor, InFunctionName);
+	if (UProceduralPipelineProcessor* PipelineProcessor = Cast<UProceduralPipelineProcessor>(InProcessor)) {
+		bOutSucceeded &= PipelineProcessor->LastRunSucceeded();
+		PipelineProcessor->ClearCache();
+	}
+	if (bActivate) {
+		InProcessor->Deactivate();
+	}
+	Run->SetNumberField(TEXT("ExecuteSeconds"), FPlatformTime::Seconds() - ExecuteStartTime);
+
+	if (!Switches.Contains(TEXT("NoSave"))) {
+		const double SaveStartTime = FPlatformTime::Seconds();
+		int32 NumDirty = 0;
+		const int32 NumSaved = SaveDirtyPackages(NumDirty, PackagesToSave.GetPtrOrNull(), &UnsavedPackages);
+		bOutSucceeded &= NumSaved == NumDirty;
+		Run->SetNumberField(TEXT("DirtyPackages"), NumDirty);
+		Run->SetNumberField(TEXT("SavedPackages"), NumSaved);
+		Run->SetNumberField(TEXT("SaveSeconds"), FPlatformTime::Seconds() - SaveStartTime);
+	}
+	if (UProceduralWorldProcessor* WorldProcessor = Cast<UProceduralWorldProcessor>(InProcessor)) {
+		WorldProcessor->SetWorldOverride(nullptr);
+	}
+	Run->SetBoolField(TEXT("Succeeded"), bOutSucceeded);
+	UE_LOG(LogProceduralContentProcessorCommandlet, Display, TEXT("%s %s on %s: %s"), *InProcessor->GetClass()->GetName(), *InFunctionName.ToString(), *InTarget, bOutSucceeded ? TEXT("succeeded") : TEXT("failed"));
+	return Run;
+}
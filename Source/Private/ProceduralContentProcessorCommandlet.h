@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "ProceduralContentProcessorCommandlet.generated.h"
+
+class UProceduralContentProcessor;
+class FJsonObject;
+
+/**
+ * Runs a processor function without the editor UI, e.g.
+ * UnrealEditor-Cmd.exe Project.uproject -run=ProceduralContentProcessor -nullrhi
+ *     -Processor=/ProceduralContentProcessor/BP_Foo.BP_Foo_C -Function=Execute
+ *     [-Maps=/Game/MapA+/Game/MapB] [-Region=MinX,MinY,MaxX,MaxY] [-Assets=/Game/Path+/Game/Other]
+ *     [-AssetList=Assets.txt [-SaveAssetListOnly]] [-Report=Path.json] [-NoSave] [-Activate]
+ * With -SaveAssetListOnly only the packages of the asset list are saved, other dirty packages are listed as UnsavedPackages in the report.
+ * With -Shards=<Workers> the assets are split across worker processes, see FProceduralShardCoordinator.
+ * With -Pipeline=/Game/Pipeline.Pipeline a UProceduralProcessorPipeline runs instead of a single function.
+ * With -Benchmark [-Case=MergeISM] [-Sizes=100+1000] [-Iterations=3] [-Csv=Out.csv] [-Baseline=Base.csv] [-Tolerance=0.2] [-NoiseFloorMs=2] the heavy
+ * operations are timed on synthetic worlds, see FProceduralBenchmark, and regressions against the baseline fail the run.
+ * The same cases run as the ProceduralContentProcessor.Benchmark.* automation tests.
+ * With -StatsExport=Stats.json -Map=/Game/Map the world partition cell stats of the map are exported, see FHLODStatsExport.
+ * With -StatsDiff=Base.json[+Current.json] [-Top=20] [-Csv=Diff.csv] [-CellTriangleBudget=N] [-CellDrawCallBudget=N] [-CellTextureMemoryBudget=MB]
+ * the largest cell regressions against the base are reported, the current stats being the fresh export when only one file is given,
+ * and cells over any budget fail the run.
+ */
+UCLASS()
+class UProceduralContentProcessorCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UProceduralContentProcessorCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	static UClass* ResolveProcessorClass(const FString& InName);
+
+	static bool InvokeProcessorFunction(UObject* InProcessor, FName InFunctionName);
+
+	static UWorld* LoadWorld(const FString& InMapPackageName);
+
+	static void UnloadWorld(UWorld* InWorld);
+
+	/** Saves the dirty packages, only those in InPackageNames when given, the others are added to OutSkippedPackages. */
+	static int32 SaveDirtyPackages(int32& OutNumDirty, const TSet<FName>* InPackageNames = nullptr, TArray<FString>* OutSkippedPackages = nullptr);
+
+	static bool WriteReport(const FString& InFilename, const TSharedRef<FJsonObject>& InReport);
+private:
+	int32 RunProcessor(const FString& Params);
+
+	int32 RunSharded(const FString& Params);
+
+	int32 RunBenchmark(const FString& Params);
+
+	int32 RunStats(const FString& Params);
+
+	TSharedRef<FJsonObject> RunOnce(UProceduralContentProcessor* InProcessor, FName InFunctionName, UWorld* InWorld, const FString& InTarget, bool& bOutSucceeded);
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	TOptional<TSet<FName>> PackagesToSave;
+	TArray<FString> UnsavedPackages;
+};
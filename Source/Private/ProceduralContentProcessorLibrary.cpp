@@ -4,26 +4,18 @@
 #include "Materials/MaterialExpressionTime.h"
 #include "Landscape.h"
 #include "LandscapeInfo.h"
-#include "Misc/ScopedSlowTask.h"
 #include "LandscapeStreamingProxy.h"
 #include <Kismet/GameplayStatics.h>
 #include "Selection.h"
 #include "UnrealEdGlobals.h"
+#include "PackageTools.h"
 #include "Editor/UnrealEdEngine.h"
 #include "WorldPartition/HLOD/HLODLayer.h"
 #include "InstancedFoliageActor.h"
 #include "Components/LightComponentBase.h"
 #include "Layers/LayersSubsystem.h"
 #include "DataLayer/DataLayerEditorSubsystem.h"
-#include "EditPivotTool.h"
-#include "ToolTargets/StaticMeshComponentToolTarget.h"
 #include "Engine/StaticMeshActor.h"
-#include "InteractiveToolManager.h"
-#include "InteractiveToolsContext.h"
-#include "BaseGizmos/TransformGizmoUtil.h"
-#include "EdModeInteractiveToolsContext.h"
-#include "EditorModeManager.h"
-#include "ToolTargetManager.h"
 #include "Blueprint/UserWidget.h"
 #include "ObjectTools.h"
 #include "ReferencedAssetsUtils.h"
@@ -31,16 +23,19 @@
 #include "Framework/Notifications/NotificationManager.h"
 #include "StaticMeshEditorSubsystem.h"
 #include "LevelEditor.h"
-#include "ViewModels/NiagaraSystemViewModel.h"
-#include "ViewModels/NiagaraEmitterHandleViewModel.h"
-#include "ViewModels/NiagaraSystemViewModel.h"
-#include "ViewModels/Stack/NiagaraStackViewModel.h"
-#include "ViewModels/Stack/NiagaraStackFunctionInput.h"
-#include "ViewModels/Stack/NiagaraStackItemGroup.h"
-#include "ViewModels/Stack/NiagaraStackRoot.h"
 #include "SLevelViewport.h"
 #include "TextureCompiler.h"
 #include "ImageUtils.h"
+#include "ProceduralMaterialExpressionIndex.h"
+#include "ProceduralNiagaraScanner.h"
+#include "ProceduralAsyncTask.h"
+#include "Async/ParallelFor.h"
+#include "EngineUtils.h"
+#include "MeshDescription.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "ScopedTransaction.h"
+#include "UObject/StrongObjectPtr.h"
+#include "ProceduralProfiler.h"
 
 #define LOCTEXT_NAMESPACE "ProceduralContentProcessor"
 
@@ -48,6 +43,7 @@ void UProceduralContentProcessorLibrary::ClearObjectMaterix(FProceduralObjectMat
 {
 	Matrix.ObjectInfoList.Reset();
 	Matrix.ObjectInfoMap.Reset();
+	Matrix.AssetInfoMap.Reset();
 	Matrix.bIsDirty = true;
 }
 
@@ -123,8 +119,58 @@ void UProceduralContentProcessorLibrary::AddTextField(FProceduralObjectMatrix& M
 	Matrix.bIsDirty = true;
 }
 
+void UProceduralContentProcessorLibrary::AddAssetTextField(FProceduralObjectMatrix& Matrix, const FAssetData& InAsset, FName InFieldName, FString InFieldValue)
+{
+	Matrix.FieldKeys.AddUnique(InFieldName);
+	const FSoftObjectPath AssetPath = InAsset.GetSoftObjectPath();
+	auto InfoPtr = Matrix.AssetInfoMap.Find(AssetPath);
+	TSharedPtr<FProceduralObjectMatrixRow> Info;
+	if (!InfoPtr) {
+		Info = MakeShared<FProceduralObjectMatrixRow>();
+		Info->AssetPath = AssetPath;
+		Matrix.AssetInfoMap.Add(AssetPath, Info);
+		Matrix.ObjectInfoList.Add(Info);
+	}
+	else {
+		Info = *InfoPtr;
+	}
+	TSharedPtr<FProceduralObjectMatrixTextField> Field = MakeShared<FProceduralObjectMatrixTextField>();
+	Field->Name = InFieldName;
+	Field->Text = InFieldValue;
+	Info->AddField(Field);
+	Matrix.bIsDirty = true;
+}
+
+int32 UProceduralContentProcessorLibrary::QueryAssetsToMatrix(FProceduralObjectMatrix& Matrix, const FProceduralAssetQuery& Query, const TArray<FName>& Columns)
+{
+	PROCEDURAL_PROFILE_SCOPE(TEXT("QueryAssetsToMatrix"));
+	const TArray<FAssetData> Assets = Query.Execute();
+	for (FName Column : Columns) {
+		Matrix.FieldKeys.AddUnique(Column);
+	}
+	Matrix.ObjectInfoList.Reserve(Matrix.ObjectInfoList.Num() + Assets.Num());
+	for (const FAssetData& Asset : Assets) {
+		const FSoftObjectPath AssetPath = Asset.GetSoftObjectPath();
+		TSharedPtr<FProceduralObjectMatrixRow>& Info = Matrix.AssetInfoMap.FindOrAdd(AssetPath);
+		if (!Info.IsValid()) {
+			Info = MakeShared<FProceduralObjectMatrixRow>();
+			Info->AssetPath = AssetPath;
+			Matrix.ObjectInfoList.Add(Info);
+		}
+		for (FName Column : Columns) {
+			TSharedPtr<FProceduralObjectMatrixTextField> Field = MakeShared<FProceduralObjectMatrixTextField>();
+			Field->Name = Column;
+			Asset.GetTagValue(Column, Field->Text);
+			Info->AddField(Field);
+		}
+	}
+	Matrix.bIsDirty = true;
+	return Assets.Num();
+}
+
 TArray<UObject*> UProceduralContentProcessorLibrary::GetAllObjectsOfClass(UClass* Class, bool bIncludeDerivedClasses)
 {
+	PROCEDURAL_PROFILE_SCOPE(TEXT("GetAllObjectsOfClass"));
 	TArray<UObject*> Results;
 	GetObjectsOfClass(Class, Results, bIncludeDerivedClasses);
 	return Results;
@@ -189,6 +235,7 @@ UObject* UProceduralContentProcessorLibrary::DuplicateObject(UObject* SourceObje
 
 int32 UProceduralContentProcessorLibrary::DeleteObjects(const TArray< UObject* >& ObjectsToDelete, bool bShowConfirmation /*= true*/, bool bAllowCancelDuringDelete /*= true*/)
 {
+	PROCEDURAL_PROFILE_SCOPE(TEXT("DeleteObjects"));
 	return ObjectTools::DeleteObjects(ObjectsToDelete, bShowConfirmation, bAllowCancelDuringDelete ? ObjectTools::EAllowCancelDuringDelete::AllowCancel : ObjectTools::EAllowCancelDuringDelete::CancelNotAllowed);
 }
 
@@ -199,11 +246,13 @@ int32 UProceduralContentProcessorLibrary::DeleteObjectsUnchecked(const TArray< U
 
 void UProceduralContentProcessorLibrary::ConsolidateObjects(UObject* ObjectToConsolidateTo, TArray<UObject*>& ObjectsToConsolidate, bool bShowDeleteConfirmation /*= true*/)
 {
+	PROCEDURAL_PROFILE_SCOPE(TEXT("ConsolidateObjects"));
 	ObjectTools::ConsolidateObjects(ObjectToConsolidateTo, ObjectsToConsolidate, bShowDeleteConfirmation);
 }
 
 TSet<UObject*> UProceduralContentProcessorLibrary::GetAssetReferences(UObject* Object, const TArray<UClass*>& IgnoreClasses, bool bIncludeDefaultRefs /*= false*/)
 {
+	PROCEDURAL_PROFILE_SCOPE(TEXT("GetAssetReferences"));
 	TSet<UObject*> ReferencedAssets;
 	FFindReferencedAssets::BuildAssetList(Object, IgnoreClasses, {}, ReferencedAssets, bIncludeDefaultRefs);
 	return ReferencedAssets;
@@ -316,33 +365,33 @@ void UProceduralContentProcessorLibrary::AddNotificationWithButton(FText Notific
 
 void UProceduralContentProcessorLibrary::PushSlowTask(FText TaskName, float AmountOfWork)
 {
-	TSharedPtr<FSlowTask> SlowTask = MakeShared<FSlowTask>(AmountOfWork, TaskName);
-	SlowTasks.Add(SlowTask);
-	SlowTask->Initialize();
-	SlowTask->MakeDialog();
+	SlowTasks.Add(MakeShared<FProceduralTaskScope>(TaskName, AmountOfWork));
 }
 
 void UProceduralContentProcessorLibrary::EnterSlowTaskProgressFrame(float ExpectedWorkThisFrame /*= 1.f*/, const FText& Text /*= FText()*/)
 {
 	if (!SlowTasks.IsEmpty()) {
-		SlowTasks[SlowTasks.Num() - 1]->EnterProgressFrame(ExpectedWorkThisFrame, Text);
+		SlowTasks.Last()->EnterProgressFrame(ExpectedWorkThisFrame, Text);
 	}
 }
 
 void UProceduralContentProcessorLibrary::PopSlowTask()
 {
 	if (!SlowTasks.IsEmpty()) {
-		SlowTasks[SlowTasks.Num() - 1]->Destroy();
-		SlowTasks.SetNum(SlowTasks.Num() - 1);
+		SlowTasks.Pop();
 	}
 }
 
 void UProceduralContentProcessorLibrary::ClearAllSlowTask()
 {
-	for (auto Task : SlowTasks) {
-		Task->Destroy();
+	while (!SlowTasks.IsEmpty()) {
+		SlowTasks.Pop();
 	}
-	SlowTasks.Reset();
+}
+
+bool UProceduralContentProcessorLibrary::ShouldCancelSlowTask()
+{
+	return !SlowTasks.IsEmpty() && SlowTasks.Last()->ShouldCancel();
 }
 
 bool UProceduralContentProcessorLibrary::IsNaniteEnable(UStaticMesh* InMesh)
@@ -362,27 +411,76 @@ void UProceduralContentProcessorLibrary::SetNaniteMeshEnabled(UStaticMesh* Stati
 bool UProceduralContentProcessorLibrary::IsMaterialHasTimeNode(AStaticMeshActor* StaticMeshActor)
 {
 	if (StaticMeshActor && StaticMeshActor->GetStaticMeshComponent()) {
-		TArray<UMaterialInterface*> Materials = StaticMeshActor->GetStaticMeshComponent()->GetMaterials();
-		TQueue<UMaterialInterface*> Queue;
-		for (auto Material : Materials) {
-			Queue.Enqueue(Material);
-		}
-		while (!Queue.IsEmpty()) {
-			UMaterialInterface* Top;
-			Queue.Dequeue(Top);
-			if (auto MatIns = Cast<UMaterialInstance>(Top)) {
-				Queue.Enqueue(MatIns->Parent);
+		for (UMaterialInterface* Material : StaticMeshActor->GetStaticMeshComponent()->GetMaterials()) {
+			if (GetMaterialUsageFlags(Material) & (int32)EProceduralMaterialUsage::Time) {
+				return true;
 			}
-			else if (auto Mat = Cast<UMaterial>(Top)) {
-				UObjectBase* TimeNode = FindObjectWithOuter(Mat, UMaterialExpressionTime::StaticClass());
-				if (TimeNode) {
-					StaticMeshActor->SetIsTemporarilyHiddenInEditor(true);
-					return true;
+		}
+	}
+	return false;
+}
+
+int32 UProceduralContentProcessorLibrary::GetMaterialUsageFlags(UMaterialInterface* InMaterial)
+{
+	const FProceduralMaterialExpressionIndex::FEntry* Entry = FProceduralMaterialExpressionIndex::Get().FindOrBuild(InMaterial);
+	return Entry ? Entry->UsageFlags : 0;
+}
+
+bool UProceduralContentProcessorLibrary::MaterialHasExpression(UMaterialInterface* InMaterial, TSubclassOf<UMaterialExpression> InExpressionClass)
+{
+	return FProceduralMaterialExpressionIndex::Get().HasExpression(InMaterial, InExpressionClass.Get());
+}
+
+void UProceduralContentProcessorLibrary::FindPrimitivesByMaterialUsage(const UObject* WorldContextObject, int32 UsageFlags, TArray<AActor*>& OutActors, TArray<UPrimitiveComponent*>& OutComponents)
+{
+	PROCEDURAL_PROFILE_SCOPE(TEXT("FindPrimitivesByMaterialUsage"));
+	OutActors.Reset();
+	OutComponents.Reset();
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (World == nullptr || UsageFlags == 0)
+		return;
+
+	TArray<UPrimitiveComponent*> Components;
+	TArray<TArray<int32>> ComponentMaterials;
+	TArray<int32> MaterialFlags;
+	TMap<UMaterialInterface*, int32> MaterialIndexMap;
+	for (TActorIterator<AActor> It(World); It; ++It) {
+		TArray<UPrimitiveComponent*> PrimitiveComponents;
+		It->GetComponents(PrimitiveComponents);
+		for (UPrimitiveComponent* Component : PrimitiveComponents) {
+			TArray<UMaterialInterface*> UsedMaterials;
+			Component->GetUsedMaterials(UsedMaterials);
+			TArray<int32>& MaterialIndices = ComponentMaterials.AddDefaulted_GetRef();
+			for (UMaterialInterface* Material : UsedMaterials) {
+				if (Material == nullptr)
+					continue;
+				int32* MaterialIndex = MaterialIndexMap.Find(Material);
+				if (MaterialIndex == nullptr) {
+					MaterialIndex = &MaterialIndexMap.Add(Material, MaterialFlags.Add(GetMaterialUsageFlags(Material)));
 				}
+				MaterialIndices.Add(*MaterialIndex);
 			}
+			Components.Add(Component);
+		}
+	}
+
+	TArray<bool> Matched;
+	Matched.SetNumZeroed(Components.Num());
+	ParallelFor(Components.Num(), [&](int32 ComponentIndex) {
+		for (int32 MaterialIndex : ComponentMaterials[ComponentIndex]) {
+			if (MaterialFlags[MaterialIndex] & UsageFlags) {
+				Matched[ComponentIndex] = true;
+				break;
+			}
+		}
+	});
+
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++) {
+		if (Matched[ComponentIndex]) {
+			OutComponents.Add(Components[ComponentIndex]);
+			OutActors.AddUnique(Components[ComponentIndex]->GetOwner());
 		}
 	}
-	return false;
 }
 
 bool UProceduralContentProcessorLibrary::MatchString(FString InString, const TArray<FString>& IncludeList, const TArray<FString>& ExcludeList)
@@ -400,6 +498,98 @@ bool UProceduralContentProcessorLibrary::MatchString(FString InString, const TAr
 	return false;
 }
 
+FProceduralStringMatcher UProceduralContentProcessorLibrary::MakeStringMatcher(const TArray<FString>& IncludeList, const TArray<FString>& ExcludeList)
+{
+	FProceduralStringMatcher Matcher;
+	Matcher.Compile(IncludeList, ExcludeList);
+	return Matcher;
+}
+
+bool UProceduralContentProcessorLibrary::MatchStringByMatcher(const FProceduralStringMatcher& Matcher, const FString& InString)
+{
+	return Matcher.Match(InString);
+}
+
+TArray<FString> UProceduralContentProcessorLibrary::FilterStringsByMatcher(const FProceduralStringMatcher& Matcher, const TArray<FString>& InStrings)
+{
+	TArray<FString> Results;
+	for (int32 Index : Matcher.MatchIndices(InStrings.Num(), [&InStrings](int32 ItemIndex) { return InStrings[ItemIndex]; })) {
+		Results.Add(InStrings[Index]);
+	}
+	return Results;
+}
+
+TArray<FAssetData> UProceduralContentProcessorLibrary::FilterAssetsByMatcher(const FProceduralStringMatcher& Matcher, const TArray<FAssetData>& InAssets)
+{
+	TArray<FAssetData> Results;
+	for (int32 Index : Matcher.MatchIndices(InAssets.Num(), [&InAssets](int32 ItemIndex) { return InAssets[ItemIndex].GetObjectPathString(); })) {
+		Results.Add(InAssets[Index]);
+	}
+	return Results;
+}
+
+TArray<FAssetData> UProceduralContentProcessorLibrary::QueryAssets(const FProceduralAssetQuery& Query)
+{
+	PROCEDURAL_PROFILE_SCOPE(TEXT("QueryAssets"));
+	return Query.Execute();
+}
+
+bool UProceduralContentProcessorLibrary::GetAssetTagValueAsNumber(const FAssetData& InAsset, FName InTag, double& OutValue)
+{
+	FString TagValue;
+	return InAsset.GetTagValue(InTag, TagValue) && FProceduralAssetTagPredicate::TryParseNumber(TagValue, OutValue);
+}
+
+int32 UProceduralContentProcessorLibrary::ForEachAssetBatch(const TArray<FAssetData>& Assets, int32 BatchSize, const FProceduralAssetBatchDelegate& OnBatch)
+{
+	return ForEachAssetBatch(TConstArrayView<FAssetData>(Assets), BatchSize, [&OnBatch](const TArray<UObject*>& Batch) {
+		return OnBatch.IsBound() && OnBatch.Execute(Batch);
+	});
+}
+
+int32 UProceduralContentProcessorLibrary::ForEachAssetBatch(TConstArrayView<FAssetData> Assets, int32 BatchSize, TFunctionRef<bool(const TArray<UObject*>&)> OnBatch)
+{
+	PROCEDURAL_PROFILE_SCOPE(TEXT("ForEachAssetBatch"));
+	BatchSize = FMath::Max(1, BatchSize);
+	const int32 NumBatches = FMath::DivideAndRoundUp(Assets.Num(), BatchSize);
+	FProceduralTaskScope TaskScope(LOCTEXT("ForEachAssetBatch", "Processing Assets"), NumBatches);
+	TArray<TStrongObjectPtr<UObject>> DirtyAssets;
+	int32 NumProcessed = 0;
+	for (int32 BatchBegin = 0; BatchBegin < Assets.Num() && !TaskScope.ShouldCancel(); BatchBegin += BatchSize) {
+		const int32 BatchEnd = FMath::Min(BatchBegin + BatchSize, Assets.Num());
+		TaskScope.EnterProgressFrame(1.0f, FText::Format(LOCTEXT("ForEachAssetBatchFrame", "{0} / {1}"), BatchEnd, Assets.Num()));
+		TArray<UObject*> Batch;
+		// Only packages this batch loaded are unloaded again, the ones the editor already had stay untouched.
+		TSet<UPackage*> LoadedPackages;
+		for (int32 Index = BatchBegin; Index < BatchEnd; Index++) {
+			const bool bWasLoaded = FindPackage(nullptr, *Assets[Index].PackageName.ToString()) != nullptr;
+			if (UObject* Asset = Assets[Index].GetAsset()) {
+				Batch.Add(Asset);
+				if (!bWasLoaded) {
+					LoadedPackages.Add(Asset->GetPackage());
+				}
+			}
+		}
+		PROCEDURAL_PROFILE_COUNTER(AssetsLoaded, Batch.Num());
+		const bool bContinue = OnBatch(Batch);
+		NumProcessed += Batch.Num();
+		for (UObject* Asset : Batch) {
+			if (Asset->GetPackage()->IsDirty()) {
+				DirtyAssets.Emplace(Asset);
+				LoadedPackages.Remove(Asset->GetPackage());
+			}
+		}
+		Batch.Reset();
+		// Loaded assets are RF_Standalone, a plain garbage collection would keep all of them alive.
+		if (!LoadedPackages.IsEmpty()) {
+			UPackageTools::UnloadPackages(LoadedPackages.Array());
+		}
+		if (!bContinue)
+			break;
+	}
+	return NumProcessed;
+}
+
 float UProceduralContentProcessorLibrary::GetStaticMeshDiskSize(UStaticMesh* StaticMesh, bool bWithTexture)
 {
 	float DiskSize = 0.0f;
@@ -494,6 +684,7 @@ UObject* UProceduralContentProcessorLibrary::CopyProperties(UObject* SourceObjec
 
 void UProceduralContentProcessorLibrary::ForceReplaceReferences(UObject* SourceObjects, UObject* TargetObject)
 {
+	PROCEDURAL_PROFILE_SCOPE(TEXT("ForceReplaceReferences"));
 	TArray<UObject*> ObjectsToReplace(&TargetObject, 1);
 	ObjectTools::ForceReplaceReferences(SourceObjects, ObjectsToReplace);
 }
@@ -514,6 +705,103 @@ DEFINE_FUNCTION(UProceduralContentProcessorLibrary::execSetObjectPropertyByName)
 	}
 }
 
+DEFINE_FUNCTION(UProceduralContentProcessorLibrary::execSetPropertyOnObjects)
+{
+	P_GET_TARRAY_REF(UObject*, Param_Objects);
+	P_GET_PROPERTY(FStrProperty, Param_PropertyPath);
+	Stack.StepCompiledIn<FProperty>(nullptr);
+	FProperty* SourceProperty = Stack.MostRecentProperty;
+	void* SourceValuePtr = Stack.MostRecentPropertyAddress;
+	P_GET_UBOOL(Param_bNotifyChanges);
+	P_FINISH;
+	P_NATIVE_BEGIN;
+	SetPropertyOnObjects(Param_Objects, Param_PropertyPath, SourceProperty, SourceValuePtr, Param_bNotifyChanges);
+	P_NATIVE_END;
+}
+
+int32 UProceduralContentProcessorLibrary::SetPropertyOnObjects(TConstArrayView<UObject*> Objects, const FString& PropertyPath, const FProperty* ValueProperty, const void* ValuePtr, bool bNotifyChanges)
+{
+	PROCEDURAL_PROFILE_SCOPE(TEXT("SetPropertyOnObjects"));
+	if (ValueProperty == nullptr || ValuePtr == nullptr || Objects.IsEmpty())
+		return 0;
+	TArray<FString> PathSegments;
+	PropertyPath.ParseIntoArray(PathSegments, TEXT("."));
+	if (PathSegments.IsEmpty())
+		return 0;
+
+	struct FResolvedPath {
+		TArray<FProperty*> Properties;
+		TSharedPtr<FEditPropertyChain> EditChain;
+	};
+	TMap<const UClass*, TOptional<FResolvedPath>> ResolvedPaths;
+	auto ResolvePath = [&](const UClass* InClass) -> const FResolvedPath* {
+		if (const TOptional<FResolvedPath>* Cached = ResolvedPaths.Find(InClass)) {
+			return Cached->GetPtrOrNull();
+		}
+		TOptional<FResolvedPath>& Resolved = ResolvedPaths.Add(InClass);
+		const UStruct* Container = InClass;
+		TArray<FProperty*> Properties;
+		for (int32 SegmentIndex = 0; SegmentIndex < PathSegments.Num(); SegmentIndex++) {
+			FProperty* Property = Container ? FindFProperty<FProperty>(Container, *PathSegments[SegmentIndex]) : nullptr;
+			if (Property == nullptr)
+				return nullptr;
+			Properties.Add(Property);
+			const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+			Container = StructProperty ? StructProperty->Struct : nullptr;
+		}
+		if (!Properties.Last()->SameType(ValueProperty)) {
+			UE_LOG(LogTemp, Warning, TEXT("SetPropertyOnObjects: %s.%s does not match the value type %s"), *InClass->GetName(), *PropertyPath, *ValueProperty->GetCPPType());
+			return nullptr;
+		}
+		Resolved.Emplace();
+		Resolved->Properties = MoveTemp(Properties);
+		Resolved->EditChain = MakeShared<FEditPropertyChain>();
+		for (FProperty* Property : Resolved->Properties) {
+			Resolved->EditChain->AddTail(Property);
+		}
+		Resolved->EditChain->SetActiveMemberPropertyNode(Resolved->Properties[0]);
+		Resolved->EditChain->SetActivePropertyNode(Resolved->Properties.Last());
+		return Resolved.GetPtrOrNull();
+	};
+
+	FScopedTransaction Transaction(LOCTEXT("SetPropertyOnObjects", "Set Property On Objects"));
+	int32 NumChanged = 0;
+	for (UObject* Object : Objects) {
+		if (Object == nullptr)
+			continue;
+		const FResolvedPath* Resolved = ResolvePath(Object->GetClass());
+		if (Resolved == nullptr)
+			continue;
+		if (bNotifyChanges) {
+			Object->PreEditChange(*Resolved->EditChain);
+		}
+		else {
+			Object->Modify();
+		}
+		void* Container = Object;
+		for (int32 PropertyIndex = 0; PropertyIndex < Resolved->Properties.Num() - 1; PropertyIndex++) {
+			Container = Resolved->Properties[PropertyIndex]->ContainerPtrToValuePtr<void>(Container);
+		}
+		FProperty* LeafProperty = Resolved->Properties.Last();
+		if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(LeafProperty)) {
+			BoolProperty->SetPropertyValue_InContainer(Container, CastFieldChecked<const FBoolProperty>(ValueProperty)->GetPropertyValue(ValuePtr));
+		}
+		else {
+			LeafProperty->CopyCompleteValue(LeafProperty->ContainerPtrToValuePtr<void>(Container), ValuePtr);
+		}
+		if (bNotifyChanges) {
+			FPropertyChangedEvent PropertyEvent(LeafProperty, EPropertyChangeType::ValueSet);
+			FPropertyChangedChainEvent ChainEvent(*Resolved->EditChain, PropertyEvent);
+			Object->PostEditChangeChainProperty(ChainEvent);
+		}
+		else if (UActorComponent* Component = Cast<UActorComponent>(Object)) {
+			Component->MarkRenderStateDirty();
+		}
+		NumChanged++;
+	}
+	return NumChanged;
+}
+
 UStaticMesh* UProceduralContentProcessorLibrary::GetComplexCollisionMesh(UStaticMesh* InMesh)
 {
 	if (!InMesh)
@@ -523,30 +811,95 @@ UStaticMesh* UProceduralContentProcessorLibrary::GetComplexCollisionMesh(UStatic
 
 void UProceduralContentProcessorLibrary::SetStaticMeshPivot(UStaticMesh* InStaticMesh, EStaticMeshPivotType PivotType)
 {
-	if(InStaticMesh == nullptr)
-		return;
-	auto InteractiveToolsContext = NewObject<UEditorInteractiveToolsContext>();
-	InteractiveToolsContext->InitializeContextWithEditorModeManager(&GLevelEditorModeTools(), nullptr);
-	UE::TransformGizmoUtil::RegisterTransformGizmoContextObject(InteractiveToolsContext);
-
-	InteractiveToolsContext->ToolManager->RegisterToolType("EditPivotTool", NewObject<UEditPivotToolBuilder>());
-	UStaticMeshComponent* StaticMeshComp = NewObject<UStaticMeshComponent>();
-	StaticMeshComp->SetStaticMesh(InStaticMesh);
+	SetStaticMeshPivots({ InStaticMesh }, PivotType);
+}
 
-	InteractiveToolsContext->TargetManager->AddTargetFactory(NewObject<UStaticMeshComponentToolTargetFactory>());
-	UToolTarget* Target = InteractiveToolsContext->TargetManager->BuildTarget(StaticMeshComp, FToolTargetTypeRequirements());
+void UProceduralContentProcessorLibrary::SetStaticMeshPivots(const TArray<UStaticMesh*>& InStaticMeshes, EStaticMeshPivotType PivotType)
+{
+	PROCEDURAL_PROFILE_SCOPE(TEXT("SetStaticMeshPivots"));
+	if (PivotType == EStaticMeshPivotType::NoAction || PivotType == EStaticMeshPivotType::WorldOrigin)
+		return;
 
-	InteractiveToolsContext->ToolManager->SelectActiveToolType(EToolSide::Left, "EditPivotTool");
-	GLevelEditorModeTools().SelectNone();
-	GLevelEditorModeTools().GetSelectedComponents()->Select(StaticMeshComp);
+	struct FPivotJob {
+		UStaticMesh* StaticMesh = nullptr;
+		TArray<FMeshDescription*> MeshDescriptions;
+		TArray<int32> LODIndices;
+		FVector3f Offset = FVector3f::ZeroVector;
+	};
+	TArray<FPivotJob> Jobs;
+	for (UStaticMesh* StaticMesh : TSet<UStaticMesh*>(InStaticMeshes)) {
+		if (StaticMesh == nullptr)
+			continue;
+		FPivotJob Job;
+		Job.StaticMesh = StaticMesh;
+		for (int32 LODIndex = 0; LODIndex < StaticMesh->GetNumSourceModels(); LODIndex++) {
+			if (StaticMesh->IsMeshDescriptionValid(LODIndex)) {
+				Job.MeshDescriptions.Add(StaticMesh->GetMeshDescription(LODIndex));
+				Job.LODIndices.Add(LODIndex);
+			}
+		}
+		if (!Job.MeshDescriptions.IsEmpty()) {
+			StaticMesh->Modify();
+			Jobs.Add(MoveTemp(Job));
+		}
+	}
 
-	InteractiveToolsContext->ToolManager->ActivateTool(EToolSide::Left);
-	if (auto EditTool = Cast<UEditPivotTool>(InteractiveToolsContext->ToolManager->ActiveLeftTool))
-	{
-		EditTool->SetTargets({ Target });
-		EditTool->RequestAction((EEditPivotToolActions)PivotType);
-		EditTool->Tick(0.1);
-		EditTool->Shutdown(EToolShutdownType::Accept);
+	ParallelFor(Jobs.Num(), [&Jobs, PivotType](int32 JobIndex) {
+		FPivotJob& Job = Jobs[JobIndex];
+		const FBox Bounds = Job.MeshDescriptions[0]->ComputeBoundingBox();
+		if (!Bounds.IsValid)
+			return;
+		FVector Pivot = Bounds.GetCenter();
+		switch (PivotType) {
+		case EStaticMeshPivotType::Bottom: Pivot.Z = Bounds.Min.Z; break;
+		case EStaticMeshPivotType::Top: Pivot.Z = Bounds.Max.Z; break;
+		case EStaticMeshPivotType::Left: Pivot.Y = Bounds.Min.Y; break;
+		case EStaticMeshPivotType::Right: Pivot.Y = Bounds.Max.Y; break;
+		case EStaticMeshPivotType::Front: Pivot.X = Bounds.Max.X; break;
+		case EStaticMeshPivotType::Back: Pivot.X = Bounds.Min.X; break;
+		default: break;
+		}
+		Job.Offset = FVector3f(-Pivot);
+		for (FMeshDescription* MeshDescription : Job.MeshDescriptions) {
+			TVertexAttributesRef<FVector3f> Positions = MeshDescription->GetVertexPositions();
+			for (const FVertexID VertexID : MeshDescription->Vertices().GetElementIDs()) {
+				Positions[VertexID] += Job.Offset;
+			}
+		}
+	});
+
+	TArray<UStaticMesh*> StaticMeshesToBuild;
+	for (FPivotJob& Job : Jobs) {
+		if (Job.Offset.IsZero())
+			continue;
+		for (int32 LODIndex : Job.LODIndices) {
+			Job.StaticMesh->CommitMeshDescription(LODIndex);
+		}
+		if (UBodySetup* BodySetup = Job.StaticMesh->GetBodySetup()) {
+			const FVector Offset(Job.Offset);
+			BodySetup->Modify();
+			for (FKSphereElem& Elem : BodySetup->AggGeom.SphereElems) {
+				Elem.Center += Offset;
+			}
+			for (FKBoxElem& Elem : BodySetup->AggGeom.BoxElems) {
+				Elem.Center += Offset;
+			}
+			for (FKSphylElem& Elem : BodySetup->AggGeom.SphylElems) {
+				Elem.Center += Offset;
+			}
+			for (FKConvexElem& Elem : BodySetup->AggGeom.ConvexElems) {
+				for (FVector& Vertex : Elem.VertexData) {
+					Vertex += Offset;
+				}
+				Elem.UpdateElemBox();
+			}
+			BodySetup->InvalidatePhysicsData();
+		}
+		Job.StaticMesh->MarkPackageDirty();
+		StaticMeshesToBuild.Add(Job.StaticMesh);
+	}
+	if (!StaticMeshesToBuild.IsEmpty()) {
+		UStaticMesh::BatchBuild(StaticMeshesToBuild);
 	}
 }
 
@@ -572,33 +925,46 @@ float UProceduralContentProcessorLibrary::GetLodDistance(UStaticMesh* InStaticMe
 
 float UProceduralContentProcessorLibrary::CalcLodDistance(float ObjectSphereRadius, float ScreenSize)
 {
-	const float FOV = 90.0f;
-	const float FOVRad = FOV * (float)UE_PI / 360.0f;
-	const FMatrix ProjectionMatrix = FPerspectiveMatrix(FOVRad, 1920, 1080, 0.01f);
-	const float ScreenMultiple = FMath::Max(0.5f * ProjectionMatrix.M[0][0], 0.5f * ProjectionMatrix.M[1][1]);
-	const float ScreenRadius = FMath::Max(UE_SMALL_NUMBER, ScreenSize * 0.5f);
-	return ComputeBoundsDrawDistance(ScreenSize, ObjectSphereRadius, ProjectionMatrix);
+	return ProceduralLODMetrics::CalcLodDistance(ProceduralLODMetrics::DefaultScreenMultiple, ObjectSphereRadius, ScreenSize);
 }
 
 float UProceduralContentProcessorLibrary::CalcScreenSize(float ObjectSphereRadius, float Distance)
 {
-	const float FOV = 90.0f;
-	const float FOVRad = FOV * (float)UE_PI / 360.0f;
-	const FMatrix ProjectionMatrix = FPerspectiveMatrix(FOVRad, 1920, 1080, 0.01f);
-	const float ScreenMultiple = FMath::Max(0.5f * ProjectionMatrix.M[0][0], 0.5f * ProjectionMatrix.M[1][1]);
-	if (Distance <= 0.000001f) {
-		return 2.0f;
-	}
-	return  2.0f * ScreenMultiple * ObjectSphereRadius / FMath::Max(1.0f, Distance);
+	return ProceduralLODMetrics::CalcScreenSize(ProceduralLODMetrics::DefaultScreenMultiple, ObjectSphereRadius, Distance);
 }
 
 float UProceduralContentProcessorLibrary::CalcObjectSphereRadius(float ScreenSize, float Distance)
 {
-	const float FOV = 90.0f;
-	const float FOVRad = FOV * (float)UE_PI / 360.0f;
-	const FMatrix ProjectionMatrix = FPerspectiveMatrix(FOVRad, 1920, 1080, 0.01f);
-	const float ScreenMultiple = FMath::Max(0.5f * ProjectionMatrix.M[0][0], 0.5f * ProjectionMatrix.M[1][1]);
-	return ScreenSize * Distance / ( 2.0f* ScreenMultiple);
+	return ProceduralLODMetrics::CalcObjectSphereRadius(ProceduralLODMetrics::DefaultScreenMultiple, ScreenSize, Distance);
+}
+
+float UProceduralContentProcessorLibrary::GetProjectionScreenMultiple(const FProceduralProjectionSettings& Projection)
+{
+	return Projection.GetScreenMultiple();
+}
+
+TArray<float> UProceduralContentProcessorLibrary::CalcLodDistances(const TArray<float>& ObjectSphereRadii, const TArray<float>& ScreenSizes, const FProceduralProjectionSettings& Projection)
+{
+	TArray<float> Distances;
+	Distances.SetNumUninitialized(FMath::Min(ObjectSphereRadii.Num(), ScreenSizes.Num()));
+	ProceduralLODMetrics::CalcLodDistances(Projection.GetScreenMultiple(), ObjectSphereRadii, ScreenSizes, Distances);
+	return Distances;
+}
+
+TArray<float> UProceduralContentProcessorLibrary::CalcScreenSizes(const TArray<float>& ObjectSphereRadii, const TArray<float>& Distances, const FProceduralProjectionSettings& Projection)
+{
+	TArray<float> ScreenSizes;
+	ScreenSizes.SetNumUninitialized(FMath::Min(ObjectSphereRadii.Num(), Distances.Num()));
+	ProceduralLODMetrics::CalcScreenSizes(Projection.GetScreenMultiple(), ObjectSphereRadii, Distances, ScreenSizes);
+	return ScreenSizes;
+}
+
+TArray<float> UProceduralContentProcessorLibrary::CalcObjectSphereRadii(const TArray<float>& ScreenSizes, const TArray<float>& Distances, const FProceduralProjectionSettings& Projection)
+{
+	TArray<float> Radii;
+	Radii.SetNumUninitialized(FMath::Min(ScreenSizes.Num(), Distances.Num()));
+	ProceduralLODMetrics::CalcObjectSphereRadii(Projection.GetScreenMultiple(), ScreenSizes, Distances, Radii);
+	return Radii;
 }
 
 UTexture2D* UProceduralContentProcessorLibrary::ConstructTexture2D(UTextureRenderTarget2D* TextureRenderTarget2D, UObject* Outer, FString Name /*= NAME_None*/, TextureCompressionSettings CompressionSettings)
@@ -639,54 +1005,15 @@ void UProceduralContentProcessorLibrary::UpdateTexture2D(UTextureRenderTarget2D*
 	TextureRenderTarget2D->UpdateTexture2D(Texture, TextureRenderTarget2D->GetTextureFormatForConversionToTexture2D());
 }
 
-void ForeachNiagaraEntry(UNiagaraStackEntry* Root, TFunction<void(UNiagaraStackEntry*)> Func)
+FNiagaraSystemInfo UProceduralContentProcessorLibrary::GetNiagaraSystemInformation(UNiagaraSystem* InNaigaraSystem)
 {
-	if (!Root) 
-		return;
-	Func(Root);
-	TArray<UNiagaraStackEntry*> Children;
-	Root->GetFilteredChildren(Children);
-	for (auto Child : Children) {
-		ForeachNiagaraEntry(Child, Func);
-	}
+	return FProceduralNiagaraScanner::Get().Scan(InNaigaraSystem);
 }
 
-FNiagaraSystemInfo UProceduralContentProcessorLibrary::GetNiagaraSystemInformation(UNiagaraSystem* InNaigaraSystem)
+TArray<FNiagaraSystemInfo> UProceduralContentProcessorLibrary::GetNiagaraSystemsInformation(const TArray<UNiagaraSystem*>& InNiagaraSystems)
 {
-	FNiagaraSystemViewModelOptions SystemViewModelOptions;
-	SystemViewModelOptions.bCanSimulate = false;
-	SystemViewModelOptions.bCanAutoCompile = false;
-	// SystemViewModelOptions.bIsForDataProcessingOnly will affect Win.CMD Operate.
-	SystemViewModelOptions.bIsForDataProcessingOnly = true;
-	SystemViewModelOptions.MessageLogGuid = InNaigaraSystem->GetAssetGuid();
-	TSharedRef<FNiagaraSystemViewModel> SystemViewModel = MakeShared<FNiagaraSystemViewModel>();
-	SystemViewModel->Initialize(*InNaigaraSystem, SystemViewModelOptions);
-	TArray<TSharedRef<FNiagaraEmitterHandleViewModel>> EmitterViewModels = SystemViewModel->GetEmitterHandleViewModels();
-	FNiagaraSystemInfo SystemInfo;
-	for (TSharedRef<FNiagaraEmitterHandleViewModel> EmitterHandleViewModel : EmitterViewModels){
-		FNiagaraEmitterHandle* EmitterHandle = EmitterHandleViewModel->GetEmitterHandle();
-		FNiagaraEmitterInfo EmitterInfo;
-		EmitterInfo.Name = EmitterHandle->GetName();
-		EmitterInfo.bEnabled = EmitterHandle->GetIsEnabled();
-		EmitterInfo.Data = *EmitterHandle->GetEmitterData();
-		UNiagaraStackViewModel* StackViewModel = EmitterHandleViewModel->GetEmitterStackViewModel();
-		TArray<UNiagaraStackItemGroup*> StackItemGroups;
-		StackViewModel->GetRootEntry()->GetUnfilteredChildrenOfType<UNiagaraStackItemGroup>(StackItemGroups);
-		UNiagaraStackRoot* StackRoot = CastChecked<UNiagaraStackRoot>(StackViewModel->GetRootEntry());
-		ForeachNiagaraEntry(StackRoot,[&EmitterInfo](UNiagaraStackEntry* Entry){
-			if (UNiagaraStackFunctionInput* Input = Cast<UNiagaraStackFunctionInput>(Entry)) {
-				FString Name = Input->GetDisplayName().ToString();
-				FString Value;
-
-				//TODO: value assign
-
-				EmitterInfo.Inputs.Add(Name, Value);
-			}
-		});
-		SystemInfo.Emitters.Emplace(EmitterInfo);
-	}
-
-	return SystemInfo;
+	PROCEDURAL_PROFILE_SCOPE(TEXT("GetNiagaraSystemsInformation"));
+	return FProceduralNiagaraScanner::Get().Scan(InNiagaraSystems);
 }
 
 FVector2D UProceduralContentProcessorLibrary::ProjectWorldToScreen(const FVector& InWorldPos, bool bClampToScreenRectangle)
@@ -765,6 +1092,7 @@ UPhysicalMaterial* UProceduralContentProcessorLibrary::GetSimplePhysicalMaterial
 
 TArray<AActor*> UProceduralContentProcessorLibrary::BreakISM(AActor* InISMActor, bool bDestorySourceActor /*= true*/)
 {
+	PROCEDURAL_PROFILE_SCOPE(TEXT("BreakISM"));
 	TArray<AActor*> Actors;
 	if (!InISMActor)
 		return Actors;
@@ -788,6 +1116,7 @@ TArray<AActor*> UProceduralContentProcessorLibrary::BreakISM(AActor* InISMActor,
 				NewActor->Modify();
 				NewActor->SetActorLabel(MakeUniqueObjectName(World, AStaticMeshActor::StaticClass(), *ISMC->GetStaticMesh()->GetName()).ToString());
 				Actors.Add(NewActor);
+				PROCEDURAL_PROFILE_COUNTER(ActorsSpawned, 1);
 				LayersSubsystem->InitializeNewActorLayers(NewActor);
 				const bool bCurrentActorSelected = GUnrealEd->GetSelectedActors()->IsSelected(InISMActor);
 				if (bCurrentActorSelected)
@@ -816,6 +1145,7 @@ TArray<AActor*> UProceduralContentProcessorLibrary::BreakISM(AActor* InISMActor,
 
 AActor* UProceduralContentProcessorLibrary::MergeISM(TArray<AActor*> InSourceActors, TSubclassOf<UInstancedStaticMeshComponent> InISMClass, bool bDestorySourceActor /*= true*/)
 {
+	PROCEDURAL_PROFILE_SCOPE(TEXT("MergeISM"));
 	if (InSourceActors.IsEmpty() || !InISMClass)
 		return nullptr;
 	ULayersSubsystem* LayersSubsystem = GEditor->GetEditorSubsystem<ULayersSubsystem>();
@@ -847,6 +1177,7 @@ AActor* UProceduralContentProcessorLibrary::MergeISM(TArray<AActor*> InSourceAct
 	FTransform Transform;
 	Transform.SetLocation(Bounds.Origin);
 	auto NewISMActor = World->SpawnActor<AActor>(AActor::StaticClass(), Transform, SpawnInfo);
+	PROCEDURAL_PROFILE_COUNTER(ActorsSpawned, 1);
 	USceneComponent* RootComponent = NewObject<USceneComponent>(NewISMActor, USceneComponent::GetDefaultSceneRootVariableName(), RF_Transactional);
 	RootComponent->Mobility = EComponentMobility::Static;
 	RootComponent->bVisualizeComponent = true;
@@ -866,6 +1197,7 @@ AActor* UProceduralContentProcessorLibrary::MergeISM(TArray<AActor*> InSourceAct
 		for (auto InstanceTransform : InstancedInfo.Value) {
 			ISMComponent->AddInstance(InstanceTransform, true);
 		}
+		PROCEDURAL_PROFILE_COUNTER(InstancesAdded, InstancedInfo.Value.Num());
 	}
 	NewISMActor->Modify();
 	LayersSubsystem->InitializeNewActorLayers(NewISMActor);
@@ -906,29 +1238,35 @@ void UProceduralContentProcessorLibrary::LookAtActor(AActor* InActor)
 
 AActor* UProceduralContentProcessorLibrary::SpawnTransientActor(UObject* WorldContextObject, TSubclassOf<AActor> Class, FTransform Transform)
 {
+	PROCEDURAL_PROFILE_SCOPE(TEXT("SpawnTransientActor"));
 	if (WorldContextObject == nullptr)
 		return nullptr;
 	UWorld* World = WorldContextObject->GetWorld();
 	AActor* Actor = World->SpawnActor(Class, &Transform);
-	if (Actor)
+	if (Actor) {
 		Actor->SetFlags(RF_Transient);
+		PROCEDURAL_PROFILE_COUNTER(ActorsSpawned, 1);
+	}
 	return Actor;
 }
 
 AActor* UProceduralContentProcessorLibrary::ReplaceActor(AActor* InSrc, TSubclassOf<AActor> InDst, bool bNoteSelectionChange /*= false*/)
 {
+	PROCEDURAL_PROFILE_SCOPE(TEXT("ReplaceActor"));
 	if (!InSrc || !InDst)
 		return nullptr;
 	GEditor->BeginTransaction(LOCTEXT("ReplaceActor", "Replace Actor"));
 	FTransform Transform = InSrc->GetTransform();
 	auto NewActor = GUnrealEd->ReplaceActor(InSrc, InDst, nullptr, bNoteSelectionChange);
 	NewActor->SetActorTransform(Transform);
+	PROCEDURAL_PROFILE_COUNTER(ActorsSpawned, 1);
 	GEditor->EndTransaction();
 	return NewActor;
 }
 
 void UProceduralContentProcessorLibrary::ReplaceActors(TMap<AActor*, TSubclassOf<AActor>> ActorMap, bool bNoteSelectionChange)
 {
+	PROCEDURAL_PROFILE_SCOPE(TEXT("ReplaceActors"));
 	if (GUnrealEd && !ActorMap.IsEmpty()) {
 		GEditor->BeginTransaction(LOCTEXT("ReplaceActors", "Replace Actors"));
 		for (auto ActorPair : ActorMap) {
@@ -936,6 +1274,7 @@ void UProceduralContentProcessorLibrary::ReplaceActors(TMap<AActor*, TSubclassOf
 				FTransform Transform = ActorPair.Key->GetTransform();
 				auto NewActor = GUnrealEd->ReplaceActor(ActorPair.Key, ActorPair.Value, nullptr, bNoteSelectionChange);
 				NewActor->SetActorTransform(Transform);
+				PROCEDURAL_PROFILE_COUNTER(ActorsSpawned, 1);
 			}
 		}
 		GEditor->EndTransaction();
@@ -996,6 +1335,6 @@ void UProceduralContentProcessorLibrary::ActorSetRuntimeGrid(AActor* Actor, FNam
 	}
 }
 
-TArray<TSharedPtr<FSlowTask>> UProceduralContentProcessorLibrary::SlowTasks;
+TArray<TSharedPtr<FProceduralTaskScope>> UProceduralContentProcessorLibrary::SlowTasks;
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -8,4 +8,7 @@ class UProceduralContentProcessorSettings : public UObject {
 public:
 	UPROPERTY(Config, EditAnywhere)
 	FSoftClassPath LastProcessorClass;
+
+	UPROPERTY(Config, EditAnywhere, meta = (ClampMin = 0.1, Units = "ms"))
+	float TickBudgetMs = 8.0f;
 }; 
@@ -0,0 +1,70 @@
+#include "ProceduralLODMetrics.h"
+#include "Math/VectorRegister.h"
+
+float FProceduralProjectionSettings::GetAspectRatio() const
+{
+	return Resolution.Y > 0 ? (float)Resolution.X / (float)Resolution.Y : 1.0f;
+}
+
+float FProceduralProjectionSettings::GetScreenMultiple() const
+{
+	if (FOV == ProceduralLODMetrics::DefaultFOV && Resolution == FIntPoint(1920, 1080)) {
+		return ProceduralLODMetrics::DefaultScreenMultiple;
+	}
+	const float HalfFOVRad = FMath::Clamp(FOV, 1.0f, 170.0f) * (float)UE_PI / 360.0f;
+	return 0.5f * FMath::Max(1.0f, GetAspectRatio()) / FMath::Tan(HalfFOVRad);
+}
+
+namespace ProceduralLODMetrics
+{
+	void CalcLodDistances(float ScreenMultiple, TConstArrayView<float> ObjectSphereRadii, TConstArrayView<float> ScreenSizes, TArrayView<float> OutDistances)
+	{
+		const int32 Num = FMath::Min3(ObjectSphereRadii.Num(), ScreenSizes.Num(), OutDistances.Num());
+		const VectorRegister4Float Multiple = VectorSetFloat1(ScreenMultiple);
+		const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+		const VectorRegister4Float SmallNumber = VectorSetFloat1(UE_SMALL_NUMBER);
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4) {
+			const VectorRegister4Float Radius = VectorLoad(&ObjectSphereRadii[Index]);
+			const VectorRegister4Float ScreenRadius = VectorMax(VectorMultiply(VectorLoad(&ScreenSizes[Index]), Half), SmallNumber);
+			VectorStore(VectorDivide(VectorMultiply(Multiple, Radius), ScreenRadius), &OutDistances[Index]);
+		}
+		for (; Index < Num; Index++) {
+			OutDistances[Index] = CalcLodDistance(ScreenMultiple, ObjectSphereRadii[Index], ScreenSizes[Index]);
+		}
+	}
+
+	void CalcScreenSizes(float ScreenMultiple, TConstArrayView<float> ObjectSphereRadii, TConstArrayView<float> Distances, TArrayView<float> OutScreenSizes)
+	{
+		const int32 Num = FMath::Min3(ObjectSphereRadii.Num(), Distances.Num(), OutScreenSizes.Num());
+		const VectorRegister4Float DoubleMultiple = VectorSetFloat1(2.0f * ScreenMultiple);
+		const VectorRegister4Float One = VectorSetFloat1(1.0f);
+		const VectorRegister4Float Two = VectorSetFloat1(2.0f);
+		const VectorRegister4Float NearThreshold = VectorSetFloat1(0.000001f);
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4) {
+			const VectorRegister4Float Radius = VectorLoad(&ObjectSphereRadii[Index]);
+			const VectorRegister4Float Distance = VectorLoad(&Distances[Index]);
+			const VectorRegister4Float ScreenSize = VectorDivide(VectorMultiply(DoubleMultiple, Radius), VectorMax(Distance, One));
+			VectorStore(VectorSelect(VectorCompareLE(Distance, NearThreshold), Two, ScreenSize), &OutScreenSizes[Index]);
+		}
+		for (; Index < Num; Index++) {
+			OutScreenSizes[Index] = CalcScreenSize(ScreenMultiple, ObjectSphereRadii[Index], Distances[Index]);
+		}
+	}
+
+	void CalcObjectSphereRadii(float ScreenMultiple, TConstArrayView<float> ScreenSizes, TConstArrayView<float> Distances, TArrayView<float> OutRadii)
+	{
+		const int32 Num = FMath::Min3(ScreenSizes.Num(), Distances.Num(), OutRadii.Num());
+		const VectorRegister4Float InvDoubleMultiple = VectorSetFloat1(1.0f / (2.0f * ScreenMultiple));
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4) {
+			const VectorRegister4Float ScreenSize = VectorLoad(&ScreenSizes[Index]);
+			const VectorRegister4Float Distance = VectorLoad(&Distances[Index]);
+			VectorStore(VectorMultiply(VectorMultiply(ScreenSize, Distance), InvDoubleMultiple), &OutRadii[Index]);
+		}
+		for (; Index < Num; Index++) {
+			OutRadii[Index] = CalcObjectSphereRadius(ScreenMultiple, ScreenSizes[Index], Distances[Index]);
+		}
+	}
+}
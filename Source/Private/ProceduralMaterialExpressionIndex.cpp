@@ -0,0 +1,123 @@
+#include "ProceduralMaterialExpressionIndex.h"
+#include "ProceduralContentProcessorLibrary.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstance.h"
+#include "Materials/MaterialExpressionTime.h"
+#include "Materials/MaterialExpressionWorldPosition.h"
+#include "Materials/MaterialExpressionCustom.h"
+
+FProceduralMaterialExpressionIndex& FProceduralMaterialExpressionIndex::Get()
+{
+	static FProceduralMaterialExpressionIndex Instance;
+	return Instance;
+}
+
+FProceduralMaterialExpressionIndex::FProceduralMaterialExpressionIndex()
+{
+	OnMaterialCompilationFinishedHandle = UMaterial::OnMaterialCompilationFinished().AddRaw(this, &FProceduralMaterialExpressionIndex::OnMaterialCompilationFinished);
+	OnObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FProceduralMaterialExpressionIndex::OnObjectPropertyChanged);
+}
+
+FProceduralMaterialExpressionIndex::~FProceduralMaterialExpressionIndex()
+{
+	if (UObjectInitialized()) {
+		UMaterial::OnMaterialCompilationFinished().Remove(OnMaterialCompilationFinishedHandle);
+		FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(OnObjectPropertyChangedHandle);
+	}
+}
+
+UMaterial* FProceduralMaterialExpressionIndex::ResolveBaseMaterial(UMaterialInterface* InMaterial)
+{
+	if (InMaterial == nullptr)
+		return nullptr;
+	if (UMaterial* Material = Cast<UMaterial>(InMaterial))
+		return Material;
+	const FObjectKey Key(InMaterial);
+	if (const TWeakObjectPtr<UMaterial>* Cached = BaseMaterials.Find(Key)) {
+		if (Cached->IsValid()) {
+			return Cached->Get();
+		}
+	}
+	UMaterial* BaseMaterial = InMaterial->GetMaterial();
+	BaseMaterials.Add(Key, BaseMaterial);
+	return BaseMaterial;
+}
+
+const FProceduralMaterialExpressionIndex::FEntry* FProceduralMaterialExpressionIndex::FindOrBuild(UMaterialInterface* InMaterial)
+{
+	check(IsInGameThread());
+	UMaterial* Material = ResolveBaseMaterial(InMaterial);
+	if (Material == nullptr)
+		return nullptr;
+	const FObjectKey Key(Material);
+	if (const FEntry* Entry = Entries.Find(Key)) {
+		return Entry;
+	}
+	FEntry& Entry = Entries.Add(Key);
+	TArray<UMaterialExpression*> Expressions;
+	Material->GetAllExpressionsInMaterialAndFunctionsOfType(Expressions);
+	for (UMaterialExpression* Expression : Expressions) {
+		if (Expression == nullptr)
+			continue;
+		Entry.ExpressionClasses.Add(Expression->GetClass());
+		if (Expression->IsA<UMaterialExpressionTime>()) {
+			Entry.UsageFlags |= (int32)EProceduralMaterialUsage::Time;
+		}
+		else if (Expression->IsA<UMaterialExpressionWorldPosition>()) {
+			Entry.UsageFlags |= (int32)EProceduralMaterialUsage::WorldPosition;
+		}
+		else if (Expression->IsA<UMaterialExpressionCustom>()) {
+			Entry.UsageFlags |= (int32)EProceduralMaterialUsage::Custom;
+		}
+	}
+	if (Material->HasPixelDepthOffsetConnected()) {
+		Entry.UsageFlags |= (int32)EProceduralMaterialUsage::PixelDepthOffset;
+	}
+	if (Material->HasVertexPositionOffsetConnected()) {
+		Entry.UsageFlags |= (int32)EProceduralMaterialUsage::WorldPositionOffset;
+	}
+	return &Entry;
+}
+
+bool FProceduralMaterialExpressionIndex::HasExpression(UMaterialInterface* InMaterial, const UClass* InExpressionClass)
+{
+	if (InExpressionClass == nullptr)
+		return false;
+	if (const FEntry* Entry = FindOrBuild(InMaterial)) {
+		for (const UClass* Class : Entry->ExpressionClasses) {
+			if (Class->IsChildOf(InExpressionClass)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void FProceduralMaterialExpressionIndex::Invalidate(UMaterialInterface* InMaterial)
+{
+	if (InMaterial == nullptr)
+		return;
+	if (Cast<UMaterial>(InMaterial)) {
+		Entries.Remove(FObjectKey(InMaterial));
+	}
+	// Instances deriving from a changed one may resolve to another base material now, e.g. after a re-parent.
+	BaseMaterials.Reset();
+}
+
+void FProceduralMaterialExpressionIndex::Reset()
+{
+	Entries.Reset();
+	BaseMaterials.Reset();
+}
+
+void FProceduralMaterialExpressionIndex::OnMaterialCompilationFinished(UMaterialInterface* InMaterial)
+{
+	Invalidate(InMaterial);
+}
+
+void FProceduralMaterialExpressionIndex::OnObjectPropertyChanged(UObject* InObject, FPropertyChangedEvent& InEvent)
+{
+	if (UMaterialInstance* MaterialInstance = Cast<UMaterialInstance>(InObject)) {
+		Invalidate(MaterialInstance);
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UMaterial;
+class UMaterialInterface;
+
+/**
+ * Memoized per-UMaterial index of the expression classes used by its graph (functions included).
+ * Entries are dropped when the material finishes compiling, material instances resolve their base material through a cached parent chain.
+ */
+class FProceduralMaterialExpressionIndex
+{
+public:
+	struct FEntry {
+		TSet<const UClass*> ExpressionClasses;
+		int32 UsageFlags = 0;
+	};
+
+	static FProceduralMaterialExpressionIndex& Get();
+
+	~FProceduralMaterialExpressionIndex();
+
+	UMaterial* ResolveBaseMaterial(UMaterialInterface* InMaterial);
+
+	const FEntry* FindOrBuild(UMaterialInterface* InMaterial);
+
+	bool HasExpression(UMaterialInterface* InMaterial, const UClass* InExpressionClass);
+
+	void Invalidate(UMaterialInterface* InMaterial);
+
+	void Reset();
+private:
+	FProceduralMaterialExpressionIndex();
+
+	void OnMaterialCompilationFinished(UMaterialInterface* InMaterial);
+	void OnObjectPropertyChanged(UObject* InObject, FPropertyChangedEvent& InEvent);
+
+	TMap<FObjectKey, FEntry> Entries;
+	TMap<FObjectKey, TWeakObjectPtr<UMaterial>> BaseMaterials;
+	FDelegateHandle OnMaterialCompilationFinishedHandle;
+	FDelegateHandle OnObjectPropertyChangedHandle;
+};
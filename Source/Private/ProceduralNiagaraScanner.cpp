@@ -0,0 +1,131 @@
+#include "ProceduralNiagaraScanner.h"
+#include "NiagaraScript.h"
+#include "NiagaraRendererProperties.h"
+#include "NiagaraDataInterface.h"
+
+FProceduralNiagaraScanner& FProceduralNiagaraScanner::Get()
+{
+	static FProceduralNiagaraScanner Instance;
+	return Instance;
+}
+
+FNiagaraSystemInfo FProceduralNiagaraScanner::Scan(UNiagaraSystem* InSystem)
+{
+	TArray<FNiagaraSystemInfo> Infos = Scan(TArray<UNiagaraSystem*>{ InSystem });
+	return Infos.IsEmpty() ? FNiagaraSystemInfo() : MoveTemp(Infos[0]);
+}
+
+TArray<FNiagaraSystemInfo> FProceduralNiagaraScanner::Scan(const TArray<UNiagaraSystem*>& InSystems)
+{
+	check(IsInGameThread());
+	TArray<FNiagaraSystemInfo> Infos;
+	Infos.SetNum(InSystems.Num());
+	for (int32 SystemIndex = 0; SystemIndex < InSystems.Num(); SystemIndex++) {
+		const UNiagaraSystem* System = InSystems[SystemIndex];
+		if (System == nullptr)
+			continue;
+		FNiagaraSystemInfo& Info = Infos[SystemIndex];
+		FSoftObjectPath Path;
+		FIoHash SavedHash;
+		const bool bCacheable = GetCacheKey(System, Path, SavedHash);
+		const FCacheEntry* Entry = bCacheable ? Cache.Find(Path) : nullptr;
+		if (Entry && Entry->SavedHash == SavedHash) {
+			Info = Entry->Info;
+		}
+		else {
+			ScanSystem(System, Info);
+			if (bCacheable) {
+				Cache.Add(Path, { SavedHash, Info });
+			}
+		}
+		// Object references only ever come from the system passed in, a reloaded system never sees the ones of its previous instance.
+		FillEmitterData(System, Info);
+	}
+	return Infos;
+}
+
+void FProceduralNiagaraScanner::Reset()
+{
+	Cache.Reset();
+}
+
+bool FProceduralNiagaraScanner::GetCacheKey(const UNiagaraSystem* InSystem, FSoftObjectPath& OutPath, FIoHash& OutHash)
+{
+	const UPackage* Package = InSystem->GetPackage();
+	if (Package == nullptr || Package->IsDirty() || Package == GetTransientPackage())
+		return false;
+	OutHash = Package->GetSavedHash();
+	if (OutHash.IsZero())
+		return false;
+	OutPath = FSoftObjectPath(InSystem);
+	return true;
+}
+
+void FProceduralNiagaraScanner::FillEmitterData(const UNiagaraSystem* InSystem, FNiagaraSystemInfo& InOutInfo)
+{
+	const TArray<FNiagaraEmitterHandle>& EmitterHandles = InSystem->GetEmitterHandles();
+	for (int32 Index = 0; Index < EmitterHandles.Num() && Index < InOutInfo.Emitters.Num(); Index++) {
+		if (const FVersionedNiagaraEmitterData* EmitterData = EmitterHandles[Index].GetEmitterData()) {
+			InOutInfo.Emitters[Index].Data = *EmitterData;
+		}
+	}
+}
+
+void FProceduralNiagaraScanner::ScanSystem(const UNiagaraSystem* InSystem, FNiagaraSystemInfo& OutInfo)
+{
+	for (const FNiagaraEmitterHandle& EmitterHandle : InSystem->GetEmitterHandles()) {
+		const FVersionedNiagaraEmitterData* EmitterData = EmitterHandle.GetEmitterData();
+		FNiagaraEmitterInfo& EmitterInfo = OutInfo.Emitters.AddDefaulted_GetRef();
+		EmitterInfo.Name = EmitterHandle.GetName();
+		EmitterInfo.bEnabled = EmitterHandle.GetIsEnabled();
+		if (EmitterData == nullptr)
+			continue;
+		EmitterInfo.SimTarget = EmitterData->SimTarget;
+		EmitterInfo.PreAllocationCount = EmitterData->PreAllocationCount;
+		for (const UNiagaraRendererProperties* Renderer : EmitterData->GetRenderers()) {
+			if (Renderer) {
+				EmitterInfo.Renderers.Add(Renderer->GetClass()->GetName());
+			}
+		}
+
+		const FString NamePrefix = FString::Printf(TEXT("Constants.%s."), *EmitterHandle.GetUniqueInstanceName());
+		TArray<UNiagaraScript*> Scripts;
+		EmitterData->GetScripts(Scripts, false);
+		for (const UNiagaraScript* Script : Scripts) {
+			if (Script == nullptr)
+				continue;
+			const FNiagaraParameterStore& Store = Script->RapidIterationParameters;
+			for (const FNiagaraVariableWithOffset& Variable : Store.ReadParameterVariables()) {
+				FString Name = Variable.GetName().ToString();
+				if (!Name.RemoveFromStart(NamePrefix)) {
+					Name.RemoveFromStart(TEXT("Constants."));
+				}
+				EmitterInfo.Inputs.Add(Name, ExportParameterValue(Store, Variable));
+			}
+		}
+	}
+}
+
+FString FProceduralNiagaraScanner::ExportParameterValue(const FNiagaraParameterStore& InStore, const FNiagaraVariableWithOffset& InVariable)
+{
+	const FNiagaraTypeDefinition& Type = InVariable.GetType();
+	if (Type.IsDataInterface()) {
+		const UNiagaraDataInterface* DataInterface = InStore.GetDataInterface(InVariable.Offset);
+		return DataInterface ? DataInterface->GetClass()->GetName() : FString();
+	}
+	if (Type.IsUObject()) {
+		const UObject* Object = InStore.GetUObject(InVariable.Offset);
+		return Object ? Object->GetPathName() : FString();
+	}
+	const uint8* Data = InStore.GetParameterData(InVariable.Offset);
+	if (Data == nullptr)
+		return FString();
+	if (const UEnum* Enum = Type.GetEnum()) {
+		return Enum->GetNameStringByValue(*reinterpret_cast<const int32*>(Data));
+	}
+	FString Value;
+	if (UScriptStruct* ScriptStruct = Type.GetScriptStruct()) {
+		ScriptStruct->ExportText(Value, Data, nullptr, nullptr, PPF_None, nullptr);
+	}
+	return Value;
+}
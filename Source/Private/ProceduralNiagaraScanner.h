@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IO/IoHash.h"
+#include "ProceduralContentProcessorLibrary.h"
+
+/**
+ * Reads emitter handles, renderers and rapid iteration parameter values straight from the system data, no view models involved.
+ * Results are cached per asset path and package saved hash, dirty packages are always rescanned.
+ * The cache only holds plain values, the emitter data with its script and renderer objects is read from the live system on every call.
+ * Everything runs on the game thread, parameter values are exported through reflection.
+ */
+class FProceduralNiagaraScanner
+{
+public:
+	static FProceduralNiagaraScanner& Get();
+
+	FNiagaraSystemInfo Scan(UNiagaraSystem* InSystem);
+
+	TArray<FNiagaraSystemInfo> Scan(const TArray<UNiagaraSystem*>& InSystems);
+
+	void Reset();
+private:
+	struct FCacheEntry {
+		FIoHash SavedHash;
+		/** Without FNiagaraEmitterInfo::Data. */
+		FNiagaraSystemInfo Info;
+	};
+
+	static void FillEmitterData(const UNiagaraSystem* InSystem, FNiagaraSystemInfo& InOutInfo);
+	static void ScanSystem(const UNiagaraSystem* InSystem, FNiagaraSystemInfo& OutInfo);
+	static FString ExportParameterValue(const FNiagaraParameterStore& InStore, const FNiagaraVariableWithOffset& InVariable);
+	static bool GetCacheKey(const UNiagaraSystem* InSystem, FSoftObjectPath& OutPath, FIoHash& OutHash);
+
+	TMap<FSoftObjectPath, FCacheEntry> Cache;
+};
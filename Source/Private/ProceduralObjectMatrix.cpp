@@ -0,0 +1,43 @@
+#include "ProceduralObjectMatrix.h"
+
+void FProceduralObjectMatrix::SortRows(FName InColumn, EColumnSortMode::Type InSortMode)
+{
+	SortedColumnName = InColumn;
+	SortMode = InSortMode;
+	const bool bDescending = InSortMode == EColumnSortMode::Descending;
+	ObjectInfoList.StableSort([&](const TSharedPtr<FProceduralObjectMatrixRow>& Lhs, const TSharedPtr<FProceduralObjectMatrixRow>& Rhs) {
+		FString LhsValue;
+		if (auto LhsItem = Lhs->Find(InColumn)) {
+			LhsValue = LhsItem->GetText();
+		}
+		FString RhsValue;
+		if (auto RhsItem = Rhs->Find(InColumn)) {
+			RhsValue = RhsItem->GetText();
+		}
+		if (bDescending) {
+			Swap(LhsValue, RhsValue);
+		}
+		if (LhsValue.IsNumeric() && RhsValue.IsNumeric())
+			return FCString::Atod(*LhsValue) < FCString::Atod(*RhsValue);
+		return LhsValue < RhsValue;
+	});
+}
+
+void FProceduralObjectMatrix::SearchRows(const FString& InKeyword, TArray<TSharedPtr<FProceduralObjectMatrixRow>>& OutRows) const
+{
+	OutRows.Reset();
+	for (const auto& ObjectInfo : ObjectInfoList) {
+		if (!ObjectInfo->Owner.IsValid() && !ObjectInfo->AssetPath.IsValid())
+			continue;
+		if (ObjectInfo->GetName().Contains(InKeyword)) {
+			OutRows.Add(ObjectInfo);
+			continue;
+		}
+		for (const auto& Field : ObjectInfo->Fields) {
+			if (Field->GetText().Contains(InKeyword)) {
+				OutRows.Add(ObjectInfo);
+				break;
+			}
+		}
+	}
+}
@@ -16,6 +16,7 @@
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "ContentBrowserModule.h"
 #include "IContentBrowserSingleton.h"
+#include "AssetRegistry/AssetRegistryModule.h"
 
 #define LOCTEXT_NAMESPACE "ProceduralContentProcessor"
 
@@ -33,14 +34,15 @@ public:
 	}
 
 	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override {
-		if (ColumnName == "Name" && MatrixInfo->Owner.IsValid()) {
+		if (ColumnName == "Name" && (MatrixInfo->Owner.IsValid() || MatrixInfo->AssetPath.IsValid())) {
 			return SNew(SBox)
 				.HAlign(HAlign_Left)
 				.VAlign(VAlign_Center)
 				.Padding(4)
 				[
 					SNew(STextBlock)
-					.Text(FText::FromString(MatrixInfo->Owner->GetName()))
+					.Text(FText::FromString(MatrixInfo->GetName()))
+					.ToolTipText(FText::FromString(MatrixInfo->AssetPath.ToString()))
 				];
 		}		
 		if (auto Field = MatrixInfo->Find(ColumnName)) {
@@ -116,27 +118,7 @@ EColumnSortMode::Type FPropertyTypeCustomization_ProceduralObjectMatrix::GetColu
 
 void FPropertyTypeCustomization_ProceduralObjectMatrix::OnSort(EColumnSortPriority::Type InPriorityType, const FName& InName, EColumnSortMode::Type InType)
 {
-	ProceduralObjectMatrix->SortedColumnName = InName;
-	ProceduralObjectMatrix->SortMode = InType;
-
-	TFunction<bool(bool)> SortType = [](bool Var) {return Var; };
-	if (InType == EColumnSortMode::Descending) {
-		SortType = [](bool Var) {return !Var; };
-	}
-	ProceduralObjectMatrix->ObjectInfoList.StableSort([&](const TSharedPtr<FProceduralObjectMatrixRow>& Lhs, const TSharedPtr<FProceduralObjectMatrixRow>& Rhs) {
-		FString LhsValue;
-		if (auto LhsItem = Lhs->Find(InName)) {
-			LhsValue = LhsItem->GetText();
-		}
-		FString RhsValue;
-		if (auto RhsItem = Rhs->Find(InName)) {
-			RhsValue = RhsItem->GetText();
-		}
-		if (LhsValue.IsNumeric() && RhsValue.IsNumeric())
-			return SortType(FCString::Atod(*LhsValue) < FCString::Atod(*RhsValue));
-		return SortType(LhsValue < RhsValue);
-	});
-
+	ProceduralObjectMatrix->SortRows(InName, InType);
 	ProceduralObjectMatrix->ObjectInfoListView->RequestListRefresh();
 }
 
@@ -158,12 +140,19 @@ void FPropertyTypeCustomization_ProceduralObjectMatrix::OnMouseButtonDoubleClick
 			GEditor->GetSelectedActors()->EndBatchSelectOperation(/*bNotify*/false);
 			GEditor->NoteSelectionChange();
 		}
-		else if (InInfo->Owner->IsAsset()) {
+		else if (InInfo->Owner.IsValid() && InInfo->Owner->IsAsset()) {
 			FContentBrowserModule& ContentBrowserModule = FModuleManager::Get().LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
 			TArray<UObject*> SyncObjects;
 			SyncObjects.Add(InInfo->Owner.Get());
 			ContentBrowserModule.Get().SyncBrowserToAssets(SyncObjects, true);
 		}
+		else if (InInfo->AssetPath.IsValid()) {
+			const FAssetData AssetData = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get().GetAssetByObjectPath(InInfo->AssetPath);
+			if (AssetData.IsValid()) {
+				FContentBrowserModule& ContentBrowserModule = FModuleManager::Get().LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+				ContentBrowserModule.Get().SyncBrowserToAssets(TArray<FAssetData>{ AssetData }, true);
+			}
+		}
 	}
 }
 
@@ -176,23 +165,8 @@ void FPropertyTypeCustomization_ProceduralObjectMatrix::OnSearchBoxTextCommitted
 		CurrentSearchKeyword = FString();
 	}
 	else {
-		SearchInfoList.Reset();
 		CurrentSearchKeyword = InNewText.ToString();
-		for (auto& ObjectInfo : ProceduralObjectMatrix->ObjectInfoList) {
-			if (ObjectInfo->Owner.IsValid()) {
-				if (ObjectInfo->Owner->GetName().Contains(CurrentSearchKeyword)) {
-					SearchInfoList.Add(ObjectInfo);
-				}
-				else {
-					for (const auto& Field : ObjectInfo->Fields) {
-						if (Field->GetText().Contains(CurrentSearchKeyword)) {
-							SearchInfoList.Add(ObjectInfo);
-							break;
-						}
-					}
-				}
-			}
-		}
+		ProceduralObjectMatrix->SearchRows(CurrentSearchKeyword, SearchInfoList);
 		ProceduralObjectMatrix->ObjectInfoListView->SetListItemsSource(SearchInfoList);
 		CurrInfoList = &SearchInfoList;
 	}
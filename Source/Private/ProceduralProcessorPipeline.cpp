@@ -0,0 +1,341 @@
+#include "ProceduralProcessorPipeline.h"
+#include "ProceduralContentProcessor.h"
+#include "Tasks/Task.h"
+#include "UObject/GarbageCollection.h"
+#include "UObject/StrongObjectPtr.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogProceduralPipeline, Log, All);
+
+EProceduralPipelineDataType FProceduralPipelineData::GetPropertyType(const FProperty* InProperty)
+{
+	if (const FStructProperty* StructProperty = CastField<FStructProperty>(InProperty)) {
+		return StructProperty->Struct == FProceduralObjectMatrix::StaticStruct() ? EProceduralPipelineDataType::Matrix : EProceduralPipelineDataType::None;
+	}
+	if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(InProperty)) {
+		if (const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(ArrayProperty->Inner)) {
+			return ObjectProperty->PropertyClass->IsChildOf<AActor>() ? EProceduralPipelineDataType::Actors : EProceduralPipelineDataType::Objects;
+		}
+		if (const FStructProperty* StructProperty = CastField<FStructProperty>(ArrayProperty->Inner)) {
+			return StructProperty->Struct == TBaseStructure<FAssetData>::Get() ? EProceduralPipelineDataType::Assets : EProceduralPipelineDataType::None;
+		}
+	}
+	return EProceduralPipelineDataType::None;
+}
+
+bool FProceduralPipelineData::ReadFrom(const FProperty* InProperty, const void* InValue)
+{
+	Type = GetPropertyType(InProperty);
+	switch (Type) {
+	case EProceduralPipelineDataType::Matrix:
+		Matrix = *static_cast<const FProceduralObjectMatrix*>(InValue);
+		return true;
+	case EProceduralPipelineDataType::Assets:
+		Assets = *static_cast<const TArray<FAssetData>*>(InValue);
+		return true;
+	case EProceduralPipelineDataType::Actors:
+	case EProceduralPipelineDataType::Objects: {
+		const FArrayProperty* ArrayProperty = CastFieldChecked<FArrayProperty>(InProperty);
+		const FObjectPropertyBase* ObjectProperty = CastFieldChecked<FObjectPropertyBase>(ArrayProperty->Inner);
+		FScriptArrayHelper Helper(ArrayProperty, InValue);
+		for (int32 Index = 0; Index < Helper.Num(); Index++) {
+			UObject* Object = ObjectProperty->GetObjectPropertyValue(Helper.GetRawPtr(Index));
+			if (Type == EProceduralPipelineDataType::Actors) {
+				Actors.Add(CastChecked<AActor>(Object, ECastCheckedType::NullAllowed));
+			}
+			else {
+				Objects.Add(Object);
+			}
+		}
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+bool FProceduralPipelineData::WriteTo(const FProperty* InProperty, void* OutValue) const
+{
+	const EProceduralPipelineDataType PropertyType = GetPropertyType(InProperty);
+	// Actors are objects too, so an actor set may feed a TArray<UObject*> parameter.
+	const bool bCompatible = PropertyType == Type || (PropertyType == EProceduralPipelineDataType::Objects && Type == EProceduralPipelineDataType::Actors);
+	if (!bCompatible)
+		return false;
+	switch (PropertyType) {
+	case EProceduralPipelineDataType::Matrix:
+		*static_cast<FProceduralObjectMatrix*>(OutValue) = Matrix;
+		return true;
+	case EProceduralPipelineDataType::Assets:
+		*static_cast<TArray<FAssetData>*>(OutValue) = Assets;
+		return true;
+	case EProceduralPipelineDataType::Actors:
+	case EProceduralPipelineDataType::Objects: {
+		const FArrayProperty* ArrayProperty = CastFieldChecked<FArrayProperty>(InProperty);
+		const FObjectPropertyBase* ObjectProperty = CastFieldChecked<FObjectPropertyBase>(ArrayProperty->Inner);
+		FScriptArrayHelper Helper(ArrayProperty, OutValue);
+		auto AddObject = [&](UObject* Object) {
+			if (Object && Object->IsA(ObjectProperty->PropertyClass)) {
+				const int32 Index = Helper.AddValue();
+				ObjectProperty->SetObjectPropertyValue(Helper.GetRawPtr(Index), Object);
+			}
+		};
+		if (Type == EProceduralPipelineDataType::Actors) {
+			for (AActor* Actor : Actors) {
+				AddObject(Actor);
+			}
+		}
+		else {
+			for (UObject* Object : Objects) {
+				AddObject(Object);
+			}
+		}
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+int32 FProceduralPipelineData::Num() const
+{
+	switch (Type) {
+	case EProceduralPipelineDataType::Actors:	return Actors.Num();
+	case EProceduralPipelineDataType::Assets:	return Assets.Num();
+	case EProceduralPipelineDataType::Objects:	return Objects.Num();
+	case EProceduralPipelineDataType::Matrix:	return Matrix.ObjectInfoList.Num();
+	default:									return 0;
+	}
+}
+
+bool UProceduralProcessorPipeline::BuildLevels(TArray<TArray<int32>>& OutLevels, FString& OutError) const
+{
+	OutLevels.Reset();
+	TMap<FName, int32> NodeIndices;
+	for (int32 Index = 0; Index < Nodes.Num(); Index++) {
+		if (Nodes[Index].Name.IsNone() || NodeIndices.Contains(Nodes[Index].Name)) {
+			OutError = FString::Printf(TEXT("Node %d has an empty or duplicated name"), Index);
+			return false;
+		}
+		NodeIndices.Add(Nodes[Index].Name, Index);
+	}
+
+	TArray<int32> InDegree;
+	InDegree.SetNumZeroed(Nodes.Num());
+	TArray<TArray<int32>> Successors;
+	Successors.SetNum(Nodes.Num());
+	for (int32 Index = 0; Index < Nodes.Num(); Index++) {
+		TSet<FName> Upstream(Nodes[Index].Dependencies);
+		for (const FProceduralPipelineInput& Input : Nodes[Index].Inputs) {
+			Upstream.Add(Input.SourceNode);
+		}
+		for (FName Dependency : Upstream) {
+			const int32* DependencyIndex = NodeIndices.Find(Dependency);
+			if (DependencyIndex == nullptr) {
+				OutError = FString::Printf(TEXT("%s depends on unknown node %s"), *Nodes[Index].Name.ToString(), *Dependency.ToString());
+				return false;
+			}
+			Successors[*DependencyIndex].Add(Index);
+			InDegree[Index]++;
+		}
+	}
+
+	TArray<int32> Level;
+	for (int32 Index = 0; Index < Nodes.Num(); Index++) {
+		if (InDegree[Index] == 0) {
+			Level.Add(Index);
+		}
+	}
+	int32 NumVisited = 0;
+	while (!Level.IsEmpty()) {
+		NumVisited += Level.Num();
+		TArray<int32> NextLevel;
+		for (int32 Index : Level) {
+			for (int32 Successor : Successors[Index]) {
+				if (--InDegree[Successor] == 0) {
+					NextLevel.Add(Successor);
+				}
+			}
+		}
+		OutLevels.Add(MoveTemp(Level));
+		Level = MoveTemp(NextLevel);
+	}
+	if (NumVisited != Nodes.Num()) {
+		OutError = TEXT("The pipeline contains a cycle");
+		return false;
+	}
+	return true;
+}
+
+TArray<FName> UProceduralProcessorPipeline::GetNodeNames() const
+{
+	TArray<FName> Names;
+	for (const FProceduralPipelineNode& Node : Nodes) {
+		Names.Add(Node.Name);
+	}
+	return Names;
+}
+
+namespace
+{
+	struct FPipelineInvocation {
+		const FProceduralPipelineNode* Node = nullptr;
+		TStrongObjectPtr<UProceduralContentProcessor> Processor;
+		UFunction* Function = nullptr;
+		uint8* Parms = nullptr;
+		bool bConcurrent = false;
+		double Seconds = 0.0;
+
+		void Invoke() {
+			const double StartTime = FPlatformTime::Seconds();
+			Processor->ProcessEvent(Function, Parms);
+			Seconds = FPlatformTime::Seconds() - StartTime;
+		}
+
+		void ReleaseParms() {
+			if (Parms == nullptr)
+				return;
+			for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It) {
+				It->DestroyValue_InContainer(Parms);
+			}
+			FMemory::Free(Parms);
+			Parms = nullptr;
+		}
+	};
+}
+
+bool UProceduralProcessorPipeline::Execute(UWorld* InWorld, FName FromNode, TMap<FName, FProceduralPipelineNodeResult>& InOutCache) const
+{
+	TArray<TArray<int32>> Levels;
+	FString Error;
+	if (!BuildLevels(Levels, Error)) {
+		UE_LOG(LogProceduralPipeline, Error, TEXT("%s: %s"), *GetName(), *Error);
+		return false;
+	}
+
+	TSet<FName> Executed;
+	for (const TArray<int32>& Level : Levels) {
+		TArray<FPipelineInvocation> Invocations;
+		bool bValid = true;
+		for (int32 NodeIndex : Level) {
+			const FProceduralPipelineNode& Node = Nodes[NodeIndex];
+			bool bRun = FromNode.IsNone() || FromNode == Node.Name || !InOutCache.Contains(Node.Name) || !InOutCache[Node.Name].bSucceeded;
+			for (const FProceduralPipelineInput& Input : Node.Inputs) {
+				bRun |= Executed.Contains(Input.SourceNode);
+			}
+			for (FName Dependency : Node.Dependencies) {
+				bRun |= Executed.Contains(Dependency);
+			}
+			if (!bRun) {
+				UE_LOG(LogProceduralPipeline, Display, TEXT("%s: reusing cached result"), *Node.Name.ToString());
+				continue;
+			}
+			Executed.Add(Node.Name);
+
+			if (Node.ProcessorClass == nullptr || Node.ProcessorClass->HasAnyClassFlags(CLASS_Abstract)) {
+				UE_LOG(LogProceduralPipeline, Error, TEXT("%s: invalid processor class"), *Node.Name.ToString());
+				bValid = false;
+				break;
+			}
+			UProceduralContentProcessor* Processor = NewObject<UProceduralContentProcessor>(GetTransientPackage(), Node.ProcessorClass, NAME_None, RF_Transient);
+			UFunction* Function = Processor->FindFunction(Node.FunctionName);
+			if (Function == nullptr) {
+				UE_LOG(LogProceduralPipeline, Error, TEXT("%s: function %s not found on %s"), *Node.Name.ToString(), *Node.FunctionName.ToString(), *Node.ProcessorClass->GetName());
+				bValid = false;
+				break;
+			}
+			FPipelineInvocation& Invocation = Invocations.AddDefaulted_GetRef();
+			Invocation.Node = &Node;
+			Invocation.Processor.Reset(Processor);
+			Invocation.Processor->LoadConfig();
+			Invocation.Function = Function;
+			Invocation.bConcurrent = Node.bAllowConcurrent && Invocation.Function->HasMetaData(TEXT("BlueprintThreadSafe"));
+			if (UProceduralWorldProcessor* WorldProcessor = Cast<UProceduralWorldProcessor>(Invocation.Processor.Get())) {
+				WorldProcessor->SetWorldOverride(InWorld);
+			}
+
+			Invocation.Parms = static_cast<uint8*>(FMemory::Malloc(FMath::Max<int32>(Invocation.Function->ParmsSize, 1), Invocation.Function->GetMinAlignment()));
+			FMemory::Memzero(Invocation.Parms, Invocation.Function->ParmsSize);
+			for (TFieldIterator<FProperty> It(Invocation.Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It) {
+				It->InitializeValue_InContainer(Invocation.Parms);
+			}
+			for (const FProceduralPipelineInput& Input : Node.Inputs) {
+				const FProceduralPipelineNodeResult* SourceResult = InOutCache.Find(Input.SourceNode);
+				const FProceduralPipelineData* Data = SourceResult ? SourceResult->Outputs.Find(Input.SourceOutput) : nullptr;
+				if (Data == nullptr) {
+					UE_LOG(LogProceduralPipeline, Error, TEXT("%s: %s.%s has no value"), *Node.Name.ToString(), *Input.SourceNode.ToString(), *Input.SourceOutput.ToString());
+					bValid = false;
+					continue;
+				}
+				if (Input.Parameter == TEXT("AssetsToProcess")) {
+					if (UProceduralAssetProcessor* AssetProcessor = Cast<UProceduralAssetProcessor>(Invocation.Processor.Get())) {
+						AssetProcessor->SetAssetsToProcess(Data->Assets);
+						continue;
+					}
+				}
+				const FProperty* Property = Invocation.Function->FindPropertyByName(Input.Parameter);
+				if (Property == nullptr || !Data->WriteTo(Property, Property->ContainerPtrToValuePtr<void>(Invocation.Parms))) {
+					UE_LOG(LogProceduralPipeline, Error, TEXT("%s: %s.%s does not match parameter %s"), *Node.Name.ToString(), *Input.SourceNode.ToString(), *Input.SourceOutput.ToString(), *Input.Parameter.ToString());
+					bValid = false;
+				}
+			}
+		}
+		if (!bValid) {
+			for (FPipelineInvocation& Invocation : Invocations) {
+				Invocation.ReleaseParms();
+			}
+			return false;
+		}
+
+		// Thread safe nodes of this level run on workers while the rest run on the game thread, the next level waits for both.
+		// A game thread node may collect garbage, the workers hold it off until their objects are no longer in use.
+		TArray<UE::Tasks::FTask> Tasks;
+		for (FPipelineInvocation& Invocation : Invocations) {
+			if (Invocation.Node->bActivate) {
+				Invocation.Processor->Activate();
+			}
+			if (Invocation.bConcurrent) {
+				Tasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [&Invocation]() {
+					FGCScopeGuard GCGuard;
+					Invocation.Invoke();
+				}));
+			}
+		}
+		for (FPipelineInvocation& Invocation : Invocations) {
+			if (!Invocation.bConcurrent) {
+				Invocation.Invoke();
+			}
+		}
+		UE::Tasks::Wait(Tasks);
+
+		for (FPipelineInvocation& Invocation : Invocations) {
+			FProceduralPipelineNodeResult& Result = InOutCache.FindOrAdd(Invocation.Node->Name);
+			Result = FProceduralPipelineNodeResult();
+			Result.bSucceeded = true;
+			Result.Seconds = float(Invocation.Seconds);
+			for (TFieldIterator<FProperty> It(Invocation.Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It) {
+				if (It->HasAnyPropertyFlags(CPF_ReturnParm) || (It->HasAnyPropertyFlags(CPF_OutParm) && !It->HasAnyPropertyFlags(CPF_ConstParm))) {
+					FProceduralPipelineData Data;
+					if (Data.ReadFrom(*It, It->ContainerPtrToValuePtr<void>(Invocation.Parms))) {
+						Result.Outputs.Add(It->GetFName(), MoveTemp(Data));
+					}
+					else if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(*It); BoolProperty && It->HasAnyPropertyFlags(CPF_ReturnParm)) {
+						// A bool return value reports failure and stops the downstream nodes.
+						Result.bSucceeded = BoolProperty->GetPropertyValue_InContainer(Invocation.Parms);
+					}
+				}
+			}
+			Invocation.ReleaseParms();
+			if (Invocation.Node->bActivate) {
+				Invocation.Processor->Deactivate();
+			}
+			if (UProceduralWorldProcessor* WorldProcessor = Cast<UProceduralWorldProcessor>(Invocation.Processor.Get())) {
+				WorldProcessor->SetWorldOverride(nullptr);
+			}
+			UE_LOG(LogProceduralPipeline, Display, TEXT("%s: %s in %.2fs"), *Invocation.Node->Name.ToString(), Result.bSucceeded ? TEXT("succeeded") : TEXT("failed"), Result.Seconds);
+		}
+		for (const FPipelineInvocation& Invocation : Invocations) {
+			if (!InOutCache[Invocation.Node->Name].bSucceeded)
+				return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,89 @@
+#include "ProceduralProfiler.h"
+#include "UObject/UObjectArray.h"
+#include "HAL/PlatformMemory.h"
+
+TRACE_DECLARE_INT_COUNTER(ProceduralContentProcessor_InstancesAdded, TEXT("ProceduralContentProcessor/InstancesAdded"));
+TRACE_DECLARE_INT_COUNTER(ProceduralContentProcessor_ActorsSpawned, TEXT("ProceduralContentProcessor/ActorsSpawned"));
+TRACE_DECLARE_INT_COUNTER(ProceduralContentProcessor_AssetsLoaded, TEXT("ProceduralContentProcessor/AssetsLoaded"));
+
+TSharedPtr<FProceduralProfiler::FNode> FProceduralProfiler::FNode::FindOrAddChild(FName InName)
+{
+	for (const TSharedPtr<FNode>& Child : Children) {
+		if (Child->Name == InName)
+			return Child;
+	}
+	TSharedPtr<FNode> Child = MakeShared<FNode>();
+	Child->Name = InName;
+	Children.Add(Child);
+	return Child;
+}
+
+FProceduralProfiler::FScope::FScope(FName InName, bool bInRoot)
+{
+	// Worker threads still show up in the Insights trace, the call tree only follows the game thread.
+	if (!IsInGameThread())
+		return;
+	FProceduralProfiler& Profiler = FProceduralProfiler::Get();
+	if (!bInRoot && !Profiler.IsRecording())
+		return;
+	Profiler.BeginScope(InName);
+	bActive = true;
+}
+
+FProceduralProfiler::FScope::~FScope()
+{
+	if (bActive) {
+		FProceduralProfiler::Get().EndScope();
+	}
+}
+
+FProceduralProfiler& FProceduralProfiler::Get()
+{
+	static FProceduralProfiler Instance;
+	return Instance;
+}
+
+void FProceduralProfiler::BeginScope(FName InName)
+{
+	FFrame& Frame = Stack.AddDefaulted_GetRef();
+	if (Stack.Num() == 1) {
+		Frame.Node = MakeShared<FNode>();
+		Frame.Node->Name = InName;
+	}
+	else {
+		Frame.Node = Stack[Stack.Num() - 2].Node->FindOrAddChild(InName);
+	}
+	Frame.StartObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	Frame.StartMemory = FPlatformMemory::GetStats().UsedPhysical;
+	Frame.StartSeconds = FPlatformTime::Seconds();
+}
+
+void FProceduralProfiler::EndScope()
+{
+	if (Stack.IsEmpty())
+		return;
+	FFrame Frame = Stack.Pop();
+	const double Seconds = FPlatformTime::Seconds() - Frame.StartSeconds;
+	FNode& Node = *Frame.Node;
+	Node.Calls++;
+	Node.InclusiveSeconds += Seconds;
+	Node.SelfSeconds += Seconds - Frame.ChildSeconds;
+	Node.ObjectsCreated += GUObjectArray.GetObjectArrayNumMinusAvailable() - Frame.StartObjects;
+	Node.MemoryDelta += (int64)FPlatformMemory::GetStats().UsedPhysical - (int64)Frame.StartMemory;
+	if (!Stack.IsEmpty()) {
+		Stack.Last().ChildSeconds += Seconds;
+	}
+	else {
+		LastRun = Frame.Node;
+		OnRunFinished.Broadcast();
+	}
+}
+
+void FProceduralProfiler::AddCounter(FName InCounter, int64 InDelta)
+{
+	if (!IsInGameThread())
+		return;
+	for (FFrame& Frame : Stack) {
+		Frame.Node->Counters.FindOrAdd(InCounter) += InDelta;
+	}
+}
@@ -0,0 +1,273 @@
+#include "ProceduralShardCoordinator.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogProceduralShardCoordinator, Log, All);
+
+FProceduralShardCoordinator::FProceduralShardCoordinator(FProceduralShardSettings InSettings)
+	: Settings(MoveTemp(InSettings))
+{
+	Settings.NumWorkers = FMath::Max(1, Settings.NumWorkers);
+	Settings.NumShardsPerWorker = FMath::Max(1, Settings.NumShardsPerWorker);
+	Settings.MaxRetries = FMath::Max(0, Settings.MaxRetries);
+}
+
+FProceduralShardCoordinator::~FProceduralShardCoordinator()
+{
+	if (bRunning) {
+		OnCompleted = nullptr;
+		Cancel();
+	}
+}
+
+bool FProceduralShardCoordinator::Start()
+{
+	check(!bRunning);
+	if (Settings.Assets.IsEmpty() || Settings.ProcessorClassPath.IsEmpty() || Settings.FunctionName.IsEmpty())
+		return false;
+
+	WorkingDirectory = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("ProceduralContentProcessor/Shards") / FGuid::NewGuid().ToString());
+	if (!IFileManager::Get().MakeDirectory(*WorkingDirectory, true)) {
+		UE_LOG(LogProceduralShardCoordinator, Error, TEXT("Failed to create %s"), *WorkingDirectory);
+		return false;
+	}
+
+	// Neighbouring packages tend to share dependencies, keeping them in one shard avoids loading them in several workers.
+	Settings.Assets.Sort([](const FSoftObjectPath& A, const FSoftObjectPath& B) {
+		return A.ToString() < B.ToString();
+	});
+	const int32 NumShards = FMath::Min(Settings.Assets.Num(), Settings.NumWorkers * Settings.NumShardsPerWorker);
+	const int32 AssetsPerShard = FMath::DivideAndRoundUp(Settings.Assets.Num(), NumShards);
+	for (int32 ShardBegin = 0, ShardEnd = 0; ShardBegin < Settings.Assets.Num(); ShardBegin = ShardEnd) {
+		// Workers only save the packages of their own shard, so a package must never be split across shards.
+		ShardEnd = FMath::Min(ShardBegin + AssetsPerShard, Settings.Assets.Num());
+		while (ShardEnd < Settings.Assets.Num() && Settings.Assets[ShardEnd].GetLongPackageFName() == Settings.Assets[ShardEnd - 1].GetLongPackageFName()) {
+			ShardEnd++;
+		}
+		FShard& Shard = Shards.AddDefaulted_GetRef();
+		Shard.AssetListFilename = WorkingDirectory / FString::Printf(TEXT("Shard_%d.txt"), Shards.Num() - 1);
+		Shard.ResultFilename = WorkingDirectory / FString::Printf(TEXT("Shard_%d.json"), Shards.Num() - 1);
+		TArray<FString> Lines;
+		for (int32 AssetIndex = ShardBegin; AssetIndex < ShardEnd; AssetIndex++) {
+			Lines.Add(Settings.Assets[AssetIndex].ToString());
+		}
+		FFileHelper::SaveStringArrayToFile(Lines, *Shard.AssetListFilename);
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	Result = FProceduralShardedRunResult();
+	Result.NumShards = Shards.Num();
+	MergedResults.Reset();
+	UnsavedPackages.Reset();
+	bRunning = true;
+	UE_LOG(LogProceduralShardCoordinator, Display, TEXT("Processing %d assets in %d shards with %d workers"), Settings.Assets.Num(), Shards.Num(), Settings.NumWorkers);
+	return true;
+}
+
+void FProceduralShardCoordinator::RunAsync(TFunction<void(const FProceduralShardedRunResult&)> InOnCompleted)
+{
+	OnCompleted = MoveTemp(InOnCompleted);
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSPLambda(this, [this](float) {
+		return Poll();
+	}), 0.5f);
+}
+
+FProceduralShardedRunResult FProceduralShardCoordinator::RunBlocking()
+{
+	while (Poll()) {
+		FPlatformProcess::Sleep(0.5f);
+	}
+	return Result;
+}
+
+void FProceduralShardCoordinator::Cancel()
+{
+	if (!bRunning)
+		return;
+	for (FShard& Shard : Shards) {
+		if (Shard.Process.IsValid()) {
+			FPlatformProcess::TerminateProc(Shard.Process, true);
+			FPlatformProcess::CloseProc(Shard.Process);
+		}
+		if (!Shard.bDone) {
+			Shard.bDone = true;
+			Shard.bFailed = true;
+		}
+	}
+	Finish();
+}
+
+bool FProceduralShardCoordinator::Poll()
+{
+	if (!bRunning)
+		return false;
+	int32 NumRunning = 0;
+	for (int32 ShardIndex = 0; ShardIndex < Shards.Num(); ShardIndex++) {
+		FShard& Shard = Shards[ShardIndex];
+		if (Shard.bDone || !Shard.Process.IsValid())
+			continue;
+		if (FPlatformProcess::IsProcRunning(Shard.Process)) {
+			NumRunning++;
+			continue;
+		}
+		int32 ReturnCode = -1;
+		FPlatformProcess::GetProcReturnCode(Shard.Process, &ReturnCode);
+		FPlatformProcess::CloseProc(Shard.Process);
+		if (ReturnCode == 0 && MergeShardResult(Shard)) {
+			Shard.bDone = true;
+		}
+		else if (Shard.Attempts <= Settings.MaxRetries) {
+			UE_LOG(LogProceduralShardCoordinator, Warning, TEXT("Shard %d failed with code %d, retrying"), ShardIndex, ReturnCode);
+			Result.NumRetries++;
+		}
+		else {
+			UE_LOG(LogProceduralShardCoordinator, Error, TEXT("Shard %d failed with code %d after %d attempts"), ShardIndex, ReturnCode, Shard.Attempts);
+			Shard.bDone = true;
+			Shard.bFailed = true;
+		}
+	}
+
+	for (FShard& Shard : Shards) {
+		if (NumRunning >= Settings.NumWorkers)
+			break;
+		if (Shard.bDone || Shard.Process.IsValid())
+			continue;
+		if (LaunchShard(Shard)) {
+			NumRunning++;
+		}
+		else if (Shard.Attempts > Settings.MaxRetries) {
+			Shard.bDone = true;
+			Shard.bFailed = true;
+		}
+	}
+
+	if (Shards.ContainsByPredicate([](const FShard& Shard) { return !Shard.bDone; })) {
+		return true;
+	}
+	TickerHandle.Reset();
+	Finish();
+	return false;
+}
+
+bool FProceduralShardCoordinator::LaunchShard(FShard& InShard)
+{
+	FString Executable = FPlatformProcess::ExecutablePath();
+#if PLATFORM_WINDOWS
+	if (!Executable.EndsWith(TEXT("-Cmd.exe"))) {
+		const FString CmdExecutable = FPaths::GetBaseFilename(Executable, false) + TEXT("-Cmd.exe");
+		if (FPaths::FileExists(CmdExecutable)) {
+			Executable = CmdExecutable;
+		}
+	}
+#endif
+	const FString ProjectFile = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	const FString Arguments = FString::Printf(TEXT("\"%s\" -run=ProceduralContentProcessor -Processor=\"%s\" -Function=%s -AssetList=\"%s\" -Report=\"%s\"%s -nullrhi -unattended -nopause -nosplash -stdout"),
+		*ProjectFile,
+		*Settings.ProcessorClassPath,
+		*Settings.FunctionName,
+		*InShard.AssetListFilename,
+		*InShard.ResultFilename,
+		Settings.bSavePackages ? TEXT(" -SaveAssetListOnly") : TEXT(" -NoSave"));
+	IFileManager::Get().Delete(*InShard.ResultFilename, false, true, true);
+	InShard.Attempts++;
+	InShard.Process = FPlatformProcess::CreateProc(*Executable, *Arguments, false, true, true, nullptr, 0, nullptr, nullptr);
+	if (!InShard.Process.IsValid()) {
+		UE_LOG(LogProceduralShardCoordinator, Error, TEXT("Failed to launch worker %s %s"), *Executable, *Arguments);
+		return false;
+	}
+	return true;
+}
+
+bool FProceduralShardCoordinator::MergeShardResult(const FShard& InShard)
+{
+	FString Json;
+	if (!FFileHelper::LoadFileToString(Json, *InShard.ResultFilename))
+		return false;
+	TSharedPtr<FJsonObject> Report;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Report) || !Report.IsValid())
+		return false;
+	if (!Report->GetBoolField(TEXT("Succeeded")))
+		return false;
+	const TArray<TSharedPtr<FJsonValue>>* Unsaved = nullptr;
+	if (Report->TryGetArrayField(TEXT("UnsavedPackages"), Unsaved)) {
+		for (const TSharedPtr<FJsonValue>& Value : *Unsaved) {
+			UnsavedPackages.Add(Value->AsString());
+		}
+	}
+	const TArray<TSharedPtr<FJsonValue>>* Results = nullptr;
+	if (Report->TryGetArrayField(TEXT("Results"), Results)) {
+		for (const TSharedPtr<FJsonValue>& Value : *Results) {
+			const TSharedPtr<FJsonObject>& Entry = Value->AsObject();
+			if (!Entry.IsValid())
+				continue;
+			TMap<FName, FString>& Fields = MergedResults.FindOrAdd(FSoftObjectPath(Entry->GetStringField(TEXT("Asset"))));
+			const TSharedPtr<FJsonObject>* FieldsObject = nullptr;
+			if (Entry->TryGetObjectField(TEXT("Fields"), FieldsObject)) {
+				for (const auto& Field : (*FieldsObject)->Values) {
+					Fields.Add(*Field.Key, Field.Value->AsString());
+				}
+			}
+		}
+	}
+	return true;
+}
+
+void FProceduralShardCoordinator::Finish()
+{
+	if (TickerHandle.IsValid()) {
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	bRunning = false;
+	Result.NumFailedShards = Shards.FilterByPredicate([](const FShard& Shard) { return Shard.bFailed; }).Num();
+	Result.UnsavedPackages = UnsavedPackages.Array();
+	Result.UnsavedPackages.Sort();
+	for (const FString& PackageName : Result.UnsavedPackages) {
+		UE_LOG(LogProceduralShardCoordinator, Error, TEXT("%s was modified outside the shard that owns it and was not saved"), *PackageName);
+	}
+	Result.bSucceeded = Result.NumFailedShards == 0 && Result.UnsavedPackages.IsEmpty();
+	Result.TotalSeconds = float(FPlatformTime::Seconds() - StartTime);
+	Result.Results.Reset(MergedResults.Num());
+	for (const auto& Pair : MergedResults) {
+		FProceduralAssetResult& AssetResult = Result.Results.AddDefaulted_GetRef();
+		AssetResult.Asset = Pair.Key;
+		AssetResult.Fields = Pair.Value;
+	}
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("Processor"), Settings.ProcessorClassPath);
+	Report->SetStringField(TEXT("Function"), Settings.FunctionName);
+	Report->SetBoolField(TEXT("Succeeded"), Result.bSucceeded);
+	Report->SetNumberField(TEXT("Shards"), Result.NumShards);
+	Report->SetNumberField(TEXT("FailedShards"), Result.NumFailedShards);
+	Report->SetNumberField(TEXT("Retries"), Result.NumRetries);
+	Report->SetNumberField(TEXT("TotalSeconds"), Result.TotalSeconds);
+	TArray<TSharedPtr<FJsonValue>> Results;
+	for (const FProceduralAssetResult& AssetResult : Result.Results) {
+		TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+		Entry->SetStringField(TEXT("Asset"), AssetResult.Asset.ToString());
+		TSharedRef<FJsonObject> Fields = MakeShared<FJsonObject>();
+		for (const auto& Field : AssetResult.Fields) {
+			Fields->SetStringField(Field.Key.ToString(), Field.Value);
+		}
+		Entry->SetObjectField(TEXT("Fields"), Fields);
+		Results.Add(MakeShared<FJsonValueObject>(Entry));
+	}
+	Report->SetArrayField(TEXT("Results"), Results);
+	TArray<TSharedPtr<FJsonValue>> Unsaved;
+	for (const FString& PackageName : Result.UnsavedPackages) {
+		Unsaved.Add(MakeShared<FJsonValueString>(PackageName));
+	}
+	Report->SetArrayField(TEXT("UnsavedPackages"), Unsaved);
+	Result.ReportFilename = WorkingDirectory / TEXT("Report.json");
+	FString Json;
+	FJsonSerializer::Serialize(Report, TJsonWriterFactory<>::Create(&Json));
+	FFileHelper::SaveStringToFile(Json, *Result.ReportFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+
+	UE_LOG(LogProceduralShardCoordinator, Display, TEXT("Sharded run finished in %.1fs, %d/%d shards failed, %d retries"), Result.TotalSeconds, Result.NumFailedShards, Result.NumShards, Result.NumRetries);
+	if (TFunction<void(const FProceduralShardedRunResult&)> Callback = MoveTemp(OnCompleted)) {
+		Callback(Result);
+	}
+}
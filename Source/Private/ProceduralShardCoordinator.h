@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "ProceduralContentProcessor.h"
+
+struct FProceduralShardSettings
+{
+	FString ProcessorClassPath;
+	FString FunctionName;
+	TArray<FSoftObjectPath> Assets;
+	int32 NumWorkers = 4;
+	int32 NumShardsPerWorker = 4;
+	int32 MaxRetries = 2;
+	bool bSavePackages = true;
+};
+
+/**
+ * Splits an asset list into shards and processes them in local "-run=ProceduralContentProcessor" worker processes.
+ * Every shard is exchanged through files in Saved/ProceduralContentProcessor/Shards, a shard whose worker crashes
+ * or returns a failure is relaunched until MaxRetries is exhausted.
+ * Each package belongs to exactly one shard and only that shard's worker saves it, packages a worker dirtied
+ * outside its shard are left unsaved and fail the run.
+ */
+class FProceduralShardCoordinator : public TSharedFromThis<FProceduralShardCoordinator>
+{
+public:
+	FProceduralShardCoordinator(FProceduralShardSettings InSettings);
+	~FProceduralShardCoordinator();
+
+	bool Start();
+
+	/** Polls the workers from the core ticker, OnCompleted is called on the game thread. */
+	void RunAsync(TFunction<void(const FProceduralShardedRunResult&)> InOnCompleted);
+
+	/** Blocks until every shard finished, used by the commandlet. */
+	FProceduralShardedRunResult RunBlocking();
+
+	void Cancel();
+
+	bool IsRunning() const { return bRunning; }
+private:
+	struct FShard {
+		FString AssetListFilename;
+		FString ResultFilename;
+		FProcHandle Process;
+		int32 Attempts = 0;
+		bool bDone = false;
+		bool bFailed = false;
+	};
+
+	bool Poll();
+	bool LaunchShard(FShard& InShard);
+	bool MergeShardResult(const FShard& InShard);
+	void Finish();
+
+	FProceduralShardSettings Settings;
+	FString WorkingDirectory;
+	TArray<FShard> Shards;
+	TMap<FSoftObjectPath, TMap<FName, FString>> MergedResults;
+	TSet<FString> UnsavedPackages;
+	FProceduralShardedRunResult Result;
+	TFunction<void(const FProceduralShardedRunResult&)> OnCompleted;
+	FTSTicker::FDelegateHandle TickerHandle;
+	double StartTime = 0.0;
+	bool bRunning = false;
+};
@@ -0,0 +1,109 @@
+#include "ProceduralStringMatcher.h"
+#include "ProceduralContentProcessorLibrary.h"
+#include "Async/ParallelFor.h"
+
+FProceduralStringAutomaton::FProceduralStringAutomaton(const TArray<FString>& InPatterns)
+{
+	Nodes.AddDefaulted();
+	for (const FString& Pattern : InPatterns) {
+		if (Pattern.IsEmpty())
+			continue;
+		int32 State = 0;
+		for (TCHAR Char : Pattern) {
+			Char = FChar::ToUpper(Char);
+			if (const int32* Next = Nodes[State].Next.Find(Char)) {
+				State = *Next;
+			}
+			else {
+				const int32 NewState = Nodes.AddDefaulted();
+				Nodes[State].Next.Add(Char, NewState);
+				State = NewState;
+			}
+		}
+		Nodes[State].bTerminal = true;
+		bIsEmpty = false;
+	}
+
+	TArray<int32> Queue;
+	for (const auto& Pair : Nodes[0].Next) {
+		Queue.Add(Pair.Value);
+	}
+	for (int32 QueueIndex = 0; QueueIndex < Queue.Num(); QueueIndex++) {
+		const int32 State = Queue[QueueIndex];
+		for (const auto& Pair : Nodes[State].Next) {
+			const int32 Child = Pair.Value;
+			int32 Fail = Nodes[State].Fail;
+			while (Fail != 0 && !Nodes[Fail].Next.Contains(Pair.Key)) {
+				Fail = Nodes[Fail].Fail;
+			}
+			const int32* FailNext = Nodes[Fail].Next.Find(Pair.Key);
+			Nodes[Child].Fail = (FailNext && *FailNext != Child) ? *FailNext : 0;
+			Nodes[Child].bTerminal |= Nodes[Nodes[Child].Fail].bTerminal;
+			Queue.Add(Child);
+		}
+	}
+}
+
+int32 FProceduralStringAutomaton::FindNext(int32 State, TCHAR Char) const
+{
+	while (true) {
+		if (const int32* Next = Nodes[State].Next.Find(Char)) {
+			return *Next;
+		}
+		if (State == 0) {
+			return 0;
+		}
+		State = Nodes[State].Fail;
+	}
+}
+
+bool FProceduralStringAutomaton::Contains(FStringView InString) const
+{
+	if (bIsEmpty)
+		return false;
+	int32 State = 0;
+	for (TCHAR Char : InString) {
+		State = FindNext(State, FChar::ToUpper(Char));
+		if (Nodes[State].bTerminal) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void FProceduralStringMatcher::Compile(const TArray<FString>& IncludeList, const TArray<FString>& ExcludeList)
+{
+	bHasInclude = !IncludeList.IsEmpty();
+	bIncludeAll = IncludeList.Contains(FString());
+	bExcludeAll = ExcludeList.Contains(FString());
+	IncludeAutomaton = MakeShared<const FProceduralStringAutomaton>(IncludeList);
+	ExcludeAutomaton = MakeShared<const FProceduralStringAutomaton>(ExcludeList);
+}
+
+bool FProceduralStringMatcher::Match(FStringView InString) const
+{
+	if (!bHasInclude || !IncludeAutomaton.IsValid())
+		return false;
+	if (!bIncludeAll && !IncludeAutomaton->Contains(InString))
+		return false;
+	if (bExcludeAll)
+		return false;
+	return !ExcludeAutomaton->Contains(InString);
+}
+
+TArray<int32> FProceduralStringMatcher::MatchIndices(int32 Num, TFunctionRef<FString(int32)> GetString) const
+{
+	TArray<bool> Matched;
+	Matched.SetNumZeroed(Num);
+	ParallelFor(Num, [&](int32 Index) {
+		Matched[Index] = Match(GetString(Index));
+	}, Num < 1024 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	TArray<int32> Indices;
+	for (int32 Index = 0; Index < Num; Index++) {
+		if (Matched[Index]) {
+			Indices.Add(Index);
+		}
+	}
+	return Indices;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Aho-Corasick automaton answering "does any pattern occur in the string" in a single pass.
+ * Matching is case insensitive to keep parity with FString::Contains.
+ */
+class FProceduralStringAutomaton
+{
+public:
+	explicit FProceduralStringAutomaton(const TArray<FString>& InPatterns);
+
+	bool Contains(FStringView InString) const;
+
+	bool IsEmpty() const { return bIsEmpty; }
+private:
+	struct FNode {
+		TMap<TCHAR, int32> Next;
+		int32 Fail = 0;
+		bool bTerminal = false;
+	};
+	int32 FindNext(int32 State, TCHAR Char) const;
+
+	TArray<FNode> Nodes;
+	bool bIsEmpty = true;
+};
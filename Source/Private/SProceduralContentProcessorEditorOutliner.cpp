@@ -18,6 +18,9 @@
 #include "PropertyCustomizationHelpers.h"
 #include "Styling/SlateIconFinder.h"
 #include "IDocumentation.h"
+#include "Engine/Blueprint.h"
+#include "Widgets/Layout/SExpandableArea.h"
+#include "SProceduralProfilerPanel.h"
 
 SProceduralContentProcessorEditorOutliner::~SProceduralContentProcessorEditorOutliner()
 {
@@ -67,6 +70,17 @@ void SProceduralContentProcessorEditorOutliner::Construct(const FArguments& InAr
 					FText()
 				)
 			]
+			+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(2)
+				.HAlign(HAlign_Right)
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(this, &SProceduralContentProcessorEditorOutliner::OnGetTickCostText)
+					.ColorAndOpacity(this, &SProceduralContentProcessorEditorOutliner::OnGetTickCostColor)
+					.ToolTipText(NSLOCTEXT("ProceduralContentProcessor", "TickCostTooltip", "Time spent in the current processor's Tick and continuations last frame"))
+				]
 			+ SHorizontalBox::Slot()
 				.AutoWidth()
 				.Padding(2)
@@ -82,6 +96,22 @@ void SProceduralContentProcessorEditorOutliner::Construct(const FArguments& InAr
 		[
 			SAssignNew(ProcessorWidgetContainter, SBox)
 		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5, 0, 5, 5)
+		[
+			SNew(SExpandableArea)
+			.InitiallyCollapsed(true)
+			.AreaTitle(NSLOCTEXT("ProceduralContentProcessor", "ProfilerArea", "Profiler"))
+			.BodyContent()
+			[
+				SNew(SBox)
+				.HeightOverride(240.0f)
+				[
+					SNew(SProceduralProfilerPanel)
+				]
+			]
+		]
 	];
 
 	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
@@ -100,27 +130,79 @@ void SProceduralContentProcessorEditorOutliner::Construct(const FArguments& InAr
 
 void SProceduralContentProcessorEditorOutliner::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
 {
-	if (bNeedRefreshProcessorList) {
-		RefreshProcessorList();
+	if (bNeedRefreshProcessorList && FPlatformTime::Seconds() >= RefreshProcessorListTime) {
 		bNeedRefreshProcessorList = false;
+		RefreshProcessorList();
 	}
 	if (CurrentProcessor) {
-		CurrentProcessor->Tick(InDeltaTime);
+		CurrentProcessor->ExecuteTick(InDeltaTime);
 	}
 
 	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
 }
 
-void SProceduralContentProcessorEditorOutliner::RefreshProcessorList()
+FText SProceduralContentProcessorEditorOutliner::OnGetTickCostText() const
 {
-	ProcessorList.Reset();
-	for (auto Watcher : BlueprintCompileWatcher) {
-		Watcher->OnCompiled().RemoveAll(this);
-		Watcher->OnChanged().RemoveAll(this);
+	if (CurrentProcessor == nullptr)
+		return FText();
+	return FText::FromString(FString::Printf(TEXT("%.2f ms"), CurrentProcessor->GetLastTickCostMs()));
+}
+
+FSlateColor SProceduralContentProcessorEditorOutliner::OnGetTickCostColor() const
+{
+	if (CurrentProcessor && CurrentProcessor->GetLastTickCostMs() > CurrentProcessor->GetTickBudgetMs()) {
+		return FSlateColor(FLinearColor::Red);
 	}
-	BlueprintCompileWatcher.Reset();
+	return FSlateColor::UseSubduedForeground();
+}
+
+void SProceduralContentProcessorEditorOutliner::RefreshProcessorList()
+{
+	ProcessorClassPaths.Reset();
 	TopLevelProcessorField.Reset();
 
+	struct FProcessorEntry {
+		TSharedPtr<FProcessorOutlinerField> Field;
+		FString CategoryChain;
+		float SortPriority = 0.0f;
+	};
+	TArray<FProcessorEntry> Entries;
+
+	// Blueprint processors are listed from their registry tags, loading and compiling all of them here is what made the mode slow to open.
+	FARFilter Filter;
+	Filter.PackagePaths.Add("/ProceduralContentProcessor");
+	Filter.ClassPaths.Add(UProceduralContentProcessorBlueprint::StaticClass()->GetClassPathName());
+	Filter.bRecursivePaths = true;
+	Filter.bRecursiveClasses = true;
+	TArray<FAssetData> AssetDataList;
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.GetAssets(Filter, AssetDataList);
+	for (const FAssetData& AssetData : AssetDataList) {
+		FString GeneratedClassPath;
+		if (!AssetData.GetTagValue(FBlueprintTags::GeneratedClassPath, GeneratedClassPath))
+			continue;
+		uint32 ClassFlags = 0;
+		if (AssetData.GetTagValue(FBlueprintTags::ClassFlags, ClassFlags) && (ClassFlags & CLASS_Abstract))
+			continue;
+		TSharedPtr<FProcessorOutlinerField_ProcessorAsset> Field = MakeShared<FProcessorOutlinerField_ProcessorAsset>();
+		Field->ProcessorClassPath = FSoftClassPath(FPackageName::ExportTextPathToObjectPath(GeneratedClassPath));
+		FString DisplayName, Description;
+		AssetData.GetTagValue(FBlueprintTags::BlueprintDisplayName, DisplayName);
+		AssetData.GetTagValue(FBlueprintTags::BlueprintDescription, Description);
+		Field->DisplayName = FText::FromString(DisplayName.IsEmpty() ? FName::NameToDisplayString(AssetData.AssetName.ToString(), false) : DisplayName);
+		Field->Tooltip = FText::FromString(Description.IsEmpty() ? AssetData.GetObjectPathString() : Description);
+		if (ProcessorClassPaths.Contains(Field->ProcessorClassPath))
+			continue;
+		ProcessorClassPaths.Add(Field->ProcessorClassPath);
+
+		FProcessorEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Field = Field;
+		AssetData.GetTagValue(GET_MEMBER_NAME_CHECKED(UBlueprint, BlueprintNamespace), Entry.CategoryChain);
+		if (Entry.CategoryChain.IsEmpty())
+			AssetData.GetTagValue(GET_MEMBER_NAME_CHECKED(UBlueprint, BlueprintCategory), Entry.CategoryChain);
+		AssetData.GetTagValue(GET_MEMBER_NAME_CHECKED(UProceduralContentProcessorBlueprint, SortPriority), Entry.SortPriority);
+	}
+
 	TArray<UClass*> NativeClasses;
 	GetDerivedClasses(UProceduralContentProcessor::StaticClass(), NativeClasses);
 	for (auto Class : NativeClasses) {
@@ -131,40 +213,33 @@ void SProceduralContentProcessorEditorOutliner::RefreshProcessorList()
 			) {
 			continue;
 		}
-		ProcessorList.AddUnique(Class);
-	}
-	TArray<FAssetData> AssetDataList;
-	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
-	AssetRegistry.GetAssetsByPath("/ProceduralContentProcessor", AssetDataList, true);
-	for (auto AssetData : AssetDataList) {
-		if (UProceduralContentProcessorBlueprint* Blueprint = Cast<UProceduralContentProcessorBlueprint>(AssetData.GetAsset())) {
-			if (Blueprint->GeneratedClass && !Blueprint->GeneratedClass->HasAnyClassFlags(EClassFlags::CLASS_Abstract)) {
-				ProcessorList.AddUnique(Blueprint->GeneratedClass);
-				Blueprint->OnCompiled().AddSP(this,&SProceduralContentProcessorEditorOutliner::OnBlueprintCompiled);
-				BlueprintCompileWatcher.Add(Blueprint);
-			}
-		}
+		const FSoftClassPath ClassPath(Class);
+		if (ProcessorClassPaths.Contains(ClassPath))
+			continue;
+		ProcessorClassPaths.Add(ClassPath);
+		TSharedPtr<FProcessorOutlinerField_Processor> Field = MakeShared<FProcessorOutlinerField_Processor>();
+		Field->ProcessorClass = Class;
+		FProcessorEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Field = Field;
+		Entry.CategoryChain = Class->GetMetaData("Namespace");
+		if (Entry.CategoryChain.IsEmpty())
+			Entry.CategoryChain = Class->GetMetaData("Category");
+		if (UProceduralContentProcessorBlueprint* Blueprint = Cast<UProceduralContentProcessorBlueprint>(Class->ClassGeneratedBy))
+			Entry.SortPriority = Blueprint->SortPriority;
+		else if (Class->HasMetaData("SortPriority"))
+			Entry.SortPriority = FCString::Atof(*Class->GetMetaData("SortPriority"));
 	}
 
-	ProcessorList.Sort([](const UClass& A, const UClass& B) {
-		static auto GetSortPriority = [](const UClass& Class){
-			if (UProceduralContentProcessorBlueprint* Blueprint = Cast<UProceduralContentProcessorBlueprint>(Class.ClassGeneratedBy)) 
-				return Blueprint->SortPriority;
-			if(Class.HasMetaData("SortPriority"))
-				return FCString::Atof(*Class.GetMetaData("SortPriority"));
-			return 0.0f;
-		};
-		return GetSortPriority(A) < GetSortPriority(B);
+	Entries.StableSort([](const FProcessorEntry& A, const FProcessorEntry& B) {
+		return A.SortPriority < B.SortPriority;
 	});
 
 	TSharedPtr<FProcessorEditorField_Category> CommonCategoryField = MakeShared<FProcessorEditorField_Category>();
 	CommonCategoryField->CategoryText = FText::FromString("Common");
 	TopLevelProcessorField.Add(CommonCategoryField);
 
-	for (auto Processor : ProcessorList) {
-		FString CategoryChain = Processor->GetMetaData("Namespace");
-		if (CategoryChain.IsEmpty())
-			CategoryChain = Processor->GetMetaData("Category");
+	for (const FProcessorEntry& Entry : Entries) {
+		FString CategoryChain = Entry.CategoryChain;
 		if(CategoryChain.IsEmpty())
 			CategoryChain = TEXT("Common");
 		TArray<FString> CategoryFieldNames;
@@ -187,24 +262,15 @@ void SProceduralContentProcessorEditorOutliner::RefreshProcessorList()
 			}
 			CurrentFields = &CategoryField->Children;
 		}
-		TSharedPtr<FProcessorOutlinerField_Processor> NewProcessorField = MakeShared<FProcessorOutlinerField_Processor>();
-		NewProcessorField->ProcessorClass = Processor;
-		CurrentFields->Add(NewProcessorField);
+		CurrentFields->Add(Entry.Field);
 	}
 	if (ProcessorTreeView) {
 		ProcessorTreeView->RebuildList();
 	}
-	FSoftClassPath LastSelectedClassPath = GetMutableDefault<UProceduralContentProcessorSettings>()->LastProcessorClass;
-	UClass* LastSelectedClass = Cast<UClass>(LastSelectedClassPath.TryLoad());
-	if (LastSelectedClass) {
-		if (ProcessorList.Contains(LastSelectedClass)) {
-			SetCurrentProcessor(LastSelectedClass);
-		}
-		else {
-			UBlueprint* BP = Cast<UBlueprint>(LastSelectedClass->ClassGeneratedBy);
-			if (BP && ProcessorList.Contains(BP->GeneratedClass)) {
-				SetCurrentProcessor(BP->GeneratedClass);
-			}
+	if (CurrentProcessor == nullptr) {
+		FSoftClassPath LastSelectedClassPath = GetMutableDefault<UProceduralContentProcessorSettings>()->LastProcessorClass;
+		if (ProcessorClassPaths.Contains(LastSelectedClassPath)) {
+			SetCurrentProcessor(LastSelectedClassPath.TryLoadClass<UProceduralContentProcessor>());
 		}
 	}
 }
@@ -215,6 +281,10 @@ void SProceduralContentProcessorEditorOutliner::SetCurrentProcessor(UClass* InPr
 		CurrentProcessor->SaveConfig(CPF_Config, *CurrentProcessor->GetDefaultConfigFilename());
 		CurrentProcessor->Deactivate();
 	}
+	if (CurrentProcessorBlueprint.IsValid()) {
+		CurrentProcessorBlueprint->OnCompiled().RemoveAll(this);
+		CurrentProcessorBlueprint.Reset();
+	}
 	if (bSaveConfig) {
 		GetMutableDefault<UProceduralContentProcessorSettings>()->LastProcessorClass = InProcessorClass;
 		GetMutableDefault<UProceduralContentProcessorSettings>()->TryUpdateDefaultConfigFile();
@@ -230,6 +300,8 @@ void SProceduralContentProcessorEditorOutliner::SetCurrentProcessor(UClass* InPr
 		FString DocumentHyperlink;
 		if (UProceduralContentProcessorBlueprint* Blueprint = Cast<UProceduralContentProcessorBlueprint>(InProcessorClass->ClassGeneratedBy)){
 			DocumentHyperlink = Blueprint->DocumentHyperlink;
+			Blueprint->OnCompiled().AddSP(this, &SProceduralContentProcessorEditorOutliner::OnBlueprintCompiled);
+			CurrentProcessorBlueprint = Blueprint;
 		}
 		else {
 			DocumentHyperlink = InProcessorClass->GetMetaData("DocumentHyperlink");
@@ -253,13 +325,19 @@ void SProceduralContentProcessorEditorOutliner::SetCurrentProcessor(UClass* InPr
 void SProceduralContentProcessorEditorOutliner::RequestRefreshProcessorList()
 {
 	SetCurrentProcessor(nullptr, false);
+	ScheduleRefreshProcessorList();
+}
+
+void SProceduralContentProcessorEditorOutliner::ScheduleRefreshProcessorList()
+{
+	// Asset events arrive in bursts while the registry scans or a batch of blueprints is saved, coalesce them into one refresh.
 	bNeedRefreshProcessorList = true;
+	RefreshProcessorListTime = FPlatformTime::Seconds() + 0.5;
 }
 
 void SProceduralContentProcessorEditorOutliner::AddReferencedObjects(FReferenceCollector& Collector)
 {
 	Collector.AddReferencedObject(CurrentProcessor);
-	Collector.AddReferencedObjects(ProcessorList);
 }
 
 void SProceduralContentProcessorEditorOutliner::OnMapChanged(uint32 MapChangeFlags)
@@ -296,21 +374,24 @@ void SProceduralContentProcessorEditorOutliner::OnBlueprintCompiled(UBlueprint*
 void SProceduralContentProcessorEditorOutliner::OnAssetAdded(const FAssetData& InData)
 {
 	if (InData.GetClass() && InData.GetClass()->IsChildOf<UProceduralContentProcessorBlueprint>()) {
-		RequestRefreshProcessorList();
+		ScheduleRefreshProcessorList();
 	}
 }
 
 void SProceduralContentProcessorEditorOutliner::OnAssetRemoved(const FAssetData& InData)
 {
 	if (InData.GetClass() && InData.GetClass()->IsChildOf<UProceduralContentProcessorBlueprint>()) {
-		RequestRefreshProcessorList();
+		if (CurrentProcessorBlueprint.IsValid() && CurrentProcessorBlueprint->GetPackage()->GetFName() == InData.PackageName) {
+			SetCurrentProcessor(nullptr, false);
+		}
+		ScheduleRefreshProcessorList();
 	}
 }
 
 void SProceduralContentProcessorEditorOutliner::OnAssetUpdated(const FAssetData& InData)
 {
 	if (InData.GetClass() && InData.GetClass()->IsChildOf<UProceduralContentProcessorBlueprint>()) {
-		RequestRefreshProcessorList();
+		ScheduleRefreshProcessorList();
 	}
 }
 
@@ -392,5 +473,5 @@ void SProceduralContentProcessorEditorOutliner::OnSelectionChanged(TSharedPtr<FP
 
 bool SProceduralContentProcessorEditorOutliner::IsSelectableOrNavigable(TSharedPtr<FProcessorOutlinerField> InField) const
 {
-	return InField->GetProcessorClass() != nullptr;
+	return InField->IsProcessor();
 }
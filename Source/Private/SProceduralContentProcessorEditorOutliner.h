@@ -15,6 +15,7 @@ struct FProcessorOutlinerField
 	virtual FText GetName() = 0;
 	virtual FText GetTooltip() = 0;
 	virtual UClass* GetProcessorClass() = 0;
+	virtual bool IsProcessor() { return GetProcessorClass() != nullptr; }
 	virtual ~FProcessorOutlinerField(){};
 };
 
@@ -35,6 +36,19 @@ struct FProcessorOutlinerField_Processor : public FProcessorOutlinerField
 	UClass* GetProcessorClass() override { return ProcessorClass; }
 };
 
+/** Built from asset registry tags, the blueprint is only loaded once the processor is picked. */
+struct FProcessorOutlinerField_ProcessorAsset : public FProcessorOutlinerField
+{
+	FSoftClassPath ProcessorClassPath;
+	FText DisplayName;
+	FText Tooltip;
+
+	FText GetName() override { return DisplayName; }
+	FText GetTooltip() override { return Tooltip; }
+	UClass* GetProcessorClass() override { return ProcessorClassPath.TryLoadClass<UObject>(); }
+	bool IsProcessor() override { return true; }
+};
+
 class SProceduralContentProcessorEditorOutliner : public SCompoundWidget, public FGCObject
 {
 public:
@@ -45,6 +59,7 @@ public:
 	void Construct(const FArguments& InArgs);
 	void SetCurrentProcessor(UClass* InProcessorClass, bool bSaveConfig = true);
 	void RequestRefreshProcessorList();
+	void ScheduleRefreshProcessorList();
 protected:
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
 	virtual FString GetReferencerName() const override { return TEXT("ProceduralContentProcessor"); }
@@ -68,6 +83,8 @@ protected:
 	FText OnGetCurrentProcessorText() const;
 
 	FText OnGetCurrentProcessorTooltipText() const;
+	FText OnGetTickCostText() const;
+	FSlateColor OnGetTickCostColor() const;
 	TSharedRef<SWidget> OnGetProcessorSelectorMenu();
 
 	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FProcessorOutlinerField> InField, const TSharedRef<STableViewBase>& OwnerTable);
@@ -75,9 +92,9 @@ protected:
 	void OnSelectionChanged(TSharedPtr<FProcessorOutlinerField> InField, ESelectInfo::Type SelectInfo);
 	bool IsSelectableOrNavigable(TSharedPtr<FProcessorOutlinerField> InField) const;
 private:
-	TArray<UClass*> ProcessorList;
+	TArray<FSoftClassPath> ProcessorClassPaths;
 	TObjectPtr<UProceduralContentProcessor> CurrentProcessor;
-	TArray<UBlueprint*> BlueprintCompileWatcher;
+	TWeakObjectPtr<UBlueprint> CurrentProcessorBlueprint;
 	TSharedPtr<STextBlock> CurrentProcessorBox;
 	FText CurrentProcessorText;
 	TArray<TSharedPtr<FProcessorOutlinerField>> TopLevelProcessorField;
@@ -89,5 +106,6 @@ private:
 	TSharedPtr<SBox> ProcessorToolBarContainter;
 
 	bool bNeedRefreshProcessorList = false;
+	double RefreshProcessorListTime = 0.0;
 
 };
\ No newline at end of file
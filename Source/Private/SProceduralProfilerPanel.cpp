@@ -0,0 +1,146 @@
+#include "SProceduralProfilerPanel.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Text/STextBlock.h"
+
+namespace ProceduralProfilerColumns
+{
+	static const FName Name(TEXT("Name"));
+	static const FName Calls(TEXT("Calls"));
+	static const FName Inclusive(TEXT("Inclusive"));
+	static const FName Self(TEXT("Self"));
+	static const FName Objects(TEXT("Objects"));
+	static const FName Memory(TEXT("Memory"));
+	static const FName Counters(TEXT("Counters"));
+}
+
+class SProceduralProfilerRow : public SMultiColumnTableRow<TSharedPtr<FProceduralProfiler::FNode>>
+{
+public:
+	SLATE_BEGIN_ARGS(SProceduralProfilerRow) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FProceduralProfiler::FNode> InNode)
+	{
+		Node = InNode;
+		SMultiColumnTableRow::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		if (ColumnName == ProceduralProfilerColumns::Name) {
+			return SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				[
+					SNew(SExpanderArrow, SharedThis(this))
+				]
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(FText::FromName(Node->Name))
+				];
+		}
+		FText Text;
+		if (ColumnName == ProceduralProfilerColumns::Calls) {
+			Text = FText::AsNumber(Node->Calls);
+		}
+		else if (ColumnName == ProceduralProfilerColumns::Inclusive) {
+			Text = FText::FromString(FString::Printf(TEXT("%.2f"), Node->InclusiveSeconds * 1000.0));
+		}
+		else if (ColumnName == ProceduralProfilerColumns::Self) {
+			Text = FText::FromString(FString::Printf(TEXT("%.2f"), Node->SelfSeconds * 1000.0));
+		}
+		else if (ColumnName == ProceduralProfilerColumns::Objects) {
+			Text = FText::AsNumber(Node->ObjectsCreated);
+		}
+		else if (ColumnName == ProceduralProfilerColumns::Memory) {
+			Text = FText::AsMemory(FMath::Abs(Node->MemoryDelta));
+			if (Node->MemoryDelta < 0) {
+				Text = FText::FromString(TEXT("-") + Text.ToString());
+			}
+		}
+		else if (ColumnName == ProceduralProfilerColumns::Counters) {
+			TArray<FString> Counters;
+			for (const auto& Counter : Node->Counters) {
+				Counters.Add(FString::Printf(TEXT("%s=%lld"), *Counter.Key.ToString(), Counter.Value));
+			}
+			Text = FText::FromString(FString::Join(Counters, TEXT(", ")));
+		}
+		return SNew(STextBlock).Text(Text);
+	}
+private:
+	TSharedPtr<FProceduralProfiler::FNode> Node;
+};
+
+SProceduralProfilerPanel::~SProceduralProfilerPanel()
+{
+	FProceduralProfiler::Get().OnRunFinished.Remove(OnRunFinishedHandle);
+}
+
+void SProceduralProfilerPanel::Construct(const FArguments& InArgs)
+{
+	ChildSlot[
+		SAssignNew(TreeView, STreeView<TSharedPtr<FProceduralProfiler::FNode>>)
+		.TreeItemsSource(&RootNodes)
+		.SelectionMode(ESelectionMode::Single)
+		.OnGenerateRow(this, &SProceduralProfilerPanel::OnGenerateRow)
+		.OnGetChildren(this, &SProceduralProfilerPanel::OnGetChildren)
+		.HeaderRow(
+			SNew(SHeaderRow)
+			+ SHeaderRow::Column(ProceduralProfilerColumns::Name)
+			.DefaultLabel(NSLOCTEXT("ProceduralContentProcessor", "ProfilerName", "Name"))
+			.FillWidth(0.34f)
+			+ SHeaderRow::Column(ProceduralProfilerColumns::Calls)
+			.DefaultLabel(NSLOCTEXT("ProceduralContentProcessor", "ProfilerCalls", "Calls"))
+			.FillWidth(0.08f)
+			+ SHeaderRow::Column(ProceduralProfilerColumns::Inclusive)
+			.DefaultLabel(NSLOCTEXT("ProceduralContentProcessor", "ProfilerInclusive", "Inclusive (ms)"))
+			.FillWidth(0.12f)
+			+ SHeaderRow::Column(ProceduralProfilerColumns::Self)
+			.DefaultLabel(NSLOCTEXT("ProceduralContentProcessor", "ProfilerSelf", "Self (ms)"))
+			.FillWidth(0.12f)
+			+ SHeaderRow::Column(ProceduralProfilerColumns::Objects)
+			.DefaultLabel(NSLOCTEXT("ProceduralContentProcessor", "ProfilerObjects", "Objects"))
+			.DefaultTooltip(NSLOCTEXT("ProceduralContentProcessor", "ProfilerObjectsTooltip", "Change of the live UObject count"))
+			.FillWidth(0.1f)
+			+ SHeaderRow::Column(ProceduralProfilerColumns::Memory)
+			.DefaultLabel(NSLOCTEXT("ProceduralContentProcessor", "ProfilerMemory", "Memory"))
+			.DefaultTooltip(NSLOCTEXT("ProceduralContentProcessor", "ProfilerMemoryTooltip", "Change of the used physical memory"))
+			.FillWidth(0.1f)
+			+ SHeaderRow::Column(ProceduralProfilerColumns::Counters)
+			.DefaultLabel(NSLOCTEXT("ProceduralContentProcessor", "ProfilerCounters", "Counters"))
+			.FillWidth(0.14f)
+		)
+	];
+	OnRunFinishedHandle = FProceduralProfiler::Get().OnRunFinished.AddSP(this, &SProceduralProfilerPanel::OnRunFinished);
+	OnRunFinished();
+}
+
+void SProceduralProfilerPanel::OnRunFinished()
+{
+	RootNodes.Reset();
+	if (TSharedPtr<FProceduralProfiler::FNode> LastRun = FProceduralProfiler::Get().GetLastRun()) {
+		RootNodes.Add(LastRun);
+		ExpandAll(LastRun);
+	}
+	TreeView->RequestTreeRefresh();
+}
+
+TSharedRef<ITableRow> SProceduralProfilerPanel::OnGenerateRow(TSharedPtr<FProceduralProfiler::FNode> InNode, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SProceduralProfilerRow, OwnerTable, InNode);
+}
+
+void SProceduralProfilerPanel::OnGetChildren(TSharedPtr<FProceduralProfiler::FNode> InNode, TArray<TSharedPtr<FProceduralProfiler::FNode>>& OutChildren)
+{
+	OutChildren = InNode->Children;
+}
+
+void SProceduralProfilerPanel::ExpandAll(TSharedPtr<FProceduralProfiler::FNode> InNode)
+{
+	TreeView->SetItemExpansion(InNode, true);
+	for (const TSharedPtr<FProceduralProfiler::FNode>& Child : InNode->Children) {
+		ExpandAll(Child);
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/STreeView.h"
+#include "ProceduralProfiler.h"
+
+/** Shows the call tree FProceduralProfiler recorded for the last processor invocation. */
+class SProceduralProfilerPanel : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SProceduralProfilerPanel) {}
+	SLATE_END_ARGS()
+public:
+	~SProceduralProfilerPanel();
+	void Construct(const FArguments& InArgs);
+protected:
+	void OnRunFinished();
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FProceduralProfiler::FNode> InNode, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnGetChildren(TSharedPtr<FProceduralProfiler::FNode> InNode, TArray<TSharedPtr<FProceduralProfiler::FNode>>& OutChildren);
+	void ExpandAll(TSharedPtr<FProceduralProfiler::FNode> InNode);
+private:
+	TArray<TSharedPtr<FProceduralProfiler::FNode>> RootNodes;
+	TSharedPtr<STreeView<TSharedPtr<FProceduralProfiler::FNode>>> TreeView;
+	FDelegateHandle OnRunFinishedHandle;
+};
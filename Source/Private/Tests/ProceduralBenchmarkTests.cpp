@@ -0,0 +1,66 @@
+#include "ProceduralBenchmark.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * One test per FProceduralBenchmark case, e.g.
+ * UnrealEditor-Cmd.exe Project.uproject -nullrhi -ExecCmds="Automation RunTests ProceduralContentProcessor.Benchmark; Quit"
+ *     [-BenchmarkSizes=100+1000] [-BenchmarkIterations=3] [-BenchmarkBaseline=Base.csv] [-BenchmarkTolerance=0.2] [-BenchmarkNoiseFloorMs=2]
+ * Every case writes Saved/ProceduralContentProcessor/Benchmark/<Case>.csv, cases slower than the baseline fail.
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FProceduralBenchmarkTest, "ProceduralContentProcessor.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+void FProceduralBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const FString& Case : FProceduralBenchmark::GetCaseNames()) {
+		OutBeautifiedNames.Add(Case);
+		OutTestCommands.Add(Case);
+	}
+}
+
+bool FProceduralBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+	TArray<int32> Sizes = { 100, 1000 };
+	FString SizesParam;
+	if (FParse::Value(CommandLine, TEXT("BenchmarkSizes="), SizesParam, false)) {
+		TArray<FString> Values;
+		SizesParam.ParseIntoArray(Values, TEXT("+"));
+		Sizes.Reset();
+		for (const FString& Value : Values) {
+			Sizes.Add(FMath::Max(1, FCString::Atoi(*Value)));
+		}
+	}
+	int32 Iterations = 3;
+	FParse::Value(CommandLine, TEXT("BenchmarkIterations="), Iterations);
+	float Tolerance = 0.2f;
+	FParse::Value(CommandLine, TEXT("BenchmarkTolerance="), Tolerance);
+	float NoiseFloorMs = 2.0f;
+	FParse::Value(CommandLine, TEXT("BenchmarkNoiseFloorMs="), NoiseFloorMs);
+
+	TArray<FProceduralBenchmark::FSample> Samples = FProceduralBenchmark::Run(Sizes, FMath::Max(1, Iterations), Parameters);
+	if (!TestFalse(TEXT("Benchmark produced samples"), Samples.IsEmpty()))
+		return false;
+
+	FString BaselineFilename;
+	if (FParse::Value(CommandLine, TEXT("BenchmarkBaseline="), BaselineFilename)) {
+		for (const FString& Regression : FProceduralBenchmark::CompareToBaseline(BaselineFilename, Samples, Tolerance, NoiseFloorMs)) {
+			AddError(FString::Printf(TEXT("Regression: %s"), *Regression));
+		}
+	}
+	for (const FProceduralBenchmark::FSample& Sample : Samples) {
+		if (!Sample.Error.IsEmpty()) {
+			AddError(FString::Printf(TEXT("%s@%d: %s"), *Sample.Case, Sample.Size, *Sample.Error));
+			continue;
+		}
+		AddInfo(FString::Printf(TEXT("%s@%d: %.2f ms"), *Sample.Case, Sample.Size, Sample.GetMedianMs()));
+	}
+	const FString CsvFilename = FPaths::ProjectSavedDir() / TEXT("ProceduralContentProcessor/Benchmark") / Parameters + TEXT(".csv");
+	TestTrue(FString::Printf(TEXT("Write %s"), *CsvFilename), FProceduralBenchmark::WriteCsv(CsvFilename, Samples));
+	return !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Containers/Ticker.h"
+#include "Tasks/Task.h"
+#include "ProceduralAsyncTask.generated.h"
+
+class SNotificationItem;
+struct FSlowTask;
+
+/**
+ * RAII progress for synchronous work. Scopes nest like FScopedSlowTask, only the outermost one owns the modal dialog,
+ * and the destructor always closes it, so early returns and exceptions can't leave a dangling progress dialog.
+ * The dialog stays modal because the caller still holds the objects it iterates, work that must not block the editor goes through FProceduralAsyncTaskRunner.
+ */
+class PROCEDURALCONTENTPROCESSOR_API FProceduralTaskScope : public FNoncopyable
+{
+public:
+	FProceduralTaskScope(const FText& InTaskName, float InAmountOfWork, bool bInCancellable = true);
+	~FProceduralTaskScope();
+
+	void EnterProgressFrame(float ExpectedWorkThisFrame = 1.f, const FText& InText = FText());
+
+	bool ShouldCancel() const;
+
+	static FProceduralTaskScope* GetCurrent();
+
+	static void CancelAll();
+private:
+	float GetOverallProgress() const;
+	void UpdateProgress(bool bForce);
+
+	FText TaskName;
+	FText FrameText;
+	float AmountOfWork = 1.0f;
+	float CompletedWork = 0.0f;
+	float CurrentFrameWork = 0.0f;
+	double LastUpdateTime = 0.0;
+	TUniquePtr<FSlowTask> SlowTask;
+	TSharedPtr<std::atomic<bool>> bCancelled;
+
+	static TArray<FProceduralTaskScope*> ScopeStack;
+};
+
+/**
+ * Runs a list of stages over [0, Num). Async stages are split into chunks on UE::Tasks,
+ * game thread stages are drained from the core ticker within a per-frame budget.
+ * Progress and cancel are surfaced through a non-modal notification.
+ */
+class PROCEDURALCONTENTPROCESSOR_API FProceduralAsyncTaskRunner : public TSharedFromThis<FProceduralAsyncTaskRunner>
+{
+public:
+	static TSharedRef<FProceduralAsyncTaskRunner> Create(const FText& InTaskName);
+
+	~FProceduralAsyncTaskRunner();
+
+	FProceduralAsyncTaskRunner& ThenAsync(int32 InNum, TFunction<void(int32)> InWork, int32 InChunkSize = 64);
+
+	FProceduralAsyncTaskRunner& ThenOnGameThread(int32 InNum, TFunction<void(int32)> InWork);
+
+	FProceduralAsyncTaskRunner& OnFinished(TFunction<void(bool /*bCancelled*/)> InCallback);
+
+	FProceduralAsyncTaskRunner& SetGameThreadBudget(float InBudgetMs);
+
+	void Start();
+
+	void Cancel();
+
+	bool IsCancelled() const { return bCancelled; }
+
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+
+	static void CancelAll();
+private:
+	struct FStage {
+		int32 Num = 0;
+		int32 ChunkSize = 0;
+		bool bGameThread = false;
+		TFunction<void(int32)> Work;
+	};
+
+	FProceduralAsyncTaskRunner(const FText& InTaskName);
+
+	bool Tick(float InDeltaTime);
+	void LaunchStage();
+	void Finish();
+	void UpdateNotification();
+
+	FText TaskName;
+	TArray<FStage> Stages;
+	TFunction<void(bool)> FinishedCallback;
+	float GameThreadBudgetMs = 8.0f;
+	int32 StageIndex = INDEX_NONE;
+	int32 GameThreadCursor = 0;
+	TArray<UE::Tasks::FTask> PendingChunks;
+	std::atomic<int32> CompletedItems = 0;
+	std::atomic<bool> bCancelled = false;
+	FTSTicker::FDelegateHandle TickerHandle;
+	TSharedPtr<SNotificationItem> Notification;
+
+	static TArray<TSharedRef<FProceduralAsyncTaskRunner>> ActiveRunners;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FProceduralAsyncTaskStepDelegate, int32, Index);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FProceduralAsyncTaskDelegate);
+
+UCLASS()
+class PROCEDURALCONTENTPROCESSOR_API UProceduralAsyncTaskAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+public:
+	/** Calls OnStep for every index, as many per frame as fit into BudgetMs, without blocking the editor. */
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor", meta = (BlueprintInternalUseOnly = "true"))
+	static UProceduralAsyncTaskAction* RunTimeSlicedTask(FText TaskName, int32 Num, float BudgetMs = 8.0f);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static void CancelAllAsyncTasks();
+
+	UPROPERTY(BlueprintAssignable)
+	FProceduralAsyncTaskStepDelegate OnStep;
+
+	UPROPERTY(BlueprintAssignable)
+	FProceduralAsyncTaskDelegate OnCompleted;
+
+	UPROPERTY(BlueprintAssignable)
+	FProceduralAsyncTaskDelegate OnCancelled;
+
+	virtual void Activate() override;
+private:
+	FText TaskName;
+	int32 Num = 0;
+	float BudgetMs = 8.0f;
+};
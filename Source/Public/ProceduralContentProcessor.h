@@ -3,6 +3,8 @@
 #include "UObject/Object.h"
 #include "GameFramework/Actor.h"
 #include "Blueprint/UserWidget.h"
+#include "AssetRegistry/AssetData.h"
+#include "ProceduralContentProcessorLibrary.h"
 #include "ProceduralContentProcessor.generated.h"
 
 UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
@@ -30,6 +32,53 @@ enum EObjectPropertyChangeType : uint64
 	ToggleEditable = 1 << 9,
 };
 
+DECLARE_DYNAMIC_DELEGATE_RetVal(bool, FProceduralContinuation);
+
+class FProceduralShardCoordinator;
+
+USTRUCT(BlueprintType)
+struct FProceduralAssetResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	FSoftObjectPath Asset;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	TMap<FName, FString> Fields;
+};
+
+USTRUCT(BlueprintType)
+struct FProceduralShardedRunResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	bool bSucceeded = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	int32 NumShards = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	int32 NumFailedShards = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	int32 NumRetries = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	float TotalSeconds = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	FString ReportFilename;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	TArray<FProceduralAssetResult> Results;
+
+	/** Packages a worker modified outside its own shard, they are not saved by any worker. */
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	TArray<FString> UnsavedPackages;
+};
+
 UCLASS(Abstract, Blueprintable, EditInlineNew, CollapseCategories, config = ProceduralContentProcessor, defaultconfig)
 class PROCEDURALCONTENTPROCESSOR_API UProceduralContentProcessor: public UObject {
 	GENERATED_BODY()
@@ -54,9 +103,39 @@ public:
 
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 
+	/** Wraps every UFUNCTION invocation in an Insights event, CallInEditor and exec functions and Activate start a FProceduralProfiler run. */
+	virtual void ProcessEvent(UFunction* Function, void* Parms) override;
+
 	virtual TSharedPtr<SWidget> BuildWidget();
 
 	virtual TSharedPtr<SWidget> BuildToolBar();
+
+	/**
+	 * Runs Tick and then pending continuations until the per-frame budget is spent.
+	 * A frame over budget is paid back by skipping the following ones, the next Tick gets the skipped delta time.
+	 */
+	void ExecuteTick(const float InDeltaTime);
+
+	virtual float GetTickBudgetMs() const;
+
+	float GetLastTickCostMs() const { return LastTickCostMs; }
+
+	/** The continuation is called once per frame while budget remains, returning true removes it. */
+	void AddContinuation(TFunction<bool()> InContinuation);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor", meta = (DisplayName = "Add Continuation"))
+	void AddBlueprintContinuation(const FProceduralContinuation& Continuation);
+
+	/** Whether the frame budget is spent, always false outside ExecuteTick. */
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	bool ShouldYield() const;
+private:
+	TArray<TFunction<bool()>> Continuations;
+	double FrameDeadline = 0.0;
+	bool bInTick = false;
+	float LastTickCostMs = 0.0f;
+	double TickDebtMs = 0.0;
+	float SkippedDeltaTime = 0.0f;
 };
 
 UCLASS(Abstract, Blueprintable, EditInlineNew, CollapseCategories, config = ProceduralContentProcessor, defaultconfig)
@@ -65,6 +144,44 @@ class PROCEDURALCONTENTPROCESSOR_API UProceduralAssetProcessor: public UProcedur
 public:
 	UFUNCTION(BlueprintPure, Category = "ProceduralContentProcessor")
 	TScriptInterface<IAssetRegistry> GetAllAssetRegistry();
+
+	/** Evaluates Query on the asset registry without loading anything, batch runs only see their own AssetsToProcess. */
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	TArray<FAssetData> QueryAssets(const FProceduralAssetQuery& Query) const;
+
+	/** Assets handed over by a batch run (commandlet), empty when the processor runs from the outliner. */
+	UFUNCTION(BlueprintPure, Category = "ProceduralContentProcessor")
+	TArray<FAssetData> GetAssetsToProcess() const { return AssetsToProcess; }
+
+	UFUNCTION(BlueprintPure, Category = "ProceduralContentProcessor")
+	bool HasAssetsToProcess() const { return !AssetsToProcess.IsEmpty(); }
+
+	void SetAssetsToProcess(TArray<FAssetData> InAssets) { AssetsToProcess = MoveTemp(InAssets); }
+
+	/** Records a per-asset value, sharded runs collect these from every worker into one result. */
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	void ReportAssetResult(const FSoftObjectPath& Asset, FName Field, const FString& Value);
+
+	const TMap<FSoftObjectPath, TMap<FName, FString>>& GetAssetResults() const { return AssetResults; }
+
+	/**
+	 * Splits the assets under PackagePaths into shards and runs FunctionName over them in NumWorkers local commandlet processes.
+	 * The processor class must be saved to disk, crashed shards are retried up to MaxRetries times.
+	 * With bSavePackages the run is refused while a target package has unsaved changes in the editor,
+	 * and target packages the editor has loaded are reloaded from disk once the workers are done.
+	 * Every package is saved only by the shard that owns it, PackagePaths or ClassPaths must not both be empty.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor", meta = (AutoCreateRefTerm = "ClassPaths"))
+	bool RunSharded(FName FunctionName, const TArray<FName>& PackagePaths, const TArray<FTopLevelAssetPath>& ClassPaths, int32 NumWorkers = 4, int32 MaxRetries = 2, bool bSavePackages = false);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "ProceduralContentProcessor", meta = (DisplayName = "Sharded Run Completed"))
+	void ReceiveShardedRunCompleted(const FProceduralShardedRunResult& Result);
+
+	virtual void Deactivate() override;
+private:
+	TArray<FAssetData> AssetsToProcess;
+	TMap<FSoftObjectPath, TMap<FName, FString>> AssetResults;
+	TSharedPtr<FProceduralShardCoordinator> ShardCoordinator;
 };
 
 UCLASS(Abstract, Blueprintable, EditInlineNew, CollapseCategories, config = ProceduralContentProcessor, defaultconfig)
@@ -73,8 +190,13 @@ class PROCEDURALCONTENTPROCESSOR_API UProceduralWorldProcessor: public UProcedur
 public:
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	TArray<AActor*> GetAllActorsByName(FString InName, bool bCompleteMatching = false);
+
+	/** Used by batch runs where there is no editor world context to follow. */
+	void SetWorldOverride(UWorld* InWorld) { WorldOverride = InWorld; }
 protected:
 	virtual UWorld* GetWorld() const override;
+private:
+	TWeakObjectPtr<UWorld> WorldOverride;
 };
 
 UCLASS(Abstract, Blueprintable, EditInlineNew, CollapseCategories, config = ProceduralContentProcessor, defaultconfig)
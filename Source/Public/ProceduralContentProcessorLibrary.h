@@ -6,10 +6,15 @@
 #include "NiagaraEmitter.h"
 #include "Engine/TextureRenderTarget2D.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
+#include "AssetRegistry/AssetData.h"
+#include "ProceduralLODMetrics.h"
 #include "ProceduralContentProcessorLibrary.generated.h"
 
 class ALandscape;
 class UStaticMeshEditorSubsystem;
+class FProceduralStringAutomaton;
+class UMaterialExpression;
+class FProceduralTaskScope;
 
 UENUM(BlueprintType)
 enum class EStaticMeshPivotType: uint8
@@ -51,6 +56,18 @@ enum class EMsgBoxReturnType: uint8
 	Continue,
 };
 
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EProceduralMaterialUsage : uint8
+{
+	None = 0 UMETA(Hidden),
+	Time = 1 << 0,
+	WorldPosition = 1 << 1,
+	PixelDepthOffset = 1 << 2,
+	WorldPositionOffset = 1 << 3,
+	Custom = 1 << 4,
+};
+ENUM_CLASS_FLAGS(EProceduralMaterialUsage);
+
 USTRUCT(BlueprintType)
 struct FNiagaraEmitterInfo 
 {
@@ -65,6 +82,15 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	FVersionedNiagaraEmitterData Data;
 
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	ENiagaraSimTarget SimTarget = ENiagaraSimTarget::CPUSim;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<FString> Renderers;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	int32 PreAllocationCount = 0;
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	TMap<FString, FString> Inputs;
 };
@@ -78,6 +104,103 @@ public:
 	TArray<FNiagaraEmitterInfo> Emitters;
 };
 
+/** Compiled form of MatchString's include/exclude lists, build it once and reuse it for every string. */
+USTRUCT(BlueprintType)
+struct PROCEDURALCONTENTPROCESSOR_API FProceduralStringMatcher
+{
+	GENERATED_BODY()
+public:
+	void Compile(const TArray<FString>& IncludeList, const TArray<FString>& ExcludeList);
+
+	bool Match(FStringView InString) const;
+
+	TArray<int32> MatchIndices(int32 Num, TFunctionRef<FString(int32)> GetString) const;
+private:
+	TSharedPtr<const FProceduralStringAutomaton> IncludeAutomaton;
+	TSharedPtr<const FProceduralStringAutomaton> ExcludeAutomaton;
+	bool bHasInclude = false;
+	bool bIncludeAll = false;
+	bool bExcludeAll = false;
+};
+
+UENUM(BlueprintType)
+enum class EProceduralAssetTagOp : uint8
+{
+	Equal,
+	NotEqual,
+	Less,
+	LessEqual,
+	Greater,
+	GreaterEqual,
+	Contains,
+	Exists,
+	NotExists,
+};
+
+/** Compares an asset registry tag with Value, numeric when both sides parse as numbers ("2048x1024" dimensions compare by their largest axis). */
+USTRUCT(BlueprintType)
+struct PROCEDURALCONTENTPROCESSOR_API FProceduralAssetTagPredicate
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FName Tag;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	EProceduralAssetTagOp Op = EProceduralAssetTagOp::Equal;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FString Value;
+
+	bool Evaluate(const FAssetData& InAsset) const;
+
+	static bool TryParseNumber(FStringView InString, double& OutNumber);
+};
+
+/** Filters the asset registry by path, class and tag values without loading any asset. */
+USTRUCT(BlueprintType)
+struct PROCEDURALCONTENTPROCESSOR_API FProceduralAssetQuery
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<FName> PackagePaths;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bRecursivePaths = true;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<FTopLevelAssetPath> ClassPaths;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bRecursiveClasses = true;
+
+	/** All predicates must pass. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<FProceduralAssetTagPredicate> Predicates;
+
+	/** Matched against the object path, an empty IncludeList accepts every path. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<FString> IncludeList;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<FString> ExcludeList;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FName SortTag;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bSortDescending = true;
+
+	/** 0 returns every match. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	int32 MaxResults = 0;
+
+	TArray<FAssetData> Execute() const;
+};
+
+DECLARE_DYNAMIC_DELEGATE_RetVal_OneParam(bool, FProceduralAssetBatchDelegate, const TArray<UObject*>&, Assets);
+
 UCLASS()
 class PROCEDURALCONTENTPROCESSOR_API UProceduralContentProcessorLibrary : public UBlueprintFunctionLibrary
 {
@@ -97,6 +220,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static void AddTextField(UPARAM(ref) FProceduralObjectMatrix& Matrix, UObject* InOwner, FName InFieldName, FString InFieldValue);
 
+	/** Adds a field to a row keyed by the asset path, the asset is not loaded. */
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static void AddAssetTextField(UPARAM(ref) FProceduralObjectMatrix& Matrix, const FAssetData& InAsset, FName InFieldName, FString InFieldValue);
+
+	/** Runs the query and appends one row per asset with a column for every tag in Columns, returns the number of rows. */
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static int32 QueryAssetsToMatrix(UPARAM(ref) FProceduralObjectMatrix& Matrix, const FProceduralAssetQuery& Query, const TArray<FName>& Columns);
+
 
 	// Object Interface:
 
@@ -143,6 +274,13 @@ public:
 	static void SetObjectPropertyByName(UObject* Object, FName PropertyName, const int& Value);
 	DECLARE_FUNCTION(execSetObjectPropertyByName);
 
+	/** PropertyPath may walk into nested structs, e.g. "LightmassSettings.bUseAreaShadowsForStationaryLight". */
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor", CustomThunk, meta = (CustomStructureParam = "Value", AutoCreateRefTerm = "Value"))
+	static void SetPropertyOnObjects(const TArray<UObject*>& Objects, const FString& PropertyPath, const int& Value, bool bNotifyChanges = true);
+	DECLARE_FUNCTION(execSetPropertyOnObjects);
+
+	static int32 SetPropertyOnObjects(TConstArrayView<UObject*> Objects, const FString& PropertyPath, const FProperty* ValueProperty, const void* ValuePtr, bool bNotifyChanges = true);
+
 	// Editor Interface:
 
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
@@ -184,6 +322,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static void ClearAllSlowTask();
 
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static bool ShouldCancelSlowTask();
+
 
 	// Asset Interface:
 	
@@ -202,9 +343,45 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static bool IsMaterialHasTimeNode(AStaticMeshActor* InActor);
 
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor", meta = (Bitmask, BitmaskEnum = "/Script/ProceduralContentProcessor.EProceduralMaterialUsage"))
+	static int32 GetMaterialUsageFlags(UMaterialInterface* InMaterial);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static bool MaterialHasExpression(UMaterialInterface* InMaterial, TSubclassOf<UMaterialExpression> InExpressionClass);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor", meta = (WorldContext = "WorldContextObject"))
+	static void FindPrimitivesByMaterialUsage(const UObject* WorldContextObject, UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/ProceduralContentProcessor.EProceduralMaterialUsage")) int32 UsageFlags, TArray<AActor*>& OutActors, TArray<UPrimitiveComponent*>& OutComponents);
+
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static bool MatchString(FString InString,const TArray<FString>& IncludeList, const TArray<FString>& ExcludeList);
 
+	UFUNCTION(BlueprintPure, Category = "ProceduralContentProcessor")
+	static FProceduralStringMatcher MakeStringMatcher(const TArray<FString>& IncludeList, const TArray<FString>& ExcludeList);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static bool MatchStringByMatcher(const FProceduralStringMatcher& Matcher, const FString& InString);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static TArray<FString> FilterStringsByMatcher(const FProceduralStringMatcher& Matcher, const TArray<FString>& InStrings);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static TArray<FAssetData> FilterAssetsByMatcher(const FProceduralStringMatcher& Matcher, const TArray<FAssetData>& InAssets);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static TArray<FAssetData> QueryAssets(const FProceduralAssetQuery& Query);
+
+	UFUNCTION(BlueprintPure, Category = "ProceduralContentProcessor")
+	static bool GetAssetTagValueAsNumber(const FAssetData& InAsset, FName InTag, double& OutValue);
+
+	/**
+	 * Loads Assets BatchSize at a time and hands every batch to OnBatch, the clean packages a batch loaded are unloaded after it.
+	 * Return false from OnBatch to stop, modified assets are kept alive until the end so they can still be saved.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static int32 ForEachAssetBatch(const TArray<FAssetData>& Assets, int32 BatchSize, const FProceduralAssetBatchDelegate& OnBatch);
+
+	static int32 ForEachAssetBatch(TConstArrayView<FAssetData> Assets, int32 BatchSize, TFunctionRef<bool(const TArray<UObject*>&)> OnBatch);
+
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static float GetStaticMeshDiskSize(UStaticMesh* StaticMesh, bool bWithTexture = true);
 
@@ -214,6 +391,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static void SetStaticMeshPivot(UStaticMesh* InStaticMesh, EStaticMeshPivotType PivotType);
 
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static void SetStaticMeshPivots(const TArray<UStaticMesh*>& InStaticMeshes, EStaticMeshPivotType PivotType);
+
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "ProceduralContentProcessor")
 	static UStaticMeshEditorSubsystem* GetStaticMeshEditorSubsystem();
 
@@ -232,6 +412,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static float CalcObjectSphereRadius(float ScreenSize, float Distance);
 
+	UFUNCTION(BlueprintPure, Category = "ProceduralContentProcessor")
+	static float GetProjectionScreenMultiple(const FProceduralProjectionSettings& Projection);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static TArray<float> CalcLodDistances(const TArray<float>& ObjectSphereRadii, const TArray<float>& ScreenSizes, const FProceduralProjectionSettings& Projection);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static TArray<float> CalcScreenSizes(const TArray<float>& ObjectSphereRadii, const TArray<float>& Distances, const FProceduralProjectionSettings& Projection);
+
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static TArray<float> CalcObjectSphereRadii(const TArray<float>& ScreenSizes, const TArray<float>& Distances, const FProceduralProjectionSettings& Projection);
+
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static UTexture2D* ConstructTexture2D(UTextureRenderTarget2D* TextureRenderTarget2D, UObject* Outer, FString Name, TextureCompressionSettings CompressionSettings = TC_Default);
 
@@ -244,6 +436,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static FNiagaraSystemInfo GetNiagaraSystemInformation(UNiagaraSystem * InNaigaraSystem);
 
+	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
+	static TArray<FNiagaraSystemInfo> GetNiagaraSystemsInformation(const TArray<UNiagaraSystem*>& InNiagaraSystems);
+
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static FVector2D ProjectWorldToScreen(const FVector& InWorldPos, bool bClampToScreenRectangle);
 
@@ -298,5 +493,5 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ProceduralContentProcessor")
 	static void ActorSetRuntimeGrid(AActor* Actor, FName GridName);
 
-	static TArray<TSharedPtr<FSlowTask>> SlowTasks;
+	static TArray<TSharedPtr<FProceduralTaskScope>> SlowTasks;
 };
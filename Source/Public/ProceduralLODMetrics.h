@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralLODMetrics.generated.h"
+
+USTRUCT(BlueprintType)
+struct PROCEDURALCONTENTPROCESSOR_API FProceduralProjectionSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 1, ClampMax = 170))
+	float FOV = 90.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 1))
+	FIntPoint Resolution = FIntPoint(1920, 1080);
+
+	float GetAspectRatio() const;
+
+	/** Same value as max(0.5 * Proj[0][0], 0.5 * Proj[1][1]) of an FPerspectiveMatrix built from these settings. */
+	float GetScreenMultiple() const;
+};
+
+namespace ProceduralLODMetrics
+{
+	constexpr float DefaultFOV = 90.0f;
+	constexpr float DefaultAspectRatio = 1920.0f / 1080.0f;
+	// tan(DefaultFOV / 2) == 1
+	constexpr float DefaultScreenMultiple = 0.5f * (DefaultAspectRatio > 1.0f ? DefaultAspectRatio : 1.0f);
+
+	constexpr float CalcLodDistance(float ScreenMultiple, float ObjectSphereRadius, float ScreenSize)
+	{
+		const float ScreenRadius = ScreenSize * 0.5f > UE_SMALL_NUMBER ? ScreenSize * 0.5f : UE_SMALL_NUMBER;
+		return ScreenMultiple * ObjectSphereRadius / ScreenRadius;
+	}
+
+	constexpr float CalcScreenSize(float ScreenMultiple, float ObjectSphereRadius, float Distance)
+	{
+		if (Distance <= 0.000001f) {
+			return 2.0f;
+		}
+		return 2.0f * ScreenMultiple * ObjectSphereRadius / (Distance > 1.0f ? Distance : 1.0f);
+	}
+
+	constexpr float CalcObjectSphereRadius(float ScreenMultiple, float ScreenSize, float Distance)
+	{
+		return ScreenSize * Distance / (2.0f * ScreenMultiple);
+	}
+
+	PROCEDURALCONTENTPROCESSOR_API void CalcLodDistances(float ScreenMultiple, TConstArrayView<float> ObjectSphereRadii, TConstArrayView<float> ScreenSizes, TArrayView<float> OutDistances);
+
+	PROCEDURALCONTENTPROCESSOR_API void CalcScreenSizes(float ScreenMultiple, TConstArrayView<float> ObjectSphereRadii, TConstArrayView<float> Distances, TArrayView<float> OutScreenSizes);
+
+	PROCEDURALCONTENTPROCESSOR_API void CalcObjectSphereRadii(float ScreenMultiple, TConstArrayView<float> ScreenSizes, TConstArrayView<float> Distances, TArrayView<float> OutRadii);
+}
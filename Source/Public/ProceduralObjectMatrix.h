@@ -63,6 +63,8 @@ struct FProceduralObjectMatrixPropertyField : public IProceduralPropertyMatrixFi
 
 struct FProceduralObjectMatrixRow {
 	TWeakObjectPtr<UObject> Owner;
+	/** Set for rows built from the asset registry, Owner stays empty until the asset is loaded. */
+	FSoftObjectPath AssetPath;
 	TArray<TSharedPtr<IProceduralPropertyMatrixField>> Fields;
 	TMap<FName, IProceduralPropertyMatrixField*> FieldMap;
 
@@ -77,6 +79,19 @@ struct FProceduralObjectMatrixRow {
 		}
 		return nullptr;
 	}
+
+	FString GetName() const {
+		if (Owner.IsValid())
+			return Owner->GetName();
+		// Actors in external packages are addressed by a sub path of the map, e.g. PersistentLevel.StaticMeshActor_1.
+		const FString& SubPath = AssetPath.GetSubPathString();
+		int32 Index;
+		if (SubPath.FindLastChar(TEXT('.'), Index))
+			return SubPath.RightChop(Index + 1);
+		if (!SubPath.IsEmpty())
+			return SubPath;
+		return AssetPath.GetAssetName();
+	}
 };
 
 
@@ -86,6 +101,8 @@ struct FProceduralObjectMatrix{
 public:
 	TMap<UObject*, TSharedPtr<FProceduralObjectMatrixRow>> ObjectInfoMap;
 
+	TMap<FSoftObjectPath, TSharedPtr<FProceduralObjectMatrixRow>> AssetInfoMap;
+
 	TArray<TSharedPtr<FProceduralObjectMatrixRow>> ObjectInfoList;
 
 	UPROPERTY()
@@ -99,4 +116,10 @@ public:
 	FName SortedColumnName;
 
 	EColumnSortMode::Type SortMode = EColumnSortMode::None;
+
+	/** Stable sort of ObjectInfoList by the text of InColumn, numerically when both values are numeric. */
+	void SortRows(FName InColumn, EColumnSortMode::Type InSortMode);
+
+	/** Rows whose name or any field text contains InKeyword. */
+	void SearchRows(const FString& InKeyword, TArray<TSharedPtr<FProceduralObjectMatrixRow>>& OutRows) const;
 };
\ No newline at end of file
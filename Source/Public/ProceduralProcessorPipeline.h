@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "AssetRegistry/AssetData.h"
+#include "ProceduralObjectMatrix.h"
+#include "ProceduralProcessorPipeline.generated.h"
+
+class UProceduralContentProcessor;
+
+UENUM(BlueprintType)
+enum class EProceduralPipelineDataType : uint8
+{
+	None,
+	Actors,
+	Assets,
+	Objects,
+	Matrix,
+};
+
+/** A value flowing along a pipeline edge, function parameters of type TArray<AActor*>, TArray<FAssetData>, TArray<UObject*> and FProceduralObjectMatrix map onto it. */
+USTRUCT(BlueprintType)
+struct PROCEDURALCONTENTPROCESSOR_API FProceduralPipelineData
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	EProceduralPipelineDataType Type = EProceduralPipelineDataType::None;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	TArray<TObjectPtr<AActor>> Actors;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	TArray<FAssetData> Assets;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	TArray<TObjectPtr<UObject>> Objects;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	FProceduralObjectMatrix Matrix;
+
+	static EProceduralPipelineDataType GetPropertyType(const FProperty* InProperty);
+
+	bool ReadFrom(const FProperty* InProperty, const void* InValue);
+
+	bool WriteTo(const FProperty* InProperty, void* OutValue) const;
+
+	int32 Num() const;
+};
+
+USTRUCT(BlueprintType)
+struct PROCEDURALCONTENTPROCESSOR_API FProceduralPipelineInput
+{
+	GENERATED_BODY()
+public:
+	/** Parameter of the node function, "AssetsToProcess" feeds UProceduralAssetProcessor::SetAssetsToProcess. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	FName Parameter;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	FName SourceNode;
+
+	/** Output or return parameter name of the source node function, "ReturnValue" for the return value. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	FName SourceOutput = TEXT("ReturnValue");
+};
+
+USTRUCT(BlueprintType)
+struct PROCEDURALCONTENTPROCESSOR_API FProceduralPipelineNode
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	FName Name;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	TSubclassOf<UProceduralContentProcessor> ProcessorClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	FName FunctionName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	TArray<FProceduralPipelineInput> Inputs;
+
+	/** Ordering-only edges, nodes referenced by Inputs are dependencies already. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	TArray<FName> Dependencies;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	bool bActivate = false;
+
+	/** Runs on a worker thread next to the other nodes of its level, only honoured for functions marked BlueprintThreadSafe. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	bool bAllowConcurrent = false;
+};
+
+USTRUCT(BlueprintType)
+struct PROCEDURALCONTENTPROCESSOR_API FProceduralPipelineNodeResult
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	TMap<FName, FProceduralPipelineData> Outputs;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	bool bSucceeded = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ProceduralContentProcessor")
+	float Seconds = 0.0f;
+};
+
+/** A directed acyclic graph of processor invocations, executed level by level in topological order. */
+UCLASS(BlueprintType)
+class PROCEDURALCONTENTPROCESSOR_API UProceduralProcessorPipeline : public UDataAsset
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralContentProcessor")
+	TArray<FProceduralPipelineNode> Nodes;
+
+	/** Groups node indices into levels whose nodes only depend on earlier levels. */
+	bool BuildLevels(TArray<TArray<int32>>& OutLevels, FString& OutError) const;
+
+	/**
+	 * Runs the graph in InWorld. Results of nodes that are neither FromNode, downstream of it nor missing from InOutCache
+	 * are reused, so an interrupted or tweaked run resumes without redoing the upstream work. NAME_None reruns every node.
+	 */
+	bool Execute(UWorld* InWorld, FName FromNode, TMap<FName, FProceduralPipelineNodeResult>& InOutCache) const;
+
+	TArray<FName> GetNodeNames() const;
+};
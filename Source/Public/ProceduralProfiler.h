@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(ProceduralContentProcessor_InstancesAdded);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ProceduralContentProcessor_ActorsSpawned);
+TRACE_DECLARE_INT_COUNTER_EXTERN(ProceduralContentProcessor_AssetsLoaded);
+
+/** A call tree of the last processor invocation, recorded on the game thread next to the Unreal Insights trace. */
+class PROCEDURALCONTENTPROCESSOR_API FProceduralProfiler
+{
+public:
+	struct FNode
+	{
+		FName Name;
+		int32 Calls = 0;
+		double InclusiveSeconds = 0.0;
+		double SelfSeconds = 0.0;
+		int64 ObjectsCreated = 0;
+		int64 MemoryDelta = 0;
+		TMap<FName, int64> Counters;
+		TArray<TSharedPtr<FNode>> Children;
+
+		TSharedPtr<FNode> FindOrAddChild(FName InName);
+	};
+
+	struct FScope
+	{
+		/** bInRoot starts a new run when nothing is recorded yet, library scopes only record inside a run. */
+		FScope(FName InName, bool bInRoot = false);
+		~FScope();
+	private:
+		bool bActive = false;
+	};
+
+	static FProceduralProfiler& Get();
+
+	void BeginScope(FName InName);
+	void EndScope();
+	void AddCounter(FName InCounter, int64 InDelta);
+
+	bool IsRecording() const { return !Stack.IsEmpty(); }
+
+	TSharedPtr<FNode> GetLastRun() const { return LastRun; }
+
+	DECLARE_MULTICAST_DELEGATE(FOnRunFinished);
+	FOnRunFinished OnRunFinished;
+private:
+	struct FFrame
+	{
+		TSharedPtr<FNode> Node;
+		double StartSeconds = 0.0;
+		double ChildSeconds = 0.0;
+		int64 StartObjects = 0;
+		uint64 StartMemory = 0;
+	};
+	TArray<FFrame> Stack;
+	TSharedPtr<FNode> LastRun;
+};
+
+#define PROCEDURAL_PROFILE_SCOPE(Name) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR(Name); \
+	FProceduralProfiler::FScope PREPROCESSOR_JOIN(ProceduralProfilerScope, __LINE__)(FName(Name))
+
+#define PROCEDURAL_PROFILE_COUNTER(Counter, Delta) \
+	TRACE_COUNTER_ADD(ProceduralContentProcessor_##Counter, Delta); \
+	FProceduralProfiler::Get().AddCounter(TEXT(#Counter), Delta)